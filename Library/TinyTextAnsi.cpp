@@ -0,0 +1,625 @@
+#include "TinyTextAnsi.h"
+
+#define ANSI_GROUND  0 // text and control characters
+#define ANSI_ESCAPE  1 // after ESC
+#define ANSI_CSI     2 // after ESC [, parameters until the final byte
+#define ANSI_SKIP    3 // the byte after ESC ( and the like, a character set
+#define ANSI_STRING  4 // OSC, DCS ... ignored until BEL or ESC
+
+#define ANSI_BEL 0x07
+#define ANSI_BS  0x08
+#define ANSI_HT  0x09
+#define ANSI_LF  0x0A
+#define ANSI_FF  0x0C
+#define ANSI_CR  0x0D
+#define ANSI_CAN 0x18
+#define ANSI_SUB 0x1A
+#define ANSI_ESC 0x1B
+#define ANSI_DEL 0x7F
+
+#define ANSI_MAX_PARAM 9999
+
+static const uint16_t ansiColors[16] =
+{
+    0x000, 0xA00, 0x0A0, 0xAA0, 0x00A, 0xA0A, 0x0AA, 0xAAA, // black, red, green, yellow, blue, magenta, cyan, white
+    0x555, 0xF55, 0x5F5, 0xFF5, 0x55F, 0xF5F, 0x5FF, 0xFFF  // bright
+};
+
+// 0, 95, 135, 175, 215 and 255, the levels of the 6 x 6 x 6 colour cube
+static const uint8_t ansiCube[6] = { 0x0, 0x6, 0x8, 0xA, 0xD, 0xF };
+
+TinyTextAnsi::TinyTextAnsi()
+{
+    _screen = NULL;
+    _state = ANSI_GROUND;
+    _defaultFore = 0xFFF;
+    _defaultBack = 0x000;
+}
+
+uint16_t TinyTextAnsi::Color(uint32_t rgb)
+{
+    uint8_t r = ((uint8_t)(rgb >> 16) * 15 + 127) / 255;
+    uint8_t g = ((uint8_t)(rgb >> 8) * 15 + 127) / 255;
+    uint8_t b = ((uint8_t)rgb * 15 + 127) / 255;
+    return (r << 8) | (g << 4) | b;
+}
+
+uint16_t TinyTextAnsi::PaletteColor(uint8_t index)
+{
+    if (index < 16)
+    {
+        return ansiColors[index];
+    }
+    if (index < 232)
+    {
+        index -= 16;
+        return (ansiCube[index / 36] << 8) | (ansiCube[(index / 6) % 6] << 4) | ansiCube[index % 6];
+    }
+    uint8_t grey = 8 + 10 * (index - 232); // 24 greys from 8 to 238
+    return Color(grey * 0x010101UL);
+}
+
+void TinyTextAnsi::Begin(TinyTextAnsiScreen* screen, uint16_t foreColor, uint16_t backColor)
+{
+    _screen = screen;
+    _defaultFore = foreColor;
+    _defaultBack = backColor;
+    defaults();
+}
+
+void TinyTextAnsi::defaults()
+{
+    _state = ANSI_GROUND;
+    _fore = _defaultFore;
+    _back = _defaultBack;
+    _foreIndex = -1;
+    _bold = false;
+    _reverse = false;
+    _colorsSet = false;
+    _origin = false;
+    _top = 0;
+    _bottom = _screen->Rows() - 1;
+    _screen->SetScrollRegion(_top, _bottom);
+    _screen->SetWrap(true);
+    _screen->SetCursor(0, 0);
+    saveCursor();
+}
+
+void TinyTextAnsi::Reset()
+{
+    if (_screen == NULL)
+    {
+        return;
+    }
+    defaults();
+    colors();
+    _screen->Erase(0, 0, _screen->Columns(), _screen->Rows());
+}
+
+uint16_t TinyTextAnsi::param(uint8_t i, uint16_t otherwise)
+{
+    // parameter i of a CSI sequence, otherwise when it is left out or 0
+    if ((i > _count) || (i >= TINYTEXT_ANSI_PARAMS) || (_params[i] == 0))
+    {
+        return otherwise;
+    }
+    return _params[i];
+}
+
+uint8_t TinyTextAnsi::col()
+{
+    // the cursor column, the last one while a wrap is pending
+    uint8_t col = _screen->CursorColumn();
+    return (col < _screen->Columns()) ? col : _screen->Columns() - 1;
+}
+
+void TinyTextAnsi::colors()
+{
+    // hands the SGR colours to the screen when they have changed, only before
+    // they are used
+    if (_colorsSet)
+    {
+        return;
+    }
+    uint16_t fore = (_bold && (_foreIndex >= 0)) ? ansiColors[_foreIndex + 8] : _fore;
+    uint16_t back = _back;
+    if (_reverse)
+    {
+        uint16_t swap = fore;
+        fore = back;
+        back = swap;
+    }
+    _screen->SetColors(fore, back);
+    _colorsSet = true;
+}
+
+void TinyTextAnsi::moveTo(int16_t col, int16_t row)
+{
+    int16_t cols = _screen->Columns();
+    int16_t rows = _screen->Rows();
+    col = (col < 0) ? 0 : ((col < cols) ? col : cols - 1);
+    row = (row < 0) ? 0 : ((row < rows) ? row : rows - 1);
+    _screen->SetCursor((uint8_t)col, (uint8_t)row);
+}
+
+void TinyTextAnsi::index()
+{
+    // LF: down a row, scrolling at the bottom of the scroll region
+    uint8_t row = _screen->CursorRow();
+    if (row == _bottom)
+    {
+        colors();
+        _screen->ScrollUp(true);
+    }
+    else if (row + 1 < _screen->Rows())
+    {
+        row++;
+    }
+    _screen->SetCursor(col(), row); // and no wrap pending
+}
+
+void TinyTextAnsi::reverseIndex()
+{
+    uint8_t row = _screen->CursorRow();
+    if (row == _top)
+    {
+        colors();
+        _screen->ScrollDown();
+    }
+    else if (row != 0)
+    {
+        row--;
+    }
+    _screen->SetCursor(col(), row);
+}
+
+void TinyTextAnsi::control(uint8_t b)
+{
+    uint8_t row = _screen->CursorRow();
+    switch (b)
+    {
+        case ANSI_BS:
+            if (col() != 0)
+            {
+                _screen->SetCursor(col() - 1, row);
+            }
+            break;
+        case ANSI_HT:
+            moveTo((col() / 8 + 1) * 8, row);
+            break;
+        case ANSI_LF:
+        case 0x0B: // VT
+        case ANSI_FF:
+            index();
+            break;
+        case ANSI_CR:
+            _screen->SetCursor(0, row);
+            break;
+        case ANSI_ESC:
+            _state = ANSI_ESCAPE;
+            break;
+        case ANSI_CAN:
+        case ANSI_SUB:
+            _state = ANSI_GROUND; // cancels a sequence
+            break;
+    }
+}
+
+void TinyTextAnsi::escape(uint8_t b)
+{
+    _state = ANSI_GROUND;
+    switch (b)
+    {
+        case '[':
+            _state = ANSI_CSI;
+            _params[0] = 0;
+            _count = 0;
+            _marker = 0;
+            break;
+        case ']': // OSC
+        case 'P': // DCS
+        case 'X': // SOS
+        case '^': // PM
+        case '_': // APC
+            _state = ANSI_STRING;
+            break;
+        case '7': saveCursor();    break;
+        case '8': restoreCursor(); break;
+        case 'D': index();         break;
+        case 'E':
+            _screen->SetCursor(0, _screen->CursorRow());
+            index();
+            break;
+        case 'M': reverseIndex();  break;
+        case 'c': Reset();         break;
+        default:
+            if ((b >= 0x20) && (b <= 0x2F))
+            {
+                _state = ANSI_SKIP; // ESC ( B and the like
+            }
+            break; // '\\' ends a string, anything else is ignored
+    }
+}
+
+void TinyTextAnsi::csi(uint8_t b)
+{
+    if ((b >= '0') && (b <= '9'))
+    {
+        if (_count < TINYTEXT_ANSI_PARAMS)
+        {
+            uint16_t value = _params[_count] * 10 + (b - '0');
+            _params[_count] = (value < ANSI_MAX_PARAM) ? value : ANSI_MAX_PARAM;
+        }
+        return;
+    }
+    if ((b == ';') || (b == ':'))
+    {
+        if (_count < TINYTEXT_ANSI_PARAMS)
+        {
+            _count++;
+        }
+        if (_count < TINYTEXT_ANSI_PARAMS)
+        {
+            _params[_count] = 0;
+        }
+        return;
+    }
+    if (b == ANSI_DEL)
+    {
+        return;
+    }
+    if ((b >= 0x20) && (b <= 0x3F))
+    {
+        _marker = b; // '?' and the like before the parameters, ' ' and the like after them
+        return;
+    }
+    _state = ANSI_GROUND;
+    if (_marker == '?')
+    {
+        // DEC private modes
+        if ((b == 'h') || (b == 'l'))
+        {
+            for (uint8_t i = 0; (i <= _count) && (i < TINYTEXT_ANSI_PARAMS); i++)
+            {
+                if (_params[i] == 6)
+                {
+                    _origin = (b == 'h');
+                    moveTo(0, _origin ? _top : 0);
+                }
+                else if (_params[i] == 7)
+                {
+                    _screen->SetWrap(b == 'h');
+                }
+            }
+        }
+        return;
+    }
+    if (_marker != 0)
+    {
+        return;
+    }
+
+    int16_t n = param(0, 1);
+    int16_t c = col();
+    int16_t row = _screen->CursorRow();
+    int16_t top = (row >= _top) ? _top : 0; // cursor up and down stop at the scroll region
+    int16_t bottom = (row <= _bottom) ? _bottom : _screen->Rows() - 1;
+    switch (b)
+    {
+        case 'A': moveTo(c, (row - n > top) ? row - n : top);          break; // CUU
+        case 'B':                                                             // CUD
+        case 'e': moveTo(c, (row + n < bottom) ? row + n : bottom);    break; // VPR
+        case 'C':                                                             // CUF
+        case 'a': moveTo(c + n, row);                                  break; // HPR
+        case 'D': moveTo(c - n, row);                                  break; // CUB
+        case 'E': moveTo(0, (row + n < bottom) ? row + n : bottom);    break; // CNL
+        case 'F': moveTo(0, (row - n > top) ? row - n : top);          break; // CPL
+        case 'G':                                                             // CHA
+        case '`': moveTo(n - 1, row);                                  break; // HPA
+        case 'H':                                                             // CUP
+        case 'f':                                                             // HVP
+            row = param(0, 1) - 1;
+            if (_origin)
+            {
+                row += _top;
+                row = (row < _bottom) ? row : _bottom;
+            }
+            moveTo(param(1, 1) - 1, row);
+            break;
+        case 'd':                                                             // VPA
+            row = n - 1;
+            if (_origin)
+            {
+                row += _top;
+                row = (row < _bottom) ? row : _bottom;
+            }
+            moveTo(c, row);
+            break;
+        case 'J': erase(param(0, 0), true);                            break; // ED
+        case 'K': erase(param(0, 0), false);                           break; // EL
+        case 'X':                                                             // ECH
+            colors();
+            _screen->Erase(c, row, (n < _screen->Columns() - c) ? n : _screen->Columns() - c, 1);
+            break;
+        case 'L': lines(n, true);                                      break; // IL
+        case 'M': lines(n, false);                                     break; // DL
+        case 'S':                                                             // SU
+        case 'T':                                                             // SD
+            if (_count == 0) // several parameters is a mouse tracking request
+            {
+                colors();
+                for (n = (n < _bottom - _top + 1) ? n : _bottom - _top + 1; n > 0; n--)
+                {
+                    if (b == 'S')
+                    {
+                        _screen->ScrollUp(true);
+                    }
+                    else
+                    {
+                        _screen->ScrollDown();
+                    }
+                }
+            }
+            break;
+        case 'm': sgr();                                               break;
+        case 'r':                                                             // DECSTBM
+            top = param(0, 1) - 1;
+            bottom = param(1, _screen->Rows()) - 1;
+            bottom = (bottom < _screen->Rows()) ? bottom : _screen->Rows() - 1;
+            if (top < bottom)
+            {
+                _top = top;
+                _bottom = bottom;
+                _screen->SetScrollRegion(_top, _bottom);
+                moveTo(0, _origin ? _top : 0);
+            }
+            break;
+        case 's': saveCursor();                                        break;
+        case 'u': restoreCursor();                                     break;
+    }
+}
+
+void TinyTextAnsi::sgr()
+{
+    uint8_t count = (_count < TINYTEXT_ANSI_PARAMS) ? _count + 1 : TINYTEXT_ANSI_PARAMS;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint16_t p = _params[i];
+        if (p == 0)
+        {
+            _fore = _defaultFore;
+            _back = _defaultBack;
+            _foreIndex = -1;
+            _bold = false;
+            _reverse = false;
+        }
+        else if ((p == 1) || (p == 22))
+        {
+            _bold = (p == 1);
+        }
+        else if ((p == 7) || (p == 27))
+        {
+            _reverse = (p == 7);
+        }
+        else if ((p >= 30) && (p <= 37))
+        {
+            _foreIndex = p - 30;
+            _fore = ansiColors[_foreIndex];
+        }
+        else if ((p >= 90) && (p <= 97))
+        {
+            _foreIndex = -1;
+            _fore = ansiColors[p - 90 + 8];
+        }
+        else if ((p >= 40) && (p <= 47))
+        {
+            _back = ansiColors[p - 40];
+        }
+        else if ((p >= 100) && (p <= 107))
+        {
+            _back = ansiColors[p - 100 + 8];
+        }
+        else if (p == 39)
+        {
+            _foreIndex = -1;
+            _fore = _defaultFore;
+        }
+        else if (p == 49)
+        {
+            _back = _defaultBack;
+        }
+        else if ((p == 38) || (p == 48))
+        {
+            // 38;5;n from the palette, 38;2;r;g;b
+            uint16_t color;
+            if ((i + 2 < count) && (_params[i + 1] == 5))
+            {
+                color = PaletteColor((uint8_t)_params[i + 2]);
+                i += 2;
+            }
+            else if ((i + 4 < count) && (_params[i + 1] == 2))
+            {
+                uint32_t r = (_params[i + 2] < 255) ? _params[i + 2] : 255;
+                uint32_t g = (_params[i + 3] < 255) ? _params[i + 3] : 255;
+                uint32_t b = (_params[i + 4] < 255) ? _params[i + 4] : 255;
+                color = Color((r << 16) | (g << 8) | b);
+                i += 4;
+            }
+            else
+            {
+                break; // can't tell where the next attribute starts
+            }
+            if (p == 38)
+            {
+                _foreIndex = -1;
+                _fore = color;
+            }
+            else
+            {
+                _back = color;
+            }
+        }
+    }
+    _colorsSet = false;
+}
+
+void TinyTextAnsi::erase(uint8_t mode, bool screen)
+{
+    // ED and EL: 0 from the cursor on, 1 up to the cursor, 2 all, each as few
+    // rectangles as there can be
+    uint8_t cols = _screen->Columns();
+    uint8_t rows = _screen->Rows();
+    uint8_t c = col();
+    uint8_t row = _screen->CursorRow();
+    colors();
+    if (mode == 0)
+    {
+        if (screen && (c == 0))
+        {
+            _screen->Erase(0, row, cols, rows - row);
+            return;
+        }
+        _screen->Erase(c, row, cols - c, 1);
+        if (screen && (row + 1 < rows))
+        {
+            _screen->Erase(0, row + 1, cols, rows - row - 1);
+        }
+    }
+    else if (mode == 1)
+    {
+        if (screen && (row != 0))
+        {
+            _screen->Erase(0, 0, cols, row);
+        }
+        _screen->Erase(0, row, c + 1, 1);
+    }
+    else if ((mode == 2) || (screen && (mode == 3)))
+    {
+        if (screen)
+        {
+            _screen->Erase(0, 0, cols, rows);
+        }
+        else
+        {
+            _screen->Erase(0, row, cols, 1);
+        }
+    }
+}
+
+void TinyTextAnsi::lines(uint16_t count, bool insert)
+{
+    // IL and DL: the rows from the cursor to the bottom of the scroll region scroll
+    uint8_t row = _screen->CursorRow();
+    if ((row < _top) || (row > _bottom))
+    {
+        return;
+    }
+    count = (count < _bottom - row + 1) ? count : _bottom - row + 1;
+    colors();
+    _screen->SetScrollRegion(row, _bottom);
+    while (count-- > 0)
+    {
+        if (insert)
+        {
+            _screen->ScrollDown();
+        }
+        else
+        {
+            _screen->ScrollUp(false); // deleted, not history
+        }
+    }
+    _screen->SetScrollRegion(_top, _bottom);
+    _screen->SetCursor(0, row);
+}
+
+void TinyTextAnsi::saveCursor()
+{
+    _savedCol = col();
+    _savedRow = _screen->CursorRow();
+    _savedFore = _fore;
+    _savedBack = _back;
+    _savedForeIndex = _foreIndex;
+    _savedBold = _bold;
+    _savedReverse = _reverse;
+    _savedOrigin = _origin;
+}
+
+void TinyTextAnsi::restoreCursor()
+{
+    _fore = _savedFore;
+    _back = _savedBack;
+    _foreIndex = _savedForeIndex;
+    _bold = _savedBold;
+    _reverse = _savedReverse;
+    _origin = _savedOrigin;
+    _colorsSet = false;
+    moveTo(_savedCol, _savedRow);
+}
+
+void TinyTextAnsi::Write(const uint8_t* data, size_t len)
+{
+    if (_screen == NULL)
+    {
+        return;
+    }
+    const uint8_t* end = data + len;
+    while (data < end)
+    {
+        if (_state == ANSI_GROUND)
+        {
+            // a run of printable characters goes to the screen in one go
+            const uint8_t* run = data;
+            while ((data < end) && (*data >= 0x20) && (*data != ANSI_DEL))
+            {
+                data++;
+            }
+            if (data > run)
+            {
+                colors();
+                _screen->Text((const char*)run, data - run);
+                continue;
+            }
+            control(*data++);
+            continue;
+        }
+
+        uint8_t b = *data++;
+        if ((b == ANSI_ESC) || (b == ANSI_CAN) || (b == ANSI_SUB))
+        {
+            control(b); // in the middle of a sequence too
+            continue;
+        }
+        switch (_state)
+        {
+            case ANSI_ESCAPE:
+                if (b < 0x20)
+                {
+                    control(b);
+                }
+                else
+                {
+                    escape(b);
+                }
+                break;
+            case ANSI_CSI:
+                if (b < 0x20)
+                {
+                    control(b);
+                }
+                else
+                {
+                    csi(b);
+                }
+                break;
+            case ANSI_SKIP:
+                _state = ANSI_GROUND;
+                break;
+            case ANSI_STRING:
+                if (b == ANSI_BEL)
+                {
+                    _state = ANSI_GROUND;
+                }
+                break;
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef TinyTextAnsi_h
+#define TinyTextAnsi_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+  A streaming parser for the part of VT100 / ANSI (xterm) escape sequences that
+  a program talking to a serial port actually uses: cursor movement, erasing
+  lines and the screen, inserting and deleting lines, scroll regions, autowrap
+  and SGR colours, mapped to RGB444 (the 16 colours, the 256 colour palette and
+  24 bit colours to the nearest). Anything else is parsed and ignored, so
+  unknown sequences don't end up on the screen.
+
+  The parser calls a TinyTextAnsiScreen, which keeps the cursor. Printable text
+  is handed over as runs, as long as the input allows, straight out of the
+  buffer given to Write so the screen can send each run as one transfer, and
+  erases are rectangles so they can be sent as fills. Bytes can be fed in any
+  amount, a sequence (or a UTF-8 character, see TinyTextWindow::Write) cut by the
+  end of one Write carries on in the next.
+
+  Erases and scrolls use the current background colour, as xterm does. Not
+  supported: inserting or deleting characters in a line, character sets, tab
+  stops other than every 8 columns, and replies to the host (e.g. cursor
+  position reports).
+
+  Does not depend on Arduino.h so it can be measured on a PC, see Tools/Terminal.
+*/
+
+#define TINYTEXT_ANSI_PARAMS 16 // numbers in a CSI sequence, more are ignored
+
+class TinyTextAnsiScreen
+{
+public:
+    virtual uint8_t Columns() = 0;
+    virtual uint8_t Rows() = 0;
+    // Columns() when the cursor is past the last column, waiting to wrap
+    virtual uint8_t CursorColumn() = 0;
+    virtual uint8_t CursorRow() = 0;
+    virtual void SetCursor(uint8_t col, uint8_t row) = 0;
+    virtual void SetColors(uint16_t foreColor, uint16_t backColor) = 0;
+    virtual void SetWrap(bool wrap) = 0;
+    virtual void SetScrollRegion(uint8_t top, uint8_t bottom) = 0;
+    // UTF-8 with no control characters, from the cursor on: wraps (when set) and
+    // scrolls at the bottom of the scroll region
+    virtual void Text(const char* str, size_t len) = 0;
+    // blanks w x h cells with the background colour, the cursor stays put
+    virtual void Erase(uint8_t col, uint8_t row, uint8_t w, uint8_t h) = 0;
+    // the scroll region by one row, a blank row coming in; history false when
+    // the row leaving the top is deleted (DL) rather than scrolled off, so it
+    // isn't kept in a scrollback
+    virtual void ScrollUp(bool history) = 0;
+    virtual void ScrollDown() = 0;
+};
+
+class TinyTextAnsi
+{
+private:
+    TinyTextAnsiScreen* _screen;
+    uint8_t  _state;
+    uint16_t _params[TINYTEXT_ANSI_PARAMS];
+    uint8_t  _count;       // parameters so far, the one being read is _params[_count]
+    char     _marker;      // private marker of a CSI sequence ('?', '>' ...), 0 for none
+    uint16_t _defaultFore;
+    uint16_t _defaultBack;
+    uint16_t _fore;        // as set by SGR, before bold and reverse
+    uint16_t _back;
+    int8_t   _foreIndex;   // 0 .. 7 when the foreground is one of the 8 colours, bold brightens it
+    bool     _bold;
+    bool     _reverse;
+    bool     _colorsSet;   // the screen has the colours
+    bool     _origin;      // DECOM, rows count from the top of the scroll region
+    uint8_t  _top;         // scroll region
+    uint8_t  _bottom;
+    uint8_t  _savedCol;    // DECSC
+    uint8_t  _savedRow;
+    uint16_t _savedFore;
+    uint16_t _savedBack;
+    int8_t   _savedForeIndex;
+    bool     _savedBold;
+    bool     _savedReverse;
+    bool     _savedOrigin;
+
+    void defaults();
+    uint16_t param(uint8_t i, uint16_t otherwise);
+    uint8_t col();
+    void colors();
+    void moveTo(int16_t col, int16_t row);
+    void index();
+    void reverseIndex();
+    void control(uint8_t b);
+    void escape(uint8_t b);
+    void csi(uint8_t b);
+    void sgr();
+    void erase(uint8_t mode, bool screen);
+    void lines(uint16_t count, bool insert);
+    void saveCursor();
+    void restoreCursor();
+
+public:
+    TinyTextAnsi();
+
+    // Starts on screen with the cursor at the top left, nothing is erased.
+    void Begin(TinyTextAnsiScreen* screen, uint16_t foreColor, uint16_t backColor);
+    // As ESC c: default colours, scroll region and modes, the screen erased.
+    void Reset();
+    void Write(const uint8_t* data, size_t len);
+    void Write(uint8_t b) { Write(&b, 1); }
+
+    // Nearest RGB444 to 0xRRGGBB, and to colour 0 .. 255 of the xterm palette.
+    static uint16_t Color(uint32_t rgb);
+    static uint16_t PaletteColor(uint8_t index);
+};
+
+#endif
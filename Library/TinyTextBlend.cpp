@@ -0,0 +1,84 @@
+#include "TinyTextBlend.h"
+
+static const uint8_t toneToShade[] = { 0, 37, 60, 81, 99, 116, 133, 148, 163, 177, 191, 204, 217, 230, 243, 255 };
+
+uint16_t TinyTextBlend(uint8_t tone, uint16_t foreColor, uint16_t backColor)
+{
+    // tone: 0..15
+    uint8_t shade = toneToShade[tone]; // not a linear conversion
+    uint8_t shade255 = 255 - shade;
+    // shade: 0..255
+
+    // red and blue share one word, 16 bits apart: each product fits in 12 bits
+    // so the two channels are blended by the same pair of multiplies
+    uint32_t rbForeground = ((foreColor >> 8) & 0x0F) | ((uint32_t)(foreColor & 0x0F) << 16);
+    uint32_t rbBackground = ((backColor >> 8) & 0x0F) | ((uint32_t)(backColor & 0x0F) << 16);
+    uint16_t gForeground = (foreColor >> 4) & 0x0F;
+    uint16_t gBackground = (backColor >> 4) & 0x0F;
+
+    uint32_t rbBlended = (((shade255 * rbForeground) + (shade * rbBackground)) >> 8) & 0x000F000F;
+    uint16_t gBlended = ((shade255 * gForeground) + (shade * gBackground)) >> 8;
+
+    // 4 to 5/6 bits, the low bit repeated into the new ones
+    rbBlended = (rbBlended << 1) | (rbBlended & 0x00010001);
+    gBlended = (gBlended << 2) | ((gBlended & 0x01) * 3);
+    uint16_t c565 = (uint16_t)((rbBlended << 11) | (gBlended << 5) | (rbBlended >> 16));
+    return c565;
+}
+
+TinyTextPalettes::TinyTextPalettes()
+{
+    _builds = 0;
+    Clear();
+}
+
+void TinyTextPalettes::Clear()
+{
+    for (uint8_t i = 0; i < TINYTEXT_PALETTE_CACHE; i++)
+    {
+        _order[i] = i;
+        _fore[i] = 0xFFFF; // not a valid RGB444 colour
+        _back[i] = 0xFFFF;
+    }
+}
+
+const uint16_t* TinyTextPalettes::Get(uint16_t foreColor, uint16_t backColor)
+{
+    // the 16 tones of a colour pair, blended once and then reused
+    uint8_t slot = _order[0];
+    if ((_fore[slot] == foreColor) && (_back[slot] == backColor))
+    {
+        return _palettes[slot];
+    }
+    uint8_t i = 1;
+    for (; i < TINYTEXT_PALETTE_CACHE; i++)
+    {
+        slot = _order[i];
+        if ((_fore[slot] == foreColor) && (_back[slot] == backColor))
+        {
+            break;
+        }
+    }
+    if (i == TINYTEXT_PALETTE_CACHE)
+    {
+        // miss: reuse the least recently used slot
+        i--;
+        slot = _order[i];
+        _fore[slot] = foreColor;
+        _back[slot] = backColor;
+        uint16_t* palette = _palettes[slot];
+        for (uint8_t tone = 0; tone < 16; tone++)
+        {
+            uint16_t pixel = TinyTextBlend(tone, foreColor, backColor);
+            palette[tone] = ((pixel >> 8) | ((pixel & 0xFF) << 8)); // swapped for write16(.., false)
+        }
+        _builds++;
+    }
+    // move to front
+    for (; i > 0; i--)
+    {
+        _order[i] = _order[i - 1];
+    }
+    _order[0] = slot;
+    return _palettes[slot];
+}
@@ -0,0 +1,45 @@
+#ifndef TinyTextBlend_h
+#define TinyTextBlend_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+  Anti-aliasing: every pixel of a glyph is one of 16 tones from the foreground
+  (0) to the background (15) colour. TinyTextBlend works out the RGB565 colour
+  of a tone for a pair of RGB444 colours. TinyTextPalettes keeps the 16 tones
+  of the most recently used pairs ready to send, so drawing a glyph is table
+  lookups and a pair is only blended when it comes back after being evicted.
+
+  Does not depend on Arduino.h so it can be checked and measured on a PC, see
+  Tools/Blend.
+*/
+
+// Number of (fore, back) colour pairs whose 16 blended tones are kept ready (4..16).
+#ifndef TINYTEXT_PALETTE_CACHE
+#define TINYTEXT_PALETTE_CACHE 8
+#endif
+
+// RGB565 (not byte swapped) of tone 0..15 between foreColor and backColor.
+uint16_t TinyTextBlend(uint8_t tone, uint16_t foreColor, uint16_t backColor);
+
+class TinyTextPalettes
+{
+private:
+    // most recently used colour pairs first
+    uint16_t _fore[TINYTEXT_PALETTE_CACHE];
+    uint16_t _back[TINYTEXT_PALETTE_CACHE];
+    uint16_t _palettes[TINYTEXT_PALETTE_CACHE][16];
+    uint8_t  _order[TINYTEXT_PALETTE_CACHE];
+    uint32_t _builds;
+
+public:
+    TinyTextPalettes();
+
+    void Clear();
+    // The 16 tones of the pair, byte swapped for write16(.., false).
+    const uint16_t* Get(uint16_t foreColor, uint16_t backColor);
+    uint32_t Builds() { return _builds; } // palettes blended so far
+};
+
+#endif
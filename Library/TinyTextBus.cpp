@@ -0,0 +1,291 @@
+#include "Arduino.h"
+#include "SPI.h"
+#include "TinyTextBus.h"
+
+TinyTextPinBus::TinyTextPinBus(int8_t cs, int8_t dc, SPIClass* spi) : TinyTextSPIBus(spi)
+{
+    _cs = cs;
+    _dc = dc;
+#ifdef TINYTEXT_FAST_PINS
+    _csSet = NULL;
+    _csClear = NULL;
+    _dcSet = NULL;
+    _dcClear = NULL;
+#endif
+}
+
+void TinyTextPinBus::Begin(uint32_t freq)
+{
+    pinMode(_cs, OUTPUT);
+    digitalWrite(_cs, HIGH); // Deselect
+    pinMode(_dc, OUTPUT);
+    digitalWrite(_dc, HIGH); // Data mode
+#ifdef TINYTEXT_FAST_PINS
+    initFastPin(_cs, _csSet, _csClear, _csMask);
+    initFastPin(_dc, _dcSet, _dcClear, _dcMask);
+#endif
+    begin(freq);
+}
+
+uint16_t TinyTextSPIBus::StartBytes(const uint8_t* data, uint16_t len)
+{
+#ifdef TINYTEXT_ASYNC_FIFO
+    if (len > TINYTEXT_ASYNC_FIFO)
+    {
+        len = TINYTEXT_ASYNC_FIFO;
+    }
+    // load the FIFO and let the hardware clock it out (see SPIClass::writeBytes_)
+    uint32_t bits = len * 8 - 1;
+    SPI1U1 = (SPI1U1 & ~((SPIMMOSI << SPILMOSI) | (SPIMMISO << SPILMISO))) | (bits << SPILMOSI) | (bits << SPILMISO);
+    volatile uint32_t* fifo = &SPI1W0;
+    for (uint16_t i = 0; i < len; i += 4)
+    {
+        uint32_t word;
+        memcpy(&word, data + i, 4);
+        *fifo++ = word;
+    }
+    SPI1CMD |= SPIBUSY;
+#else
+    WriteBytes(data, len); // no FIFO or DMA to hand it to: blocks until it has gone
+#endif
+    return len;
+}
+
+#ifdef TINYTEXT_FAST_PINS
+void TinyTextSPIBus::initFastPin(int8_t pin, TinyTextPort*& set, TinyTextPort*& clear, TinyTextPinMask& mask)
+{
+    // a pin without a known register keeps NULL and goes through digitalWrite
+    set = NULL;
+    clear = NULL;
+    mask = 0;
+    if (pin < 0)
+    {
+        return;
+    }
+#if defined(__AVR__)
+    set = portOutputRegister(digitalPinToPort(pin));
+    clear = set;
+    mask = digitalPinToBitMask(pin);
+#elif defined(ESP8266)
+    if (pin < 16) // GPIO16 sits in the RTC block
+    {
+        set = &GPOS;
+        clear = &GPOC;
+        mask = 1UL << pin;
+    }
+#elif defined(ESP32)
+    if (pin < 32)
+    {
+        set = (TinyTextPort*)GPIO_OUT_W1TS_REG;
+        clear = (TinyTextPort*)GPIO_OUT_W1TC_REG;
+        mask = 1UL << pin;
+    }
+#ifdef GPIO_OUT1_W1TS_REG
+    else
+    {
+        set = (TinyTextPort*)GPIO_OUT1_W1TS_REG;
+        clear = (TinyTextPort*)GPIO_OUT1_W1TC_REG;
+        mask = 1UL << (pin - 32);
+    }
+#endif
+#endif
+}
+#endif
+
+#if defined(ESP32)
+#include "driver/gpio.h"
+
+#define DMA_BUS_MAX_TRANSFER 4092 // bytes in one transaction, a DMA descriptor's worth
+
+TinyTextDMABus::TinyTextDMABus(spi_host_device_t host, int8_t mosi, int8_t miso, int8_t sck, int8_t cs, int8_t dc)
+{
+    _host = host;
+    _mosi = mosi;
+    _miso = miso;
+    _sck = sck;
+    _cs = cs;
+    _dc = dc;
+    _freq = 0;
+    _deviceFreq = 0;
+    _device = NULL;
+    _pending = false;
+}
+
+void TinyTextDMABus::Begin(uint32_t freq)
+{
+    pinMode(_cs, OUTPUT);
+    digitalWrite(_cs, HIGH); // Deselect
+    pinMode(_dc, OUTPUT);
+    digitalWrite(_dc, HIGH); // Data mode
+
+    spi_bus_config_t bus;
+    memset(&bus, 0, sizeof(bus));
+    bus.mosi_io_num = _mosi;
+    bus.miso_io_num = _miso;
+    bus.sclk_io_num = _sck;
+    bus.quadwp_io_num = -1;
+    bus.quadhd_io_num = -1;
+    bus.max_transfer_sz = DMA_BUS_MAX_TRANSFER;
+    spi_bus_initialize(_host, &bus, SPI_DMA_CH_AUTO);
+    _freq = freq;
+    addDevice();
+}
+
+void TinyTextDMABus::addDevice()
+{
+    // the clock is fixed when a device is added, a new one is added to change it
+    if (_device != NULL)
+    {
+        spi_bus_remove_device(_device);
+        _device = NULL;
+    }
+    spi_device_interface_config_t device;
+    memset(&device, 0, sizeof(device));
+    device.mode = 0;
+    device.clock_speed_hz = _freq;
+    device.spics_io_num = -1; // CS is held low for a whole transaction, by BeginTransaction
+    device.queue_size = 1;
+    if (spi_bus_add_device(_host, &device, &_device) != ESP_OK)
+    {
+        _device = NULL;
+    }
+    _deviceFreq = _freq;
+}
+
+void TinyTextDMABus::BeginTransaction()
+{
+    if (_freq != _deviceFreq)
+    {
+        addDevice();
+    }
+    if (_device != NULL)
+    {
+        spi_device_acquire_bus(_device, portMAX_DELAY);
+    }
+    gpio_set_level((gpio_num_t)_cs, 0);
+}
+
+void TinyTextDMABus::EndTransaction()
+{
+    gpio_set_level((gpio_num_t)_cs, 1);
+    if (_device != NULL)
+    {
+        spi_device_release_bus(_device);
+    }
+}
+
+void TinyTextDMABus::Command(uint8_t cmd)
+{
+    gpio_set_level((gpio_num_t)_dc, 0);
+    send(&cmd, 1);
+    gpio_set_level((gpio_num_t)_dc, 1);
+}
+
+void TinyTextDMABus::send(const uint8_t* data, uint32_t len)
+{
+    if (_device == NULL)
+    {
+        return;
+    }
+    while (Busy())
+    {
+        // a polling transaction can't start while a queued one is going
+    }
+    spi_transaction_t t;
+    while (len != 0)
+    {
+        uint32_t size = (len < DMA_BUS_MAX_TRANSFER) ? len : DMA_BUS_MAX_TRANSFER;
+        memset(&t, 0, sizeof(t));
+        t.length = size * 8;
+        if (size <= 4)
+        {
+            t.flags = SPI_TRANS_USE_TXDATA;
+            memcpy(t.tx_data, data, size);
+        }
+        else
+        {
+            t.tx_buffer = data;
+        }
+        spi_device_polling_transmit(_device, &t);
+        data += size;
+        len -= size;
+    }
+}
+
+void TinyTextDMABus::WritePattern(const uint8_t* data, uint8_t size, uint32_t repeat)
+{
+    // as many copies of the pattern as fit a buffer, sent as often as needed
+    uint8_t buffer[256];
+    uint32_t copies = sizeof(buffer) / size;
+    for (uint32_t i = 0; i < copies; i++)
+    {
+        memcpy(buffer + i * size, data, size);
+    }
+    while (repeat != 0)
+    {
+        uint32_t n = (repeat < copies) ? repeat : copies;
+        send(buffer, n * size);
+        repeat -= n;
+    }
+}
+
+uint8_t TinyTextDMABus::Read()
+{
+    if (_device == NULL)
+    {
+        return 0;
+    }
+    while (Busy())
+    {
+    }
+    spi_transaction_t t;
+    memset(&t, 0, sizeof(t));
+    t.flags = SPI_TRANS_USE_TXDATA | SPI_TRANS_USE_RXDATA;
+    t.length = 8;
+    t.rxlength = 8;
+    if (spi_device_polling_transmit(_device, &t) != ESP_OK)
+    {
+        return 0;
+    }
+    return t.rx_data[0];
+}
+
+uint16_t TinyTextDMABus::StartBytes(const uint8_t* data, uint16_t len)
+{
+    // the whole line, by DMA: Busy() is true until the driver has finished it
+    if ((_device == NULL) || _pending)
+    {
+        send(data, len);
+        return len;
+    }
+    if (len > DMA_BUS_MAX_TRANSFER)
+    {
+        len = DMA_BUS_MAX_TRANSFER;
+    }
+    memset(&_queued, 0, sizeof(_queued));
+    _queued.length = len * 8;
+    _queued.tx_buffer = data;
+    if (spi_device_queue_trans(_device, &_queued, portMAX_DELAY) != ESP_OK)
+    {
+        send(data, len);
+        return len;
+    }
+    _pending = true;
+    return len;
+}
+
+bool TinyTextDMABus::Busy()
+{
+    if (!_pending)
+    {
+        return false;
+    }
+    spi_transaction_t* done;
+    if (spi_device_get_trans_result(_device, &done, 0) != ESP_OK)
+    {
+        return true; // timed out: still going
+    }
+    _pending = false;
+    return false;
+}
+#endif
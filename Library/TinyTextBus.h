@@ -0,0 +1,354 @@
+#ifndef TinyTextBus_h
+#define TinyTextBus_h
+
+#include "Arduino.h"
+#include "SPI.h"
+
+/*
+  The SPI bus to the panel, as TinyTextTFTBus uses it. TinyTextTFT is
+  TinyTextTFTBus<TinyTextPinBus>: CS and DC on pins chosen at run time and an
+  SPIClass. TinyTextFixedPinBus has the pins as template arguments instead, and
+  on the ESP32 TinyTextDMABus sends the lines of FlushAsync by DMA.
+  Another bus (a recording one for tests, or a board with its own way of
+  driving the lines) is a class with the same members, given as the template
+  argument; see Tools/Bus for one.
+
+  A bus policy has:
+    Begin(freq)            CS and DC as outputs and high, the SPI started
+    SetFrequency(freq)     the clock from the next transaction
+    BeginTransaction()     and CS low
+    EndTransaction()       CS high, and the transaction ends
+    Command(cmd)           one byte with DC low
+    Write(b), Write16(w)   data, Write16 most significant byte first
+    WriteColor16(c)        a byte swapped colour, least significant byte first
+    WriteColor32(c)        two of them
+    WriteBytes(data, len)
+    WritePattern(data, size, repeat)  where TINYTEXT_SPI_PATTERN is defined
+    Read()                 a byte read back, 0 if it can't
+    StartBytes(data, len)  starts sending data and returns how much of it was
+                           taken; hardware that clocks bytes out on its own (the
+                           ESP8266's 64 byte FIFO, the ESP32's DMA) takes what
+                           fits and Busy() is true until it has gone, anything
+                           else sends it all. The data stays put until then.
+    Busy()
+  The reset pin, the canvas and the stats stay with TinyTextTFTBus.
+*/
+
+// CS and DC are toggled through the port registers on AVR, ESP8266 and ESP32.
+// Define TINYTEXT_NO_FAST_PINS to always use digitalWrite.
+#if !defined(TINYTEXT_NO_FAST_PINS) && (defined(__AVR__) || defined(ESP8266) || defined(ESP32))
+#define TINYTEXT_FAST_PINS
+#if defined(__AVR__)
+typedef volatile uint8_t TinyTextPort;
+typedef uint8_t TinyTextPinMask;
+#define TINYTEXT_PIN_SET(port, mask)   (*(port) |= (mask))
+#define TINYTEXT_PIN_CLEAR(port, mask) (*(port) &= ~(mask))
+#else
+typedef volatile uint32_t TinyTextPort;
+typedef uint32_t TinyTextPinMask;
+// ESP8266 and ESP32 have separate write-1-to-set and write-1-to-clear registers
+#define TINYTEXT_PIN_SET(port, mask)   (*(port) = (mask))
+#define TINYTEXT_PIN_CLEAR(port, mask) (*(port) = (mask))
+#endif
+#endif
+
+#if defined(ESP8266) || defined(ESP32)
+#define TINYTEXT_SPI_PATTERN // the core repeats a pattern of up to 64 bytes by itself
+#endif
+
+#if defined(ESP8266)
+#define TINYTEXT_ASYNC_FIFO 64 // bytes the SPI hardware clocks out on its own (SPI1W0..SPI1W15)
+#endif
+
+// The SPI side of the pin buses below: the SPIClass, its settings and the
+// ESP8266 FIFO.
+class TinyTextSPIBus
+{
+protected:
+    SPIClass*   _spi;
+    SPISettings _settings; ///< SPI transaction settings
+
+    TinyTextSPIBus(SPIClass* spi) { _spi = spi; }
+    void begin(uint32_t freq)
+    {
+        SetFrequency(freq);
+        _spi->begin();
+    }
+#ifdef TINYTEXT_FAST_PINS
+    static void initFastPin(int8_t pin, TinyTextPort*& set, TinyTextPort*& clear, TinyTextPinMask& mask);
+#endif
+
+public:
+    void SetFrequency(uint32_t freq) { _settings = SPISettings(freq, MSBFIRST, SPI_MODE0); }
+
+    void Write(uint8_t b) { _spi->write(b); }
+    void Write16(uint16_t w) { _spi->write16(w); }
+    void WriteColor16(uint16_t color) { _spi->write16(color, false); }
+    void WriteColor32(uint32_t color) { _spi->write32(color, false); }
+    void WriteBytes(const uint8_t* data, uint32_t len) { _spi->writeBytes((uint8_t*)data, len); }
+#ifdef TINYTEXT_SPI_PATTERN
+    void WritePattern(const uint8_t* data, uint8_t size, uint32_t repeat) { _spi->writePattern(data, size, repeat); }
+#endif
+    uint8_t Read() { return _spi->transfer((uint8_t)0); }
+
+    uint16_t StartBytes(const uint8_t* data, uint16_t len);
+    bool Busy()
+    {
+#ifdef TINYTEXT_ASYNC_FIFO
+        return (SPI1CMD & SPIBUSY) != 0;
+#else
+        return false;
+#endif
+    }
+};
+
+// CS and DC on pins chosen at run time.
+class TinyTextPinBus : public TinyTextSPIBus
+{
+private:
+    int8_t _cs;
+    int8_t _dc;
+#ifdef TINYTEXT_FAST_PINS
+    // registers that set and clear _cs and _dc, NULL to use digitalWrite
+    TinyTextPort*   _csSet;
+    TinyTextPort*   _csClear;
+    TinyTextPinMask _csMask;
+    TinyTextPort*   _dcSet;
+    TinyTextPort*   _dcClear;
+    TinyTextPinMask _dcMask;
+#endif
+
+    void csLow()
+    {
+#ifdef TINYTEXT_FAST_PINS
+        if (_csClear)
+        {
+            TINYTEXT_PIN_CLEAR(_csClear, _csMask);
+            return;
+        }
+#endif
+        digitalWrite(_cs, LOW);
+    }
+    void csHigh()
+    {
+#ifdef TINYTEXT_FAST_PINS
+        if (_csSet)
+        {
+            TINYTEXT_PIN_SET(_csSet, _csMask);
+            return;
+        }
+#endif
+        digitalWrite(_cs, HIGH);
+    }
+    void dcLow()
+    {
+#ifdef TINYTEXT_FAST_PINS
+        if (_dcClear)
+        {
+            TINYTEXT_PIN_CLEAR(_dcClear, _dcMask);
+            return;
+        }
+#endif
+        digitalWrite(_dc, LOW);
+    }
+    void dcHigh()
+    {
+#ifdef TINYTEXT_FAST_PINS
+        if (_dcSet)
+        {
+            TINYTEXT_PIN_SET(_dcSet, _dcMask);
+            return;
+        }
+#endif
+        digitalWrite(_dc, HIGH);
+    }
+
+public:
+    // Panels can share an SPI bus (each with its own CS) or use another SPIClass.
+    TinyTextPinBus(int8_t cs, int8_t dc, SPIClass* spi = &SPI);
+
+    void Begin(uint32_t freq);
+
+    void BeginTransaction()
+    {
+        _spi->beginTransaction(_settings);
+        csLow();
+    }
+    void EndTransaction()
+    {
+        csHigh();
+        _spi->endTransaction();
+    }
+
+    void Command(uint8_t cmd)
+    {
+        dcLow();
+        _spi->write(cmd);
+        dcHigh();
+    }
+};
+
+// CS and DC on pins fixed at compile time, e.g.
+//   TinyTextTFTBus<TinyTextFixedPinBus<10, 9> > tft(TinyTextFixedPinBus<10, 9>(), 8);
+// with TinyTextTFTImpl.h included by the sketch. On the ESP8266 (GPIO0..15) and
+// the ESP32 the register and mask of each pin are constants, so a toggle is a
+// single store. On AVR the port is looked up once by Begin, there is no pin
+// without one to check for at every toggle.
+template <uint8_t CS, uint8_t DC>
+class TinyTextFixedPinBus : public TinyTextSPIBus
+{
+private:
+#if defined(TINYTEXT_FAST_PINS) && defined(__AVR__)
+    TinyTextPort*   _csPort;
+    TinyTextPinMask _csMask;
+    TinyTextPort*   _dcPort;
+    TinyTextPinMask _dcMask;
+#endif
+
+    // pin is CS or DC, so the branches go at compile time
+    static void pinLow(uint8_t pin)
+    {
+#if defined(TINYTEXT_FAST_PINS) && defined(ESP8266)
+        if (pin < 16)
+        {
+            GPOC = 1UL << pin;
+            return;
+        }
+#elif defined(TINYTEXT_FAST_PINS) && defined(ESP32)
+        if (pin < 32)
+        {
+            *(TinyTextPort*)GPIO_OUT_W1TC_REG = 1UL << pin;
+            return;
+        }
+#ifdef GPIO_OUT1_W1TC_REG
+        *(TinyTextPort*)GPIO_OUT1_W1TC_REG = 1UL << (pin - 32);
+        return;
+#endif
+#endif
+        digitalWrite(pin, LOW);
+    }
+    static void pinHigh(uint8_t pin)
+    {
+#if defined(TINYTEXT_FAST_PINS) && defined(ESP8266)
+        if (pin < 16)
+        {
+            GPOS = 1UL << pin;
+            return;
+        }
+#elif defined(TINYTEXT_FAST_PINS) && defined(ESP32)
+        if (pin < 32)
+        {
+            *(TinyTextPort*)GPIO_OUT_W1TS_REG = 1UL << pin;
+            return;
+        }
+#ifdef GPIO_OUT1_W1TS_REG
+        *(TinyTextPort*)GPIO_OUT1_W1TS_REG = 1UL << (pin - 32);
+        return;
+#endif
+#endif
+        digitalWrite(pin, HIGH);
+    }
+
+#if defined(TINYTEXT_FAST_PINS) && defined(__AVR__)
+    void csLow()  { TINYTEXT_PIN_CLEAR(_csPort, _csMask); }
+    void csHigh() { TINYTEXT_PIN_SET(_csPort, _csMask); }
+    void dcLow()  { TINYTEXT_PIN_CLEAR(_dcPort, _dcMask); }
+    void dcHigh() { TINYTEXT_PIN_SET(_dcPort, _dcMask); }
+#else
+    void csLow()  { pinLow(CS); }
+    void csHigh() { pinHigh(CS); }
+    void dcLow()  { pinLow(DC); }
+    void dcHigh() { pinHigh(DC); }
+#endif
+
+public:
+    TinyTextFixedPinBus(SPIClass* spi = &SPI) : TinyTextSPIBus(spi) { }
+
+    void Begin(uint32_t freq)
+    {
+        pinMode(CS, OUTPUT);
+        digitalWrite(CS, HIGH); // Deselect
+        pinMode(DC, OUTPUT);
+        digitalWrite(DC, HIGH); // Data mode
+#if defined(TINYTEXT_FAST_PINS) && defined(__AVR__)
+        initFastPin(CS, _csPort, _csPort, _csMask);
+        initFastPin(DC, _dcPort, _dcPort, _dcMask);
+#endif
+        begin(freq);
+    }
+
+    void BeginTransaction()
+    {
+        _spi->beginTransaction(_settings);
+        csLow();
+    }
+    void EndTransaction()
+    {
+        csHigh();
+        _spi->endTransaction();
+    }
+
+    void Command(uint8_t cmd)
+    {
+        dcLow();
+        _spi->write(cmd);
+        dcHigh();
+    }
+};
+
+#if defined(ESP32)
+#include "driver/spi_master.h"
+
+// On the ESP32: the panel on an SPI host of its own, driven through the ESP-IDF
+// SPI master driver instead of an SPIClass, so that a line of FlushAsync goes out
+// by DMA (spi_device_queue_trans) while the next one is rendered and Poll returns
+// straight away. CS and DC are GPIOs set by the bus; everything other than
+// StartBytes is sent with polling transactions from the calling task, so use
+// EnablePipeline(lines, false) with it. No SPIClass may use the host, e.g.
+//   TinyTextTFTBus<TinyTextDMABus> tft(TinyTextDMABus(SPI3_HOST, 23, 19, 18, 5, 2), 4);
+// with TinyTextTFTImpl.h included by the sketch (SPI3_HOST is VSPI, SPI2_HOST HSPI).
+class TinyTextDMABus
+{
+private:
+    spi_host_device_t   _host;
+    int8_t              _mosi;
+    int8_t              _miso;
+    int8_t              _sck;
+    int8_t              _cs;
+    int8_t              _dc;
+    uint32_t            _freq;       // wanted
+    uint32_t            _deviceFreq; // the device was added with
+    spi_device_handle_t _device;
+    spi_transaction_t   _queued;     // the StartBytes transfer
+    bool                _pending;    // _queued hasn't been collected yet
+
+    void addDevice();
+    void send(const uint8_t* data, uint32_t len);
+
+public:
+    TinyTextDMABus(spi_host_device_t host, int8_t mosi, int8_t miso, int8_t sck, int8_t cs, int8_t dc);
+
+    void Begin(uint32_t freq);
+    void SetFrequency(uint32_t freq) { _freq = freq; }
+    void BeginTransaction();
+    void EndTransaction();
+    void Command(uint8_t cmd);
+
+    void Write(uint8_t b) { send(&b, 1); }
+    void Write16(uint16_t w)
+    {
+        uint8_t bytes[2] = { (uint8_t)(w >> 8), (uint8_t)w };
+        send(bytes, 2);
+    }
+    void WriteColor16(uint16_t color) { send((const uint8_t*)&color, 2); } // little endian
+    void WriteColor32(uint32_t color) { send((const uint8_t*)&color, 4); }
+    void WriteBytes(const uint8_t* data, uint32_t len) { send(data, len); }
+    void WritePattern(const uint8_t* data, uint8_t size, uint32_t repeat);
+    uint8_t Read();
+
+    uint16_t StartBytes(const uint8_t* data, uint16_t len);
+    bool Busy();
+};
+#endif
+
+#endif
@@ -0,0 +1,316 @@
+#include "Arduino.h"
+#include "TinyTextCanvas.h"
+
+#define ILI9341_CASET 0x2A    ///< Column Address Set
+#define ILI9341_PASET 0x2B    ///< Page Address Set
+#define ILI9341_RAMWR 0x2C    ///< Memory Write
+#define ILI9341_VSCRDEF 0x33  ///< Vertical Scrolling Definition
+#define ILI9341_MADCTL 0x36   ///< Memory Access Control
+#define ILI9341_VSCRSADD 0x37 ///< Vertical Scrolling Start Address
+#define ILI9341_RAMWRC 0x3C   ///< Memory Write Continue
+
+#define MADCTL_MY 0x80  ///< Bottom to top
+#define MADCTL_MX 0x40  ///< Right to left
+#define MADCTL_MV 0x20  ///< Reverse Mode
+
+TinyTextCanvas::TinyTextCanvas()
+{
+    _frame = NULL;
+}
+
+TinyTextCanvas::~TinyTextCanvas()
+{
+    End();
+}
+
+bool TinyTextCanvas::Begin()
+{
+    if (_frame == NULL)
+    {
+        _frame = (uint16_t*)malloc((uint32_t)TINYTEXT_CANVAS_WIDTH * TINYTEXT_CANVAS_HEIGHT * sizeof(uint16_t));
+        if (_frame == NULL)
+        {
+            return false;
+        }
+    }
+    memset(_frame, 0, (uint32_t)TINYTEXT_CANVAS_WIDTH * TINYTEXT_CANVAS_HEIGHT * sizeof(uint16_t));
+
+    // power on defaults
+    _command = 0;
+    _argCount = 0;
+    _columnStart = 0;
+    _columnEnd = TINYTEXT_CANVAS_WIDTH - 1;
+    _pageStart = 0;
+    _pageEnd = TINYTEXT_CANVAS_HEIGHT - 1;
+    _column = 0;
+    _page = 0;
+    _pixelHigh = 0;
+    _pixelHalf = false;
+    _lineLeft = 0;
+    _madctl = 0;
+    _scrollTop = 0;
+    _scrollHeight = TINYTEXT_CANVAS_HEIGHT;
+    _scrollStart = 0;
+    return true;
+}
+
+void TinyTextCanvas::End()
+{
+    free(_frame);
+    _frame = NULL;
+}
+
+int32_t TinyTextCanvas::frameOffset(uint16_t x, uint16_t y)
+{
+    // MADCTL coordinates to frame memory, -1 if outside
+    if (_madctl & MADCTL_MV)
+    {
+        uint16_t swap = x;
+        x = y;
+        y = swap;
+    }
+    if ((x >= TINYTEXT_CANVAS_WIDTH) || (y >= TINYTEXT_CANVAS_HEIGHT))
+    {
+        return -1;
+    }
+    if (_madctl & MADCTL_MX)
+    {
+        x = TINYTEXT_CANVAS_WIDTH - 1 - x;
+    }
+    if (_madctl & MADCTL_MY)
+    {
+        y = TINYTEXT_CANVAS_HEIGHT - 1 - y;
+    }
+    return (int32_t)y * TINYTEXT_CANVAS_WIDTH + x;
+}
+
+void TinyTextCanvas::Command(uint8_t cmd)
+{
+    _command = cmd;
+    _argCount = 0;
+    _pixelHalf = false;
+    _lineLeft = 0; // the window or the address mapping may change
+    if (cmd == ILI9341_RAMWR)
+    {
+        _column = _columnStart;
+        _page = _pageStart;
+    }
+}
+
+void TinyTextCanvas::Data(uint8_t b)
+{
+    if ((_command == ILI9341_RAMWR) || (_command == ILI9341_RAMWRC))
+    {
+        // RGB565, high byte first
+        if (!_pixelHalf)
+        {
+            _pixelHigh = b;
+            _pixelHalf = true;
+            return;
+        }
+        _pixelHalf = false;
+        memoryWrite(((uint16_t)_pixelHigh << 8) | b);
+        return;
+    }
+    if (_argCount < sizeof(_args))
+    {
+        _args[_argCount++] = b;
+        commandArgs();
+    }
+}
+
+void TinyTextCanvas::Data(const uint8_t* data, uint32_t len)
+{
+    if (((_command != ILI9341_RAMWR) && (_command != ILI9341_RAMWRC)) || (_frame == NULL))
+    {
+        while (len--)
+        {
+            Data(*data++);
+        }
+        return;
+    }
+    if (_pixelHalf && (len != 0))
+    {
+        Data(*data++); // the second byte of a pixel started by the last call
+        len--;
+    }
+    // a line of the window at a time, straight into the frame
+    while (len >= 2)
+    {
+        if ((_lineLeft == 0) && !lineStart())
+        {
+            memoryWrite(((uint16_t)data[0] << 8) | data[1]);
+            data += 2;
+            len -= 2;
+            continue;
+        }
+        uint16_t pixels = (_lineLeft < len / 2) ? _lineLeft : len / 2;
+        uint16_t* pixel = _line;
+        int16_t step = _lineStep;
+        for (uint16_t i = 0; i < pixels; i++)
+        {
+            *pixel = ((uint16_t)data[0] << 8) | data[1];
+            pixel += step;
+            data += 2;
+        }
+        len -= 2 * (uint32_t)pixels;
+        _line = pixel;
+        _column += pixels;
+        _lineLeft -= pixels;
+        if (_lineLeft == 0)
+        {
+            lineEnd();
+        }
+    }
+    if (len != 0)
+    {
+        Data(*data); // the first byte of a pixel the next call finishes
+    }
+}
+
+void TinyTextCanvas::commandArgs()
+{
+    // acts on a command once all of its arguments are in
+    uint16_t first = ((uint16_t)_args[0] << 8) | _args[1];
+    uint16_t second = ((uint16_t)_args[2] << 8) | _args[3];
+    switch (_command)
+    {
+    case ILI9341_CASET:
+        if (_argCount == 4)
+        {
+            _columnStart = first;
+            _columnEnd = second;
+        }
+        break;
+    case ILI9341_PASET:
+        if (_argCount == 4)
+        {
+            _pageStart = first;
+            _pageEnd = second;
+        }
+        break;
+    case ILI9341_MADCTL:
+        _madctl = _args[0];
+        break;
+    case ILI9341_VSCRDEF:
+        if (_argCount == 6)
+        {
+            _scrollTop = first;
+            _scrollHeight = second;
+        }
+        break;
+    case ILI9341_VSCRSADD:
+        if (_argCount == 2)
+        {
+            _scrollStart = first;
+        }
+        break;
+    }
+}
+
+bool TinyTextCanvas::lineStart()
+{
+    // works out where the rest of the window's current line goes, false if any
+    // of it is off the frame (or the window is back to front)
+    if (_column > _columnEnd)
+    {
+        return false;
+    }
+    int32_t first = frameOffset(_column, _page);
+    int32_t last = frameOffset(_columnEnd, _page);
+    if ((first < 0) || (last < 0))
+    {
+        return false;
+    }
+    // along a line of frame memory, or down a column of it with MADCTL_MV
+    _lineLeft = _columnEnd - _column + 1;
+    _lineStep = (_lineLeft > 1) ? (last - first) / (_lineLeft - 1) : 1;
+    _line = _frame + first;
+    return true;
+}
+
+void TinyTextCanvas::lineEnd()
+{
+    _column = _columnStart;
+    if (++_page > _pageEnd)
+    {
+        _page = _pageStart;
+    }
+}
+
+void TinyTextCanvas::memoryWrite(uint16_t color)
+{
+    if (_frame == NULL)
+    {
+        return;
+    }
+    if ((_lineLeft != 0) || lineStart())
+    {
+        *_line = color;
+        _line += _lineStep;
+        _column++;
+        if (--_lineLeft == 0)
+        {
+            lineEnd();
+        }
+        return;
+    }
+    int32_t offset = frameOffset(_column, _page);
+    if (offset >= 0)
+    {
+        _frame[offset] = color;
+    }
+    if (++_column > _columnEnd)
+    {
+        lineEnd();
+    }
+}
+
+uint16_t TinyTextCanvas::GetMemoryPixel(uint16_t x, uint16_t y)
+{
+    int32_t offset = frameOffset(x, y);
+    if ((_frame == NULL) || (offset < 0))
+    {
+        return 0;
+    }
+    return _frame[offset];
+}
+
+uint16_t TinyTextCanvas::GetPixel(uint16_t x, uint16_t y)
+{
+    int32_t offset = frameOffset(x, y);
+    if ((_frame == NULL) || (offset < 0))
+    {
+        return 0;
+    }
+    // the panel shows line 'line' of the scroll area from frame memory line
+    // _scrollStart onwards, the fixed areas above and below stay put
+    uint16_t line = offset / TINYTEXT_CANVAS_WIDTH;
+    uint16_t column = offset % TINYTEXT_CANVAS_WIDTH;
+    if ((line >= _scrollTop) && (line - _scrollTop < _scrollHeight) && (_scrollStart >= _scrollTop))
+    {
+        line = _scrollTop + ((line - _scrollTop) + (_scrollStart - _scrollTop)) % _scrollHeight;
+    }
+    return _frame[(uint32_t)line * TINYTEXT_CANVAS_WIDTH + column];
+}
+
+void TinyTextCanvas::WritePPM(Print& out)
+{
+    out.print("P6\n");
+    out.print(Width());
+    out.print(" ");
+    out.print(Height());
+    out.print("\n255\n");
+    for (uint16_t y = 0; y < Height(); y++)
+    {
+        for (uint16_t x = 0; x < Width(); x++)
+        {
+            uint16_t color = GetPixel(x, y);
+            uint8_t r = (color >> 11) & 0x1F;
+            uint8_t g = (color >> 5) & 0x3F;
+            uint8_t b = color & 0x1F;
+            uint8_t rgb[3] = { (uint8_t)((r << 3) | (r >> 2)), (uint8_t)((g << 2) | (g >> 4)), (uint8_t)((b << 3) | (b >> 2)) };
+            out.write(rgb, 3);
+        }
+    }
+}
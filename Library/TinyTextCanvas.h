@@ -0,0 +1,81 @@
+#ifndef TinyTextCanvas_h
+#define TinyTextCanvas_h
+
+#include "Arduino.h"
+
+/*
+  An ILI9341 in RAM: takes the same commands and pixel data TinyTextTFT would
+  send to the panel (CASET, PASET, RAMWR, MADCTL, VSCRDEF and VSCRSADD, the
+  rest is ignored) and keeps the 240x320 RGB565 frame memory (150K).
+
+  Attach it with TinyTextTFT::SetCanvas() to render without a panel, e.g. to
+  compare screens against reference images on a PC, or to put a frame
+  together off-screen and send it with TinyTextTFT::PushCanvas().
+*/
+
+#define TINYTEXT_CANVAS_WIDTH  240 // frame memory columns
+#define TINYTEXT_CANVAS_HEIGHT 320 // frame memory lines
+
+class TinyTextCanvas
+{
+private:
+    uint16_t* _frame; // RGB565, TINYTEXT_CANVAS_HEIGHT lines of TINYTEXT_CANVAS_WIDTH
+
+    uint8_t  _command;
+    uint8_t  _args[6];
+    uint8_t  _argCount;
+
+    // address window and write position, in MADCTL coordinates
+    uint16_t _columnStart;
+    uint16_t _columnEnd;
+    uint16_t _pageStart;
+    uint16_t _pageEnd;
+    uint16_t _column;
+    uint16_t _page;
+    uint8_t  _pixelHigh;
+    bool     _pixelHalf;
+    // the rest of the window's current line, where it is all in the frame
+    uint16_t* _line;
+    int16_t  _lineStep;  // frame pixels from one column to the next
+    uint16_t _lineLeft;  // 0: not worked out yet
+
+    uint8_t  _madctl;
+    uint16_t _scrollTop;    // VSCRDEF top fixed area
+    uint16_t _scrollHeight; // VSCRDEF scroll area
+    uint16_t _scrollStart;  // VSCRSADD
+
+    int32_t frameOffset(uint16_t x, uint16_t y);
+    void commandArgs();
+    bool lineStart();
+    void lineEnd();
+    void memoryWrite(uint16_t color);
+
+public:
+    TinyTextCanvas();
+    ~TinyTextCanvas();
+
+    // Allocates the frame memory (cleared to black), false if there isn't enough RAM.
+    bool Begin();
+    void End();
+
+    // The byte stream as the panel sees it: Command() for a byte sent with DC low,
+    // Data() for the rest.
+    void Command(uint8_t cmd);
+    void Data(uint8_t b);
+    void Data(const uint8_t* data, uint32_t len);
+
+    // The picture on the panel, after the vertical scroll, the right way up for
+    // the last MADCTL received (see TinyTextTFT::SetRotation).
+    uint16_t Width()  { return (_madctl & 0x20) ? TINYTEXT_CANVAS_HEIGHT : TINYTEXT_CANVAS_WIDTH; }
+    uint16_t Height() { return (_madctl & 0x20) ? TINYTEXT_CANVAS_WIDTH : TINYTEXT_CANVAS_HEIGHT; }
+    uint16_t GetPixel(uint16_t x, uint16_t y);
+
+    // Frame memory at (x, y) of the current address mapping, as RAMWR put it there.
+    uint16_t GetMemoryPixel(uint16_t x, uint16_t y);
+    uint16_t ScrollStart() { return _scrollStart; }
+
+    // Writes the picture as a binary PPM (P6) image.
+    void WritePPM(Print& out);
+};
+
+#endif
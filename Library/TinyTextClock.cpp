@@ -0,0 +1,115 @@
+#include "TinyTextClock.h"
+
+#define CLOCK_CASET 0x2A // Column Address Set
+#define CLOCK_PASET 0x2B // Page Address Set
+#define CLOCK_RAMWR 0x2C // Memory Write
+#define CLOCK_RAMRD 0x2E // Memory Read
+
+static uint32_t clockRandom(uint32_t& state)
+{
+    // xorshift32, state must not be 0
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static uint16_t clockPixel(uint32_t& state, uint8_t i, uint16_t previous)
+{
+    // odd pixels are the complement of the one before, so every bit toggles
+    return (i & 1) ? (uint16_t)~previous : (uint16_t)clockRandom(state);
+}
+
+static bool clockProbe(TinyTextClockBus& bus, uint32_t writeFreq, uint32_t readFreq, uint32_t seed)
+{
+    uint8_t data[1 + 3 * TINYTEXT_CLOCK_PIXELS];
+    uint32_t state = seed | 1;
+    uint16_t pixel = 0;
+
+    // a line of pixels at the top left, RGB565 high byte first
+    bus.SetFrequency(writeFreq);
+    static const uint8_t columns[4] = { 0, 0, 0, TINYTEXT_CLOCK_PIXELS - 1 };
+    static const uint8_t pages[4] = { 0, 0, 0, 0 };
+    bus.Write(CLOCK_CASET, columns, sizeof(columns));
+    bus.Write(CLOCK_PASET, pages, sizeof(pages));
+    for (uint8_t i = 0; i < TINYTEXT_CLOCK_PIXELS; i++)
+    {
+        pixel = clockPixel(state, i, pixel);
+        data[2 * i] = pixel >> 8;
+        data[2 * i + 1] = pixel;
+    }
+    bus.Write(CLOCK_RAMWR, data, 2 * TINYTEXT_CLOCK_PIXELS);
+
+    // RAMRD starts at the same window: a dummy byte, then 3 bytes a pixel with
+    // each of R, G and B in the top 6 bits
+    bus.SetFrequency(readFreq);
+    bus.Read(CLOCK_RAMRD, data, sizeof(data));
+    state = seed | 1;
+    pixel = 0;
+    const uint8_t* rgb = data + 1;
+    for (uint8_t i = 0; i < TINYTEXT_CLOCK_PIXELS; i++)
+    {
+        pixel = clockPixel(state, i, pixel);
+        if (((rgb[0] >> 3) != (pixel >> 11)) || ((rgb[1] >> 2) != ((pixel >> 5) & 0x3F)) || ((rgb[2] >> 3) != (pixel & 0x1F)))
+        {
+            return false;
+        }
+        rgb += 3;
+    }
+    return true;
+}
+
+bool TinyTextProbeClock(TinyTextClockBus& bus, uint32_t freq, uint32_t readFreq, uint32_t seed)
+{
+    return clockProbe(bus, freq, (freq < readFreq) ? freq : readFreq, seed);
+}
+
+uint32_t TinyTextTuneClock(TinyTextClockBus& bus, uint32_t minFreq, uint32_t maxFreq, uint32_t readFreq, uint8_t marginPercent)
+{
+    uint32_t seed = 0x9E3779B9;
+    uint32_t good = 0;
+    uint32_t freq = minFreq;
+
+    // the read path first, pixels written at minFreq and read at readFreq: if they
+    // don't come back there, a failure further up can't be told from a bad read, so
+    // give up rather than take it out on the write clock
+    for (uint8_t i = 0; i < TINYTEXT_CLOCK_TRIES; i++)
+    {
+        seed += 0x9E3779B9;
+        if (!clockProbe(bus, minFreq, readFreq, seed))
+        {
+            return 0;
+        }
+    }
+    while (freq <= maxFreq)
+    {
+        bool pass = true;
+        for (uint8_t i = 0; (i < TINYTEXT_CLOCK_TRIES) && pass; i++)
+        {
+            seed += 0x9E3779B9; // new pixels every try
+            pass = TinyTextProbeClock(bus, freq, readFreq, seed);
+        }
+        if (!pass)
+        {
+            break;
+        }
+        good = freq;
+        if (freq == maxFreq)
+        {
+            break;
+        }
+        freq += freq / 4;
+        freq = (freq < maxFreq) ? freq : maxFreq;
+    }
+    if (good == 0)
+    {
+        return 0;
+    }
+    if (good > minFreq)
+    {
+        good -= (uint32_t)((uint64_t)good * marginPercent / 100);
+        good = (good > minFreq) ? good : minFreq;
+    }
+    bus.SetFrequency(good);
+    return good;
+}
@@ -0,0 +1,50 @@
+#ifndef TinyTextClock_h
+#define TinyTextClock_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+  Finds the fastest SPI clock a panel takes reliably: at each step of rising
+  frequencies a line of test pixels is written to the frame memory and read back
+  with RAMRD, and the search stops at the first step where they don't match. The
+  result is the last good step less a safety margin.
+
+  The pixels are different at every try (so what an earlier, good, try left in
+  the frame memory can't pass for a later one) and every pixel is followed by its
+  complement so each bit of the bus toggles. The ILI9341 can't be read as fast as
+  it can be written (a read cycle is at least 150ns, 6.6MHz), reads are done at no
+  more than readFreq: a write that went wrong at a high clock still shows up when
+  it is read back more slowly. The reads are checked once before the search, at
+  readFreq with the pixels written at minFreq, so a panel that can't be read that
+  fast isn't mistaken for one that can't be written any faster.
+
+  The bus is an interface so the search can be run on a PC against a mock panel,
+  see Tools/Clock. Does not depend on Arduino.h.
+*/
+
+#define TINYTEXT_CLOCK_PIXELS 32 // test pixels per try, a line at the top left
+#define TINYTEXT_CLOCK_TRIES  3  // at each frequency
+
+class TinyTextClockBus
+{
+public:
+    virtual void SetFrequency(uint32_t freq) = 0;
+    // one transaction each: the command (DC low) then len bytes of data written or
+    // read (DC high)
+    virtual void Write(uint8_t command, const uint8_t* data, uint16_t len) = 0;
+    virtual void Read(uint8_t command, uint8_t* data, uint16_t len) = 0;
+};
+
+// Tries minFreq, then 25% more at each step up to maxFreq. Returns the frequency
+// to use, marginPercent below the fastest that passed (but not below minFreq), or
+// 0 if the reads at readFreq or minFreq already failed (e.g. MISO isn't connected),
+// with the bus left where the last try put it. Otherwise the bus is left at the
+// frequency returned.
+uint32_t TinyTextTuneClock(TinyTextClockBus& bus, uint32_t minFreq, uint32_t maxFreq, uint32_t readFreq, uint8_t marginPercent);
+
+// One try: writes the test pixels for seed at freq and reads them back at
+// (at most) readFreq, true if they came back unchanged.
+bool TinyTextProbeClock(TinyTextClockBus& bus, uint32_t freq, uint32_t readFreq, uint32_t seed);
+
+#endif
@@ -0,0 +1,177 @@
+#include "Arduino.h"
+#include "TinyTextField.h"
+
+#define FIELD_DIGITS 16 // longest number: a sign, 10 digits and a decimal point
+#define FIELD_CELL_BYTES 100 // 5 x 10 pixels of 16 bits
+
+static uint8_t formatDigits(char* end, uint32_t value, uint8_t base, uint8_t minDigits)
+{
+    // writes value backwards from end (exclusive), returns the number of characters
+    char* p = end;
+    do
+    {
+        uint8_t digit = value % base;
+        *--p = (digit < 10) ? '0' + digit : 'A' + digit - 10;
+        value /= base;
+    }
+    while ((value != 0) || (end - p < minDigits));
+    return end - p;
+}
+
+TinyTextField::TinyTextField()
+{
+    _tft = NULL;
+    _width = 0;
+    _valid = false;
+}
+
+TinyTextField::TinyTextField(TinyTextDisplay* tft, uint8_t col, uint8_t row, uint8_t width,
+                             TinyTextAlign align, uint16_t foreColor, uint16_t backColor)
+{
+    Attach(tft, col, row, width, align, foreColor, backColor);
+}
+
+void TinyTextField::Attach(TinyTextDisplay* tft, uint8_t col, uint8_t row, uint8_t width,
+                           TinyTextAlign align, uint16_t foreColor, uint16_t backColor)
+{
+    _tft = tft;
+    _col = col;
+    _row = row;
+    _width = (width < TINYTEXT_FIELD_WIDTH) ? width : TINYTEXT_FIELD_WIDTH;
+    _align = align;
+    _foreColor = foreColor;
+    _backColor = backColor;
+    _valid = false;
+}
+
+void TinyTextField::SetColors(uint16_t foreColor, uint16_t backColor)
+{
+    if ((foreColor != _foreColor) || (backColor != _backColor))
+    {
+        _foreColor = foreColor;
+        _backColor = backColor;
+        _valid = false; // every cell changes
+    }
+}
+
+void TinyTextField::show(const char* text, uint8_t len)
+{
+    if (_tft == NULL)
+    {
+        return;
+    }
+
+    // the new contents of the field
+    char cells[TINYTEXT_FIELD_WIDTH];
+    if (len > _width)
+    {
+        memset(cells, '#', _width); // doesn't fit
+    }
+    else
+    {
+        uint8_t pad = _width - len;
+        uint8_t left = (_align == TINYTEXT_ALIGN_LEFT) ? 0 : ((_align == TINYTEXT_ALIGN_RIGHT) ? pad : pad / 2);
+        memset(cells, ' ', _width);
+        memcpy(cells + left, text, len);
+    }
+
+    // send each run of changed cells, taking in an unchanged gap between two of
+    // them when sending it again costs less than the window of another run
+    uint8_t i = 0;
+    while (i < _width)
+    {
+        if (_valid && (cells[i] == _shown[i]))
+        {
+            i++;
+            continue;
+        }
+        uint8_t start = i;
+        uint8_t end = i; // past the last changed cell of the run
+        while (i < _width)
+        {
+            if (!_valid || (cells[i] != _shown[i]))
+            {
+                end = ++i;
+                continue;
+            }
+            uint8_t gap = i;
+            while ((gap < _width) && (cells[gap] == _shown[gap]))
+            {
+                gap++;
+            }
+            if ((gap == _width) || ((uint16_t)(gap - i) * FIELD_CELL_BYTES >= TINYTEXT_FIELD_RUN_COST))
+            {
+                break;
+            }
+            i = gap;
+        }
+        _tft->DrawString(_col + start, _row, cells + start, end - start, _foreColor, _backColor);
+        i = end;
+    }
+    memcpy(_shown, cells, _width);
+    _valid = true;
+}
+
+void TinyTextField::SetText(const char* str)
+{
+    size_t len = strlen(str);
+    show(str, (len < 0xFF) ? len : 0xFF);
+}
+
+void TinyTextField::SetInt(int32_t value)
+{
+    SetFixed(value, 0);
+}
+
+void TinyTextField::SetFixed(int32_t value, uint8_t decimals)
+{
+    char text[FIELD_DIGITS];
+    char* end = text + sizeof(text);
+    decimals = (decimals < 9) ? decimals : 9;
+    uint32_t magnitude = (value < 0) ? -(uint32_t)value : value;
+    uint32_t scale = 1;
+    for (uint8_t i = 0; i < decimals; i++)
+    {
+        scale *= 10;
+    }
+    uint8_t len = 0;
+    if (decimals != 0)
+    {
+        len = formatDigits(end, magnitude % scale, 10, decimals);
+        text[sizeof(text) - ++len] = '.';
+    }
+    len += formatDigits(end - len, magnitude / scale, 10, 1);
+    if (value < 0)
+    {
+        text[sizeof(text) - ++len] = '-';
+    }
+    show(end - len, len);
+}
+
+void TinyTextField::SetHex(uint32_t value, uint8_t digits)
+{
+    char text[8];
+    char* end = text + sizeof(text);
+    uint8_t len = formatDigits(end, value, 16, (digits < sizeof(text)) ? digits : sizeof(text));
+    show(end - len, len);
+}
+
+void TinyTextField::SetTime(uint32_t seconds)
+{
+    char text[FIELD_DIGITS];
+    char* end = text + sizeof(text);
+    uint8_t len = formatDigits(end, seconds % 60, 10, 2);
+    text[sizeof(text) - ++len] = ':';
+    uint32_t minutes = seconds / 60;
+    if (minutes < 60)
+    {
+        len += formatDigits(end - len, minutes, 10, 1);
+    }
+    else
+    {
+        len += formatDigits(end - len, minutes % 60, 10, 2);
+        text[sizeof(text) - ++len] = ':';
+        len += formatDigits(end - len, minutes / 60, 10, 1);
+    }
+    show(end - len, len);
+}
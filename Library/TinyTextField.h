@@ -0,0 +1,74 @@
+#ifndef TinyTextField_h
+#define TinyTextField_h
+
+#include "TinyTextTFT.h"
+
+/*
+  A fixed width field of ASCII text, usually a number, that is redrawn in place.
+
+  Set.. formats the value into the field's width (no String, no heap) and sends
+  only the cells whose character changed, adjacent ones as a single run: a
+  counter going from 1234 to 1235 sends one cell instead of four. Two runs with
+  unchanged cells between them are sent as one when resending the gap (100
+  bytes a cell) costs less than starting another run, TINYTEXT_FIELD_RUN_COST.
+  A value too wide for the field shows as '#'s.
+
+  Fields are plain objects, declare as many as needed (e.g. an array attached in
+  setup()). Each keeps what it last drew, so if something else draws over it,
+  call Invalidate() and the next Set.. sends every cell again.
+*/
+
+#define TINYTEXT_FIELD_WIDTH 12 // most cells in a field
+
+// What starting another run costs, in bytes of bus time: its window (CASET and
+// RAMWR, the row is already set) and the transaction around it. An unchanged
+// cell costs 100, so gaps are taken in once this is raised above that, for a
+// board where transactions are slow to start: 200 takes in gaps of one cell,
+// 300 of two.
+#ifndef TINYTEXT_FIELD_RUN_COST
+#define TINYTEXT_FIELD_RUN_COST 16
+#endif
+
+enum TinyTextAlign
+{
+    TINYTEXT_ALIGN_LEFT,
+    TINYTEXT_ALIGN_RIGHT,
+    TINYTEXT_ALIGN_CENTER
+};
+
+class TinyTextField
+{
+private:
+    TinyTextDisplay* _tft;
+    uint8_t  _col;
+    uint8_t  _row;
+    uint8_t  _width;
+    uint8_t  _align;
+    uint16_t _foreColor;
+    uint16_t _backColor;
+    char     _shown[TINYTEXT_FIELD_WIDTH]; // what is on the panel
+    bool     _valid;                       // false until the first draw
+
+    void show(const char* text, uint8_t len);
+
+public:
+    TinyTextField();
+    TinyTextField(TinyTextDisplay* tft, uint8_t col, uint8_t row, uint8_t width,
+                  TinyTextAlign align = TINYTEXT_ALIGN_RIGHT, uint16_t foreColor = RGB444_WHITE, uint16_t backColor = RGB444_BLACK);
+    void Attach(TinyTextDisplay* tft, uint8_t col, uint8_t row, uint8_t width,
+                TinyTextAlign align = TINYTEXT_ALIGN_RIGHT, uint16_t foreColor = RGB444_WHITE, uint16_t backColor = RGB444_BLACK);
+
+    void SetColors(uint16_t foreColor, uint16_t backColor);
+    void Invalidate() { _valid = false; }
+
+    void SetText(const char* str);
+    void SetInt(int32_t value);
+    // value / 10^decimals, e.g. SetFixed(-205, 1) shows -20.5
+    void SetFixed(int32_t value, uint8_t decimals);
+    // upper case, zero padded to at least digits
+    void SetHex(uint32_t value, uint8_t digits = 0);
+    // seconds as h:mm:ss, or m:ss under an hour
+    void SetTime(uint32_t seconds);
+};
+
+#endif
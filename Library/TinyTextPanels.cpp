@@ -0,0 +1,74 @@
+#include "Arduino.h"
+#include "TinyTextPanels.h"
+
+TinyTextPanels::TinyTextPanels()
+{
+    _count = 0;
+    _current = 0;
+}
+
+bool TinyTextPanels::Add(TinyTextDisplay* panel)
+{
+    if (_count >= TINYTEXT_MAX_PANELS)
+    {
+        return false;
+    }
+    WaitComplete();
+    _panels[_count] = panel;
+    _count++;
+    _current = _count;
+    return true;
+}
+
+void TinyTextPanels::Flush()
+{
+    WaitComplete();
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (_panels[i]->IsDirty())
+        {
+            _panels[i]->Flush(); // one transaction for all of this panel's runs
+        }
+    }
+}
+
+bool TinyTextPanels::startNext(uint8_t first)
+{
+    // starts the async flush of the next panel with changes
+    for (_current = first; _current < _count; _current++)
+    {
+        if (_panels[_current]->IsDirty() && _panels[_current]->FlushAsync())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TinyTextPanels::FlushAsync()
+{
+    WaitComplete();
+    startNext(0);
+}
+
+bool TinyTextPanels::Poll()
+{
+    if (_current >= _count)
+    {
+        return false;
+    }
+    if (_panels[_current]->Poll())
+    {
+        return true;
+    }
+    // this panel is done, only now can the next one use the bus
+    return startNext(_current + 1);
+}
+
+void TinyTextPanels::WaitComplete()
+{
+    while (Poll())
+    {
+        yield();
+    }
+}
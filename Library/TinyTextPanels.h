@@ -0,0 +1,47 @@
+#ifndef TinyTextPanels_h
+#define TinyTextPanels_h
+
+#include "TinyTextTFT.h"
+
+/*
+  Several TinyTextTFT panels driven from one MCU, on one shared SPI bus
+  (a CS pin each) or spread over more than one SPIClass.
+
+  Each panel keeps its changes in its shadow grid (see TinyTextTFT::EnableGrid)
+  and the flushes are done a panel at a time, so one CS assertion and one
+  beginTransaction cover all of a panel's pending cells and panels sharing
+  a bus never interleave.
+*/
+
+#ifndef TINYTEXT_MAX_PANELS
+#define TINYTEXT_MAX_PANELS 4
+#endif
+
+class TinyTextPanels
+{
+private:
+    TinyTextDisplay* _panels[TINYTEXT_MAX_PANELS];
+    uint8_t _count;
+    uint8_t _current; // panel with a FlushAsync going, _count for none
+
+    bool startNext(uint8_t first);
+
+public:
+    TinyTextPanels();
+
+    bool Add(TinyTextDisplay* panel);
+    uint8_t Count() { return _count; }
+    TinyTextDisplay* Panel(uint8_t index) { return (index < _count) ? _panels[index] : NULL; }
+
+    // Flush every panel that has changes
+    void Flush();
+
+    // Non-blocking version: the panels are flushed one after the other with
+    // TinyTextTFT::FlushAsync, call Poll() from loop() until it returns false.
+    void FlushAsync();
+    bool Poll();
+    bool IsBusy() { return _current < _count; }
+    void WaitComplete();
+};
+
+#endif
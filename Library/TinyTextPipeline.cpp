@@ -0,0 +1,283 @@
+#include "TinyTextPipeline.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(ARDUINO)
+#include "Arduino.h"
+#else
+#include <chrono>
+#endif
+
+#if defined(TINYTEXT_PIPELINE_STD_THREAD)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct TinyTextPipelineThread
+{
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable work;
+};
+#elif defined(TINYTEXT_PIPELINE_THREADS)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define PIPELINE_TASK_STACK 4096
+#endif
+
+static_assert((TINYTEXT_PIPELINE_LINES & (TINYTEXT_PIPELINE_LINES - 1)) == 0, "TINYTEXT_PIPELINE_LINES must be a power of 2");
+static_assert(TINYTEXT_PIPELINE_LINES <= 128, "TINYTEXT_PIPELINE_LINES must fit the 8 bit counts");
+
+static uint32_t pipelineMicros()
+{
+#if defined(ARDUINO)
+    return micros();
+#else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static void pipelinePause()
+{
+    // the producer waiting on the consumer
+#if defined(TINYTEXT_PIPELINE_STD_THREAD)
+    std::this_thread::yield();
+#endif
+    // a FreeRTOS consumer runs on the other core, spinning costs it nothing
+}
+
+TinyTextPipeline::TinyTextPipeline()
+{
+    _memory = NULL;
+    _count = 0;
+    _head = 0;
+    _tail = 0;
+    _threaded = false;
+    _stop = false;
+    _running = false;
+    _worker = NULL;
+    _send = NULL;
+    _context = NULL;
+    ResetStats();
+}
+
+TinyTextPipeline::~TinyTextPipeline()
+{
+    End();
+}
+
+bool TinyTextPipeline::Begin(uint8_t lines, uint16_t lineBytes, bool threaded, TinyTextLineSender send, void* context)
+{
+    End();
+    lines = (lines < 2) ? 2 : ((lines > TINYTEXT_PIPELINE_LINES) ? TINYTEXT_PIPELINE_LINES : lines);
+    while ((lines & (lines - 1)) != 0)
+    {
+        lines &= lines - 1; // a power of 2, so the 8 bit counts wrap onto the same line
+    }
+    _memory = (uint8_t*)malloc((uint32_t)lines * lineBytes);
+    if (_memory == NULL)
+    {
+        return false;
+    }
+    for (uint8_t i = 0; i < lines; i++)
+    {
+        _lines[i].data = _memory + (uint32_t)i * lineBytes;
+    }
+    _send = send;
+    _context = context;
+    _head = 0;
+    _tail = 0;
+    _stop = false;
+    _threaded = false;
+    ResetStats();
+    _count = lines;
+
+#if defined(TINYTEXT_PIPELINE_THREADS)
+    if (threaded)
+    {
+        _running = true;
+#if defined(TINYTEXT_PIPELINE_STD_THREAD)
+        TinyTextPipelineThread* worker = new TinyTextPipelineThread();
+        _worker = worker;
+        worker->thread = std::thread(consumerTask, this);
+#else
+        // same priority as the caller, on the other core
+        TaskHandle_t task;
+        if (xTaskCreatePinnedToCore(consumerTask, "TinyText", PIPELINE_TASK_STACK, this, uxTaskPriorityGet(NULL),
+                                    &task, xPortGetCoreID() ^ 1) != pdPASS)
+        {
+            _running = false;
+            free(_memory);
+            _memory = NULL;
+            _count = 0;
+            return false;
+        }
+        _worker = task;
+#endif
+        _threaded = true;
+    }
+#else
+    (void)threaded; // no consumer task on this board, the producer sends
+#endif
+    return true;
+}
+
+void TinyTextPipeline::End()
+{
+    if (_count == 0)
+    {
+        return;
+    }
+    Drain();
+    if (_threaded)
+    {
+        __atomic_store_n(&_stop, true, __ATOMIC_RELEASE);
+        wake();
+#if defined(TINYTEXT_PIPELINE_STD_THREAD)
+        TinyTextPipelineThread* worker = (TinyTextPipelineThread*)_worker;
+        worker->thread.join();
+        delete worker;
+#else
+        while (__atomic_load_n(&_running, __ATOMIC_ACQUIRE))
+        {
+        }
+#endif
+        _worker = NULL;
+        _threaded = false;
+    }
+    free(_memory);
+    _memory = NULL;
+    _count = 0;
+}
+
+void TinyTextPipeline::ResetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+bool TinyTextPipeline::full()
+{
+    return (uint8_t)(_tail - __atomic_load_n(&_head, __ATOMIC_ACQUIRE)) >= _count;
+}
+
+bool TinyTextPipeline::empty()
+{
+    return __atomic_load_n(&_head, __ATOMIC_ACQUIRE) == __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+}
+
+void TinyTextPipeline::sendLine()
+{
+    // consumer: the oldest line
+    TinyTextLine& line = _lines[_head % _count];
+    uint32_t start = pipelineMicros();
+    _send(_context, line);
+    _stats.sendMicros += pipelineMicros() - start;
+    _stats.lines++;
+    _stats.bytes += line.size;
+    __atomic_store_n(&_head, (uint8_t)(_head + 1), __ATOMIC_RELEASE);
+}
+
+void TinyTextPipeline::wake()
+{
+#if defined(TINYTEXT_PIPELINE_STD_THREAD)
+    TinyTextPipelineThread* worker = (TinyTextPipelineThread*)_worker;
+    {
+        // taken so the consumer can't miss the wake between checking and waiting
+        std::lock_guard<std::mutex> lock(worker->mutex);
+    }
+    worker->work.notify_one();
+#elif defined(TINYTEXT_PIPELINE_THREADS)
+    xTaskNotifyGive((TaskHandle_t)_worker);
+#endif
+}
+
+void TinyTextPipeline::consume()
+{
+    // the consumer task: sends lines as they are published, sleeps in between
+    for (;;)
+    {
+#if defined(TINYTEXT_PIPELINE_STD_THREAD)
+        TinyTextPipelineThread* worker = (TinyTextPipelineThread*)_worker;
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            worker->work.wait(lock, [this] { return !empty() || __atomic_load_n(&_stop, __ATOMIC_ACQUIRE); });
+        }
+#elif defined(TINYTEXT_PIPELINE_THREADS)
+        while (empty() && !__atomic_load_n(&_stop, __ATOMIC_ACQUIRE))
+        {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+#endif
+        if (empty())
+        {
+            break; // stopping, and everything has gone
+        }
+        while (!empty())
+        {
+            sendLine();
+        }
+    }
+}
+
+void TinyTextPipeline::consumerTask(void* pipeline)
+{
+    ((TinyTextPipeline*)pipeline)->consume();
+#if defined(TINYTEXT_PIPELINE_THREADS) && !defined(TINYTEXT_PIPELINE_STD_THREAD)
+    __atomic_store_n(&((TinyTextPipeline*)pipeline)->_running, false, __ATOMIC_RELEASE);
+    vTaskDelete(NULL);
+#endif
+}
+
+TinyTextLine* TinyTextPipeline::Acquire()
+{
+    if (full())
+    {
+        uint32_t start = pipelineMicros();
+        if (_threaded)
+        {
+            while (full())
+            {
+                pipelinePause();
+            }
+        }
+        else
+        {
+            sendLine(); // make room
+        }
+        _stats.stallMicros += pipelineMicros() - start;
+    }
+    _renderStart = pipelineMicros();
+    return &_lines[_tail % _count];
+}
+
+void TinyTextPipeline::Publish()
+{
+    _stats.renderMicros += pipelineMicros() - _renderStart;
+    __atomic_store_n(&_tail, (uint8_t)(_tail + 1), __ATOMIC_RELEASE);
+    if (_threaded)
+    {
+        wake();
+    }
+}
+
+void TinyTextPipeline::Drain()
+{
+    if (empty())
+    {
+        return; // nothing was waiting (or the pipeline isn't running)
+    }
+    uint32_t start = pipelineMicros();
+    while (!empty())
+    {
+        if (_threaded)
+        {
+            pipelinePause();
+        }
+        else
+        {
+            sendLine();
+        }
+    }
+    _stats.stallMicros += pipelineMicros() - start;
+}
@@ -0,0 +1,100 @@
+#ifndef TinyTextPipeline_h
+#define TinyTextPipeline_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+  A bounded ring of scanline buffers between two stages: the producer renders
+  lines of pixels ready to send (Acquire, fill in, Publish) and the consumer
+  hands them to a send callback in the same order.
+
+  Threaded, the consumer is a task of its own that sleeps until a line is
+  published: a FreeRTOS task on the other core of a dual-core ESP32, or a
+  std::thread where TINYTEXT_PIPELINE_STD_THREAD is defined (to run it on a PC).
+  The producer only waits when every line in the ring is still to be sent.
+  Otherwise, or when asked not to be threaded, the producer sends the oldest line
+  itself whenever it needs a free one, so the order and bytes are the same.
+
+  Does not depend on Arduino.h so it can be built on a PC; Tools/Pipeline
+  measures it inside TinyTextTFT on the mock bus of Tools/Bench.
+*/
+
+#ifndef TINYTEXT_PIPELINE_LINES
+#define TINYTEXT_PIPELINE_LINES 8 // most lines in the ring, a power of 2
+#endif
+
+#if defined(ESP32)
+#include "sdkconfig.h" // CONFIG_FREERTOS_UNICORE
+#endif
+#if (defined(ESP32) && !defined(CONFIG_FREERTOS_UNICORE)) || defined(TINYTEXT_PIPELINE_STD_THREAD)
+#define TINYTEXT_PIPELINE_THREADS
+#endif
+
+struct TinyTextLine
+{
+    uint16_t x;      // window of the run the line belongs to
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+    bool     window; // first line of a run: set the window before sending it
+    uint16_t size;   // bytes in data
+    uint8_t* data;
+};
+
+struct TinyTextPipelineStats
+{
+    uint32_t lines;        // sent
+    uint32_t bytes;
+    uint32_t renderMicros; // producer, from Acquire returning to Publish
+    uint32_t stallMicros;  // producer, waiting for a free line or for Drain
+    uint32_t sendMicros;   // consumer, in the send callback
+};
+
+typedef void (*TinyTextLineSender)(void* context, const TinyTextLine& line);
+
+class TinyTextPipeline
+{
+private:
+    TinyTextLine _lines[TINYTEXT_PIPELINE_LINES];
+    uint8_t* _memory;
+    uint8_t  _count;     // lines in the ring, 0 when not begun
+    uint8_t  _head;      // next line to send, moved by the consumer
+    uint8_t  _tail;      // next line to fill, moved by the producer
+    bool     _threaded;
+    bool     _stop;      // asks the consumer task to end
+    bool     _running;   // the consumer task hasn't ended
+    void*    _worker;    // the consumer task or thread
+    TinyTextLineSender _send;
+    void*    _context;
+    uint32_t _renderStart;
+    TinyTextPipelineStats _stats;
+
+    bool full();
+    bool empty();
+    void sendLine();
+    void wake();
+    void consume();
+    static void consumerTask(void* pipeline);
+
+public:
+    TinyTextPipeline();
+    ~TinyTextPipeline();
+
+    // lines (2, 4 .. TINYTEXT_PIPELINE_LINES, rounded down to a power of 2) of lineBytes
+    // each, false if there isn't the RAM (or a task can't be started).
+    bool Begin(uint8_t lines, uint16_t lineBytes, bool threaded, TinyTextLineSender send, void* context);
+    void End();
+    bool Active()   { return _count != 0; }
+    bool Threaded() { return _threaded; }
+
+    // Producer
+    TinyTextLine* Acquire();
+    void Publish();
+    void Drain(); // returns once every published line has been sent
+
+    const TinyTextPipelineStats& GetStats() { return _stats; } // Drain first for exact figures
+    void ResetStats();
+};
+
+#endif
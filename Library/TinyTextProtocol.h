@@ -0,0 +1,50 @@
+#ifndef TinyTextProtocol_h
+#define TinyTextProtocol_h
+
+#include <stdint.h>
+
+/*
+  The byte stream TinyTextRemote decodes, shared with the host side encoder so
+  it must not depend on Arduino.h.
+
+  Every command is an opcode byte and a fixed number of argument bytes, except
+  TEXT which carries its length in the opcode. The remote keeps a cursor and a
+  pair of colours: TEXT, REPEAT and SKIP draw (or step over) cells at the cursor
+  and move it right, FILL and SCROLL use the back colour.
+
+    NOP     0x00                              ignored, see below
+    CURSOR  0x01 col row                      move the cursor
+    COLORS  0x02 fore:back                    two RGB444 colours in 3 bytes, fore first
+    REPEAT  0x03 count code(2)                count cells of one code point (big endian)
+    FILL    0x04 col row w h                  blank a block of cells
+    SCROLL  0x05 rows                         scroll the screen up, new rows are blank
+    FLUSH   0x06                              end of an update: send what has changed
+    TEXT    0x80 | (bytes - 1), 1..64 bytes   UTF-8, one cell per character
+    SKIP    0xC0 | (cells - 1)                move the cursor right 1..64 cells
+
+  The longest command is 65 bytes, so a sender that may have been cut off in the
+  middle of one (a host that just connected) sends TINYTEXT_REMOTE_SYNC NOPs first.
+
+  The remote sends one byte back, RESYNC, when it has lost track of its screen
+  (a SCROLL it can't do): the host should send the whole screen again.
+*/
+
+#define TINYTEXT_REMOTE_NOP    0x00
+#define TINYTEXT_REMOTE_CURSOR 0x01
+#define TINYTEXT_REMOTE_COLORS 0x02
+#define TINYTEXT_REMOTE_REPEAT 0x03
+#define TINYTEXT_REMOTE_FILL   0x04
+#define TINYTEXT_REMOTE_SCROLL 0x05
+#define TINYTEXT_REMOTE_FLUSH  0x06
+#define TINYTEXT_REMOTE_TEXT   0x80
+#define TINYTEXT_REMOTE_SKIP   0xC0
+
+#define TINYTEXT_REMOTE_RESYNC 0x15 // remote to host
+
+#define TINYTEXT_REMOTE_MAX_TEXT 64 // bytes in one TEXT, cells in one SKIP
+#define TINYTEXT_REMOTE_SYNC     65 // NOPs that end any partly sent command
+
+// argument bytes after each opcode below TINYTEXT_REMOTE_TEXT
+#define TINYTEXT_REMOTE_ARGS { 0, 2, 3, 3, 4, 1, 0 }
+
+#endif
@@ -0,0 +1,305 @@
+#include "Arduino.h"
+#include "TinyTextQueue.h"
+
+static_assert((TINYTEXT_QUEUE_SIZE & (TINYTEXT_QUEUE_SIZE - 1)) == 0, "TINYTEXT_QUEUE_SIZE must be a power of 2");
+static_assert(TINYTEXT_QUEUE_SIZE <= 128, "TINYTEXT_QUEUE_SIZE must fit the 8 bit indexes");
+
+#define QUEUE_MASK (TINYTEXT_QUEUE_SIZE - 1)
+#define DAMAGE_EMPTY 0x000000FFUL // col1 255 > col2 0
+
+enum
+{
+    QUEUE_PUT,
+    QUEUE_PRINT,
+    QUEUE_FILL,
+    QUEUE_WRITE
+};
+
+template <typename T>
+static TINYTEXT_QUEUE_ISR bool compareExchange(T* value, T& expected, T desired)
+{
+    // expected is updated with what was there when the exchange fails
+#if defined(__AVR__)
+    // single core, no atomic instructions: interrupts off around it
+    uint8_t sreg = SREG;
+    cli();
+    bool swapped = (*value == expected);
+    if (swapped)
+    {
+        *value = desired;
+    }
+    else
+    {
+        expected = *value;
+    }
+    SREG = sreg;
+    return swapped;
+#elif defined(ESP8266)
+    uint32_t ps = xt_rsil(15);
+    bool swapped = (*value == expected);
+    if (swapped)
+    {
+        *value = desired;
+    }
+    else
+    {
+        expected = *value;
+    }
+    xt_wsr_ps(ps);
+    return swapped;
+#else
+    return __atomic_compare_exchange_n(value, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+TinyTextQueue::TinyTextQueue(TinyTextDisplay* tft)
+{
+    _tft = tft;
+    _head = 0;
+    _tail = 0;
+    _overflow = TINYTEXT_DROP_NEWEST;
+    _highWater = 0;
+    _dropped = 0;
+    _damage = DAMAGE_EMPTY;
+    _regionCallback = NULL;
+}
+
+uint8_t TinyTextQueue::Count()
+{
+    return (uint8_t)(__atomic_load_n(&_tail, __ATOMIC_ACQUIRE) - __atomic_load_n(&_head, __ATOMIC_ACQUIRE));
+}
+
+TINYTEXT_QUEUE_ISR void TinyTextQueue::mergeDamage(uint8_t col, uint8_t row, uint8_t w, uint8_t h)
+{
+    // grows the region to cover cells that were dropped
+    if ((w == 0) || (h == 0))
+    {
+        return;
+    }
+    uint8_t col2 = ((uint16_t)col + w - 1 > 0xFF) ? 0xFF : col + w - 1;
+    uint8_t row2 = ((uint16_t)row + h - 1 > 0xFF) ? 0xFF : row + h - 1;
+    uint32_t damage = __atomic_load_n(&_damage, __ATOMIC_ACQUIRE);
+    uint32_t merged;
+    do
+    {
+        uint8_t c1 = damage;
+        uint8_t r1 = damage >> 8;
+        uint8_t c2 = damage >> 16;
+        uint8_t r2 = damage >> 24;
+        if (c1 > c2)
+        {
+            c1 = col; // was empty
+            r1 = row;
+            c2 = col2;
+            r2 = row2;
+        }
+        c1 = (col < c1) ? col : c1;
+        r1 = (row < r1) ? row : r1;
+        c2 = (col2 > c2) ? col2 : c2;
+        r2 = (row2 > r2) ? row2 : r2;
+        merged = c1 | ((uint32_t)r1 << 8) | ((uint32_t)c2 << 16) | ((uint32_t)r2 << 24);
+    }
+    while (!compareExchange(&_damage, damage, merged));
+}
+
+TINYTEXT_QUEUE_ISR bool TinyTextQueue::post(TinyTextQueueEntry& entry)
+{
+    uint8_t tail = _tail; // only the producer moves it
+    uint8_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    if ((uint8_t)(tail - head) >= TINYTEXT_QUEUE_SIZE)
+    {
+        if (_overflow != TINYTEXT_DROP_OLDEST)
+        {
+            if (_overflow == TINYTEXT_MERGE_DIRTY)
+            {
+                switch (entry.type)
+                {
+                case QUEUE_PUT:
+                case QUEUE_PRINT:
+                    mergeDamage(entry.col, entry.row, entry.len, 1);
+                    break;
+                case QUEUE_FILL:
+                    mergeDamage(entry.col, entry.row, entry.len, entry.text[0]);
+                    break;
+                default:
+                    mergeDamage(0, 0, 0xFF, 0xFF); // the console could be anywhere
+                    break;
+                }
+            }
+            _dropped++;
+            return false;
+        }
+        // take the oldest entry: if the consumer was copying it, its own
+        // exchange of the head fails and it takes the next one instead
+        if (compareExchange(&_head, head, (uint8_t)(head + 1)))
+        {
+            _dropped++;
+        }
+        // else the consumer took it meanwhile and there is room now
+    }
+    _entries[tail & QUEUE_MASK] = entry;
+    tail++;
+    __atomic_store_n(&_tail, tail, __ATOMIC_RELEASE);
+
+    uint8_t count = tail - __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    if (count > _highWater)
+    {
+        _highWater = count;
+    }
+    return true;
+}
+
+bool TinyTextQueue::take(TinyTextQueueEntry& entry)
+{
+    uint8_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    for (;;)
+    {
+        if (head == __atomic_load_n(&_tail, __ATOMIC_ACQUIRE))
+        {
+            return false;
+        }
+        entry = _entries[head & QUEUE_MASK];
+        if (compareExchange(&_head, head, (uint8_t)(head + 1)))
+        {
+            return true;
+        }
+        // the producer dropped this entry while it was being copied, head has moved on
+    }
+}
+
+TINYTEXT_QUEUE_ISR bool TinyTextQueue::Put(uint8_t col, uint8_t row, char chr, uint16_t foreColor, uint16_t backColor)
+{
+    TinyTextQueueEntry entry;
+    entry.type = QUEUE_PUT;
+    entry.col = col;
+    entry.row = row;
+    entry.len = 1;
+    entry.foreColor = foreColor;
+    entry.backColor = backColor;
+    entry.text[0] = chr;
+    return post(entry);
+}
+
+TINYTEXT_QUEUE_ISR bool TinyTextQueue::Print(uint8_t col, uint8_t row, const char* str, uint16_t foreColor, uint16_t backColor)
+{
+    bool posted = true;
+    TinyTextQueueEntry entry;
+    entry.type = QUEUE_PRINT;
+    entry.row = row;
+    entry.foreColor = foreColor;
+    entry.backColor = backColor;
+    while ((*str != 0) && (col < _tft->Columns()))
+    {
+        // whole UTF-8 characters only, each one is a cell
+        uint8_t len = 0;
+        uint8_t cells = 0;
+        while (str[len] != 0)
+        {
+            uint8_t c = str[len];
+            uint8_t size = (c < 0xC0) ? 1 : ((c < 0xE0) ? 2 : ((c < 0xF0) ? 3 : 4));
+            if (len + size > TINYTEXT_QUEUE_TEXT)
+            {
+                break;
+            }
+            for (uint8_t i = 0; (i < size) && (str[len] != 0); i++)
+            {
+                entry.text[len] = str[len];
+                len++;
+            }
+            cells++;
+        }
+        entry.col = col;
+        entry.len = len;
+        posted &= post(entry);
+        str += len;
+        col += cells;
+    }
+    return posted;
+}
+
+TINYTEXT_QUEUE_ISR bool TinyTextQueue::FillCells(uint8_t col, uint8_t row, uint8_t w, uint8_t h, uint16_t backColor)
+{
+    TinyTextQueueEntry entry;
+    entry.type = QUEUE_FILL;
+    entry.col = col;
+    entry.row = row;
+    entry.len = w;
+    entry.foreColor = backColor;
+    entry.backColor = backColor;
+    entry.text[0] = h;
+    return post(entry);
+}
+
+TINYTEXT_QUEUE_ISR bool TinyTextQueue::Write(const char* str)
+{
+    bool posted = true;
+    TinyTextQueueEntry entry;
+    entry.type = QUEUE_WRITE;
+    while (*str != 0)
+    {
+        uint8_t len = 0;
+        while ((len < TINYTEXT_QUEUE_TEXT) && (str[len] != 0))
+        {
+            entry.text[len] = str[len];
+            len++;
+        }
+        entry.len = len;
+        posted &= post(entry);
+        str += len;
+    }
+    return posted;
+}
+
+uint16_t TinyTextQueue::Service()
+{
+    uint16_t taken = 0;
+    TinyTextQueueEntry entry;
+    bool grid = _tft->GridEnabled();
+    while (take(entry))
+    {
+        taken++;
+        switch (entry.type)
+        {
+        case QUEUE_PUT:
+            _tft->Put(entry.col, entry.row, entry.text[0], entry.foreColor, entry.backColor);
+            break;
+        case QUEUE_PRINT:
+            if (grid)
+            {
+                _tft->Print(entry.col, entry.row, entry.text, (size_t)entry.len, entry.foreColor, entry.backColor);
+            }
+            else
+            {
+                _tft->DrawString(entry.col, entry.row, entry.text, entry.len, entry.foreColor, entry.backColor);
+            }
+            break;
+        case QUEUE_FILL:
+            _tft->FillCells(entry.col, entry.row, entry.len, entry.text[0], entry.backColor);
+            break;
+        case QUEUE_WRITE:
+            _tft->Write(entry.text, entry.len);
+            break;
+        }
+    }
+
+    uint32_t damage = __atomic_load_n(&_damage, __ATOMIC_ACQUIRE);
+    while (!compareExchange(&_damage, damage, (uint32_t)DAMAGE_EMPTY))
+    {
+    }
+    uint8_t col1 = damage;
+    uint8_t row1 = damage >> 8;
+    uint8_t col2 = damage >> 16;
+    uint8_t row2 = damage >> 24;
+    if ((col1 <= col2) && (_regionCallback != NULL) && (col1 < _tft->Columns()) && (row1 < _tft->Rows()))
+    {
+        col2 = (col2 < _tft->Columns()) ? col2 : _tft->Columns() - 1;
+        row2 = (row2 < _tft->Rows()) ? row2 : _tft->Rows() - 1;
+        _regionCallback(col1, row1, col2 - col1 + 1, row2 - row1 + 1);
+    }
+
+    if (grid && _tft->IsDirty())
+    {
+        _tft->Flush(); // everything queued goes out as one transaction of dirty runs
+    }
+    return taken;
+}
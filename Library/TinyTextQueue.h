@@ -0,0 +1,99 @@
+#ifndef TinyTextQueue_h
+#define TinyTextQueue_h
+
+#include "TinyTextTFT.h"
+
+/*
+  A fixed size queue of drawing requests for one TinyTextTFT, for text that is
+  produced where the SPI bus can't be used: an interrupt handler or another task.
+
+  One producer posts requests (Put, Print, FillCells, Write) from any context,
+  they copy a few bytes and never block. The task that owns the panel calls
+  Service() to apply everything queued. With the shadow grid enabled the cells
+  only go to the grid and Service() ends with one Flush, so a burst of requests
+  costs one transaction of dirty runs; without the grid each request is drawn
+  as it is taken.
+
+  Lock-free for one producer and one consumer: the producer owns the tail, the
+  consumer the head. With several producers give each one a queue of its own
+  and Service() them all from the task that owns the panel; each producer's
+  requests are drawn in the order it posted them (Tools/Queue tests this with
+  threads). When the queue is full the overflow mode decides:
+    TINYTEXT_DROP_NEWEST  the new request is dropped
+    TINYTEXT_DROP_OLDEST  the oldest request is dropped to make room
+    TINYTEXT_MERGE_DIRTY  the new request is dropped but the cells it covers are
+                          collected into a region that Service() passes to the
+                          region callback, so the application can redraw them
+*/
+
+#ifndef TINYTEXT_QUEUE_SIZE
+#define TINYTEXT_QUEUE_SIZE 32 // entries, a power of 2 up to 128
+#endif
+
+#define TINYTEXT_QUEUE_TEXT 10 // characters per entry, longer text takes several
+
+#if defined(ESP8266) || defined(ESP32)
+#define TINYTEXT_QUEUE_ISR IRAM_ATTR // producers can run from interrupts
+#else
+#define TINYTEXT_QUEUE_ISR
+#endif
+
+enum TinyTextOverflow
+{
+    TINYTEXT_DROP_NEWEST,
+    TINYTEXT_DROP_OLDEST,
+    TINYTEXT_MERGE_DIRTY
+};
+
+typedef void (*TinyTextRegionCallback)(uint8_t col, uint8_t row, uint8_t w, uint8_t h);
+
+struct TinyTextQueueEntry
+{
+    uint8_t  type;
+    uint8_t  col;
+    uint8_t  row;
+    uint8_t  len;  // characters, or width of a fill
+    uint16_t foreColor;
+    uint16_t backColor;
+    char     text[TINYTEXT_QUEUE_TEXT]; // the height of a fill in text[0]
+};
+
+class TinyTextQueue
+{
+private:
+    TinyTextDisplay* _tft;
+    TinyTextQueueEntry _entries[TINYTEXT_QUEUE_SIZE];
+    uint8_t _head; // next entry to take, moved by the consumer (and by DROP_OLDEST)
+    uint8_t _tail; // next entry to fill, moved by the producer
+    uint8_t _overflow;
+    uint8_t _highWater;
+    uint32_t _dropped;
+    uint32_t _damage; // col1 | row1 << 8 | col2 << 16 | row2 << 24, empty when col1 > col2
+    TinyTextRegionCallback _regionCallback;
+
+    bool post(TinyTextQueueEntry& entry);
+    bool take(TinyTextQueueEntry& entry);
+    void mergeDamage(uint8_t col, uint8_t row, uint8_t w, uint8_t h);
+
+public:
+    TinyTextQueue(TinyTextDisplay* tft);
+
+    void SetOverflow(TinyTextOverflow overflow) { _overflow = overflow; }
+    void SetRegionCallback(TinyTextRegionCallback callback) { _regionCallback = callback; }
+
+    // Producer: false if the request (or part of the text) was dropped.
+    bool Put(uint8_t col, uint8_t row, char chr, uint16_t foreColor, uint16_t backColor);
+    bool Print(uint8_t col, uint8_t row, const char* str, uint16_t foreColor, uint16_t backColor);
+    bool FillCells(uint8_t col, uint8_t row, uint8_t w, uint8_t h, uint16_t backColor);
+    bool Write(const char* str); // console text, see TinyTextTFT::Write
+
+    // Consumer: applies everything queued, returns the number of entries taken.
+    uint16_t Service();
+
+    uint8_t Count();
+    uint8_t HighWater() { return _highWater; } // most entries queued at once
+    uint32_t Dropped() { return _dropped; }
+    void ResetHighWater() { _highWater = 0; }
+};
+
+#endif
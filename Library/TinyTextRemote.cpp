@@ -0,0 +1,205 @@
+#include "Arduino.h"
+#include "TinyTextRemote.h"
+
+static const uint8_t PROGMEM remoteArgs[] = TINYTEXT_REMOTE_ARGS;
+
+TinyTextRemote::TinyTextRemote(TinyTextDisplay* tft, Stream* stream)
+{
+    _tft = tft;
+    _stream = stream;
+    _have = 0;
+    _need = 0;
+    _col = 0;
+    _row = 0;
+    _foreColor = RGB444_WHITE;
+    _backColor = RGB444_BLACK;
+    _bytes = 0;
+    _commands = 0;
+}
+
+uint16_t TinyTextRemote::Poll()
+{
+    // only what is there now, so a host that keeps sending can't hold up loop()
+    uint16_t commands = 0;
+    int available = _stream->available();
+    while (available-- > 0)
+    {
+        int b = _stream->read();
+        if (b < 0)
+        {
+            break;
+        }
+        if (Decode((uint8_t)b))
+        {
+            commands++;
+        }
+    }
+    return commands;
+}
+
+bool TinyTextRemote::Decode(uint8_t b)
+{
+    _bytes++;
+    if (_have == 0)
+    {
+        if (b >= TINYTEXT_REMOTE_TEXT)
+        {
+            _need = (b >= TINYTEXT_REMOTE_SKIP) ? 1 : 2 + (b & 0x3F);
+        }
+        else if (b < sizeof(remoteArgs))
+        {
+            _need = 1 + pgm_read_byte(&remoteArgs[b]);
+        }
+        else
+        {
+            return false; // unknown, skipped as a NOP
+        }
+    }
+    _command[_have++] = b;
+    if (_have < _need)
+    {
+        return false;
+    }
+    execute();
+    _have = 0;
+    _commands++;
+    return true;
+}
+
+void TinyTextRemote::execute()
+{
+    uint8_t op = _command[0];
+    if (op >= TINYTEXT_REMOTE_SKIP)
+    {
+        _col += (op & 0x3F) + 1;
+        return;
+    }
+    if (op >= TINYTEXT_REMOTE_TEXT)
+    {
+        text((const char*)&_command[1], (op & 0x3F) + 1);
+        return;
+    }
+    switch (op)
+    {
+    case TINYTEXT_REMOTE_CURSOR:
+        _col = _command[1];
+        _row = _command[2];
+        break;
+    case TINYTEXT_REMOTE_COLORS:
+        _foreColor = ((uint16_t)_command[1] << 4) | (_command[2] >> 4);
+        _backColor = ((uint16_t)(_command[2] & 0x0F) << 8) | _command[3];
+        break;
+    case TINYTEXT_REMOTE_REPEAT:
+        repeat(_command[1], ((uint16_t)_command[2] << 8) | _command[3]);
+        break;
+    case TINYTEXT_REMOTE_FILL:
+        _tft->FillCells(_command[1], _command[2], _command[3], _command[4], _backColor);
+        break;
+    case TINYTEXT_REMOTE_SCROLL:
+        scroll(_command[1]);
+        break;
+    case TINYTEXT_REMOTE_FLUSH:
+        if (_tft->GridEnabled() && _tft->IsDirty())
+        {
+            _tft->Flush();
+        }
+        break;
+    }
+}
+
+void TinyTextRemote::text(const char* str, uint8_t len)
+{
+    uint8_t cells = 0;
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (((uint8_t)str[i] & 0xC0) != 0x80)
+        {
+            cells++; // one per character
+        }
+    }
+    if (_tft->GridEnabled())
+    {
+        _tft->Print(_col, _row, str, (size_t)len, _foreColor, _backColor);
+    }
+    else
+    {
+        _tft->DrawString(_col, _row, str, len, _foreColor, _backColor);
+    }
+    _col += cells;
+}
+
+void TinyTextRemote::repeat(uint8_t count, uint16_t code)
+{
+    if (_tft->GridEnabled())
+    {
+        for (uint8_t i = 0; i < count; i++)
+        {
+            _tft->PutCode(_col + i, _row, code, _foreColor, _backColor);
+        }
+        _col += count;
+        return;
+    }
+
+    // without the grid: as UTF-8 runs, each one a single address window
+    char utf8[3];
+    uint8_t size;
+    if (code < 0x80)
+    {
+        utf8[0] = code;
+        size = 1;
+    }
+    else if (code < 0x800)
+    {
+        utf8[0] = 0xC0 | (code >> 6);
+        utf8[1] = 0x80 | (code & 0x3F);
+        size = 2;
+    }
+    else
+    {
+        utf8[0] = 0xE0 | (code >> 12);
+        utf8[1] = 0x80 | ((code >> 6) & 0x3F);
+        utf8[2] = 0x80 | (code & 0x3F);
+        size = 3;
+    }
+    char* run = (char*)_command; // the arguments have been read
+    uint8_t perRun = sizeof(_command) / size;
+    while (count != 0)
+    {
+        uint8_t cells = (count < perRun) ? count : perRun;
+        for (uint8_t i = 0; i < cells; i++)
+        {
+            memcpy(run + i * size, utf8, size);
+        }
+        _tft->DrawString(_col, _row, run, cells * size, _foreColor, _backColor);
+        _col += cells;
+        count -= cells;
+    }
+}
+
+void TinyTextRemote::scroll(uint8_t rows)
+{
+    if (!_tft->GridEnabled() && !_tft->ConsoleHardwareScroll())
+    {
+        // the console would scroll from a grid of its own that never saw what
+        // the host drew: ask for the whole screen instead
+        if (_stream != NULL)
+        {
+            _stream->write(TINYTEXT_REMOTE_RESYNC);
+        }
+        return;
+    }
+
+    // the console scroll, leaving the console cursor and colours as they were
+    uint8_t col = _tft->CursorColumn();
+    uint8_t row = _tft->CursorRow();
+    uint16_t consoleFore = _tft->ConsoleForeColor();
+    uint16_t consoleBack = _tft->ConsoleBackColor();
+    _tft->SetConsoleColors(_foreColor, _backColor);
+    while (rows-- != 0)
+    {
+        _tft->SetCursor(0, _tft->Rows() - 1);
+        _tft->Write("\n", 1);
+    }
+    _tft->SetCursor(col, row);
+    _tft->SetConsoleColors(consoleFore, consoleBack);
+}
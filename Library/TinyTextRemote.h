@@ -0,0 +1,58 @@
+#ifndef TinyTextRemote_h
+#define TinyTextRemote_h
+
+#include "TinyTextTFT.h"
+#include "TinyTextProtocol.h"
+
+/*
+  Mirrors a screen sent from a host over a Stream (usually a Serial port) in the
+  compact form described in TinyTextProtocol.h, instead of one DrawChar call
+  worth of bytes per cell. The host side encoder (Tools/Remote) diffs successive
+  screens and sends only the cells that changed.
+
+  Call Poll() from loop(): it decodes the bytes that have arrived and returns.
+  With the shadow grid enabled the cells only go to the grid and each FLUSH sends
+  the dirty runs in one go, which is the fastest way to show a burst of updates.
+  Without the grid every command is drawn as it arrives. SCROLL uses the console
+  scroll (see TinyTextTFT::Write). Without the grid that only works where the
+  console has the controller's hardware scroll (rotations 0 and 2, the whole
+  screen as the scroll area): anywhere else the remote doesn't know what it would
+  be scrolling, so it refuses the SCROLL and writes RESYNC back to the stream for
+  the host to send the whole screen again (TinyTextEncoder::EncodeFull). A host
+  that knows the remote is set up like that turns SCROLL off in its encoder
+  (TinyTextEncoder::SetScroll) and is never asked.
+*/
+
+class TinyTextRemote
+{
+private:
+    TinyTextDisplay* _tft;
+    Stream*  _stream;
+    uint8_t  _command[1 + TINYTEXT_REMOTE_MAX_TEXT]; // opcode and arguments
+    uint8_t  _have;     // bytes of the command received so far
+    uint8_t  _need;     // bytes the command takes
+    uint8_t  _col;      // cursor
+    uint8_t  _row;
+    uint16_t _foreColor;
+    uint16_t _backColor;
+    uint32_t _bytes;
+    uint32_t _commands;
+
+    void execute();
+    void text(const char* str, uint8_t len);
+    void repeat(uint8_t count, uint16_t code);
+    void scroll(uint8_t rows);
+
+public:
+    TinyTextRemote(TinyTextDisplay* tft, Stream* stream);
+
+    // Decodes what the stream has, returns the number of commands completed.
+    uint16_t Poll();
+    // One byte from somewhere other than the stream, true if it completed a command.
+    bool Decode(uint8_t b);
+
+    uint32_t Bytes()    { return _bytes; }
+    uint32_t Commands() { return _commands; }
+};
+
+#endif
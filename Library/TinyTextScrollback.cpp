@@ -0,0 +1,277 @@
+#include "TinyTextScrollback.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ROW_HEADER  6 // length, glyphs, runs, fill colour
+#define ROW_TRAILER 2 // length, to walk back from the row after
+#define ROW_RUN     5 // count, fore, back
+#define NO_CACHE    0xFFFF
+
+TinyTextScrollback::TinyTextScrollback()
+{
+    _memory = NULL;
+    _budget = 0;
+    Clear();
+}
+
+TinyTextScrollback::~TinyTextScrollback()
+{
+    End();
+}
+
+bool TinyTextScrollback::Begin(uint32_t budgetBytes)
+{
+    End();
+    _memory = (uint8_t*)malloc(budgetBytes);
+    if (_memory == NULL)
+    {
+        return false;
+    }
+    _budget = budgetBytes;
+    Clear();
+    return true;
+}
+
+void TinyTextScrollback::End()
+{
+    free(_memory);
+    _memory = NULL;
+    _budget = 0;
+    Clear();
+}
+
+void TinyTextScrollback::Clear()
+{
+    _first = 0;
+    _next = 0;
+    _wrapAt = 0;
+    _wrapped = false;
+    _lines = 0;
+    _cacheLine = NO_CACHE;
+}
+
+uint16_t TinyTextScrollback::read16(uint32_t offset)
+{
+    return _memory[offset] | ((uint16_t)_memory[offset + 1] << 8);
+}
+
+uint32_t TinyTextScrollback::Used()
+{
+    if (_lines == 0)
+    {
+        return 0;
+    }
+    return _wrapped ? (_wrapAt - _first) + _next : _next - _first;
+}
+
+uint32_t TinyTextScrollback::before(uint32_t start)
+{
+    // start of the row that ends where the row at start begins
+    if (_wrapped && (start == 0))
+    {
+        start = _wrapAt;
+    }
+    return start - read16(start - ROW_TRAILER);
+}
+
+uint32_t TinyTextScrollback::after(uint32_t start)
+{
+    // start of the row after the one at start
+    start += read16(start);
+    if (_wrapped && (start == _wrapAt))
+    {
+        start = 0;
+    }
+    return start;
+}
+
+void TinyTextScrollback::evict()
+{
+    // drops the oldest row
+    _first += read16(_first);
+    _lines--;
+    _cacheLine = NO_CACHE;
+    if (_lines == 0)
+    {
+        Clear();
+    }
+    else if (_wrapped && (_first == _wrapAt))
+    {
+        _first = 0;
+        _wrapped = false;
+    }
+}
+
+void TinyTextScrollback::Append(const uint8_t* glyphs, const uint16_t* foreColors, const uint16_t* backColors, uint8_t len)
+{
+    if (_memory == NULL)
+    {
+        return;
+    }
+    // trailing blanks of the last background are left out, drawn as the fill
+    uint16_t fill = (len != 0) ? backColors[len - 1] : 0;
+    uint8_t cells = len;
+    while ((cells != 0) && (glyphs[cells - 1] == 0) && (backColors[cells - 1] == fill))
+    {
+        cells--;
+    }
+    uint8_t runs = colorRuns(glyphs, foreColors, backColors, cells, NULL);
+    uint16_t size = ROW_HEADER + runs * ROW_RUN + cells + ROW_TRAILER;
+    if (size > _budget)
+    {
+        return; // wouldn't fit in an empty ring
+    }
+
+    // room at the end of the ring, or from its start once the oldest rows are dropped
+    for (;;)
+    {
+        if (!_wrapped)
+        {
+            if (_next + size <= _budget)
+            {
+                break;
+            }
+            _wrapAt = _next;
+            _next = 0;
+            _wrapped = true;
+        }
+        if (_next + size <= _first)
+        {
+            break;
+        }
+        evict();
+    }
+
+    uint8_t* row = _memory + _next;
+    row[0] = (uint8_t)size;
+    row[1] = (uint8_t)(size >> 8);
+    row[2] = cells;
+    row[3] = runs;
+    row[4] = (uint8_t)fill;
+    row[5] = (uint8_t)(fill >> 8);
+    row += ROW_HEADER;
+    colorRuns(glyphs, foreColors, backColors, cells, row);
+    row += runs * ROW_RUN;
+    memcpy(row, glyphs, cells);
+    row += cells;
+    row[0] = (uint8_t)size;
+    row[1] = (uint8_t)(size >> 8);
+    _next += size;
+    _lines++;
+    _cacheLine = NO_CACHE;
+}
+
+uint8_t TinyTextScrollback::colorRuns(const uint8_t* glyphs, const uint16_t* foreColors, const uint16_t* backColors,
+                                      uint8_t len, uint8_t* out)
+{
+    // cells sharing a (fore, back) pair, a blank cell goes with the run it is in
+    // whatever its fore colour: returns the number of runs, written to out if set
+    uint8_t scratch[ROW_RUN]; // the run being built when only counting
+    uint8_t runs = 0;
+    uint8_t* run = NULL;
+    uint16_t runBack = 0;
+    bool runFore = false; // the run has a glyph, so its fore colour is set
+    for (uint8_t i = 0; i < len; i++)
+    {
+        bool blank = (glyphs[i] == 0);
+        if ((run != NULL) && (backColors[i] == runBack) && (blank || !runFore || (foreColors[i] == (run[1] | (run[2] << 8)))))
+        {
+            run[0]++;
+            if (!blank && !runFore)
+            {
+                run[1] = (uint8_t)foreColors[i];
+                run[2] = (uint8_t)(foreColors[i] >> 8);
+                runFore = true;
+            }
+            continue;
+        }
+        run = (out != NULL) ? out + runs * ROW_RUN : scratch;
+        uint16_t fore = blank ? backColors[i] : foreColors[i];
+        run[0] = 1;
+        run[1] = (uint8_t)fore;
+        run[2] = (uint8_t)(fore >> 8);
+        run[3] = (uint8_t)backColors[i];
+        run[4] = (uint8_t)(backColors[i] >> 8);
+        runBack = backColors[i];
+        runFore = !blank;
+        runs++;
+    }
+    return runs;
+}
+
+uint32_t TinyTextScrollback::find(uint16_t back)
+{
+    // start of row back: from the last row read when it is next to it, else from
+    // the nearer end
+    uint32_t start;
+    if (_cacheLine == back)
+    {
+        start = _cacheStart;
+    }
+    else if ((_cacheLine != NO_CACHE) && (_cacheLine == back + 1))
+    {
+        start = after(_cacheStart);
+    }
+    else if ((_cacheLine != NO_CACHE) && (_cacheLine + 1 == back))
+    {
+        start = before(_cacheStart);
+    }
+    else if (back < _lines / 2)
+    {
+        start = before(_next);
+        for (uint16_t i = 0; i < back; i++)
+        {
+            start = before(start);
+        }
+    }
+    else
+    {
+        start = _first;
+        for (uint16_t i = _lines - 1; i > back; i--)
+        {
+            start = after(start);
+        }
+    }
+    _cacheLine = back;
+    _cacheStart = start;
+    return start;
+}
+
+bool TinyTextScrollback::Get(uint16_t back, uint8_t* glyphs, uint16_t* foreColors, uint16_t* backColors, uint8_t width)
+{
+    if (back >= _lines)
+    {
+        return false;
+    }
+    const uint8_t* row = _memory + find(back);
+    uint8_t cells = row[2];
+    uint8_t runs = row[3];
+    uint16_t fill = row[4] | ((uint16_t)row[5] << 8);
+    const uint8_t* run = row + ROW_HEADER;
+    const uint8_t* glyph = run + runs * ROW_RUN;
+    uint8_t left = 0; // cells to go in the current run
+    uint16_t fore = fill;
+    uint16_t backColor = fill;
+    for (uint8_t i = 0; i < width; i++)
+    {
+        if (i >= cells)
+        {
+            glyphs[i] = 0;
+            foreColors[i] = fill;
+            backColors[i] = fill;
+            continue;
+        }
+        if (left == 0)
+        {
+            left = run[0];
+            fore = run[1] | ((uint16_t)run[2] << 8);
+            backColor = run[3] | ((uint16_t)run[4] << 8);
+            run += ROW_RUN;
+        }
+        left--;
+        glyphs[i] = glyph[i];
+        foreColors[i] = (glyph[i] == 0) ? backColor : fore; // as TinyTextTFT draws a blank
+        backColors[i] = backColor;
+    }
+    return true;
+}
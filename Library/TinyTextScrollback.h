@@ -0,0 +1,66 @@
+#ifndef TinyTextScrollback_h
+#define TinyTextScrollback_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+  Rows of cells that have scrolled off a TinyTextWindow, kept in a fixed amount
+  of RAM so they can be scrolled back to (see TinyTextWindow::SetScrollback).
+
+  Each row is stored as its glyphs with the trailing blanks trimmed, and its
+  colours as runs of cells sharing a (fore, back) pair:
+    length (2 bytes), glyphs, runs, fill colour (2 bytes), [count, fore, back] x runs,
+    glyphs (1 byte each), length (2 bytes)
+  so a line of log text in one colour costs its characters plus 13 bytes. The
+  rows sit one after the other in a ring, the oldest are dropped to make room
+  for new ones. Rows are found by walking from the newest (or from the last one
+  read), so reading a page of consecutive rows costs a step each.
+
+  Does not depend on Arduino.h so it can be measured on a PC, see Tools/Scrollback.
+*/
+
+class TinyTextScrollback
+{
+private:
+    uint8_t* _memory;
+    uint32_t _budget;
+    uint32_t _first;   // oldest row
+    uint32_t _next;    // where the next row goes
+    uint32_t _wrapAt;  // end of the rows at the top of the ring once it has wrapped
+    bool     _wrapped; // rows run from _first to _wrapAt, then from 0 to _next
+    uint16_t _lines;
+    uint16_t _cacheLine; // last row read (rows back from the newest) and where it starts
+    uint32_t _cacheStart;
+
+    uint16_t read16(uint32_t offset);
+    void evict();
+    uint8_t colorRuns(const uint8_t* glyphs, const uint16_t* foreColors, const uint16_t* backColors, uint8_t len, uint8_t* out);
+    uint32_t find(uint16_t back);
+    uint32_t before(uint32_t start);
+    uint32_t after(uint32_t start);
+
+public:
+    TinyTextScrollback();
+    ~TinyTextScrollback();
+
+    // Allocates budgetBytes for the rows, false if there isn't the RAM. A row takes
+    // at most 8 bytes plus 6 a cell (every cell a different colour pair), a row
+    // too big for the whole budget isn't kept.
+    bool Begin(uint32_t budgetBytes);
+    void End();
+    void Clear();
+
+    // Adds a row, the newest. Blank cells (glyph 0) are stored with fore the same as
+    // back, as TinyTextTFT draws them.
+    void Append(const uint8_t* glyphs, const uint16_t* foreColors, const uint16_t* backColors, uint8_t len);
+    // Row back (0 for the newest) into width cells, false if it isn't kept (any
+    // more). Cells past the end of the row are blanks of its last background.
+    bool Get(uint16_t back, uint8_t* glyphs, uint16_t* foreColors, uint16_t* backColors, uint8_t width);
+
+    uint16_t Lines()  { return _lines; }
+    uint32_t Used();  // bytes taken by the rows kept
+    uint32_t Budget() { return _budget; }
+};
+
+#endif
@@ -3,6 +3,11 @@
 
 #include "Arduino.h"
 #include "SPI.h"
+#include "TinyTextBlend.h"
+#include "TinyTextBus.h"
+#include "TinyTextCanvas.h"
+#include "TinyTextClock.h"
+#include "TinyTextPipeline.h"
 
 /*
   I used code from the Adafruit ILI9341 driver and Adafruit_GFX
@@ -30,12 +35,124 @@
 #define RGB444_RED   0xF00       // 255,   0,   0
 #define RGB444_WHITE 0xFFF       // 255, 255, 255
 
-class TinyTextTFT
+// Calibrate: the slowest clock tried and the fastest the panel is read at, inside
+// the ILI9341's 150ns read cycle.
+#ifndef TINYTEXT_CLOCK_MIN
+#define TINYTEXT_CLOCK_MIN 4000000
+#endif
+#ifndef TINYTEXT_READ_FREQ
+#define TINYTEXT_READ_FREQ 6000000
+#endif
+
+// Uncomment to count bus traffic, window and blend work and time spent in the
+// public calls, see GetStats(). Costs nothing when left out.
+//#define TINYTEXT_STATS
+
+#ifdef TINYTEXT_STATS
+// public calls timed by the stats (inclusive of any calls they make)
+enum
+{
+    TINYTEXT_CALL_DRAWCHAR,
+    TINYTEXT_CALL_DRAWSTRING, // and DrawRun
+    TINYTEXT_CALL_FILL,
+    TINYTEXT_CALL_FLUSH,
+    TINYTEXT_CALL_WRITE,
+    TINYTEXT_CALLS
+};
+
+struct TinyTextStats
+{
+    uint32_t transactions;  // startWrite .. endWrite
+    uint32_t commandBytes;  // sent with DC low
+    uint32_t dataBytes;     // command parameters and pixels
+    uint32_t csToggles;
+    uint32_t dcToggles;
+    uint32_t columnSets;    // setAddrWindow sent CASET
+    uint32_t columnSkips;   // .. or the columns were already set
+    uint32_t pageSets;      // same for PASET
+    uint32_t pageSkips;
+    uint32_t blendCalls;
+    uint32_t glyphsDrawn;   // cells sent with a glyph
+    uint32_t blankCells;    // cells sent as background only
+    uint32_t calls[TINYTEXT_CALLS];
+    uint32_t callMicros[TINYTEXT_CALLS];
+};
+#endif
+
+typedef void (*TinyTextCallback)(void);
+
+// A UTF-8 character cut off by the end of one Write, kept for the next: the
+// console's and TinyTextWindow's. Finish takes the rest of it from the front of
+// the new text and gives the bytes ready to draw (a character cut short is
+// drawn as ' '), Hold keeps the start of one cut off at the end and gives the
+// bytes to write now.
+class TinyTextUTF8Hold
+{
+private:
+    char    _bytes[4];
+    uint8_t _len;
+
+public:
+    TinyTextUTF8Hold() { _len = 0; }
+    void Clear() { _len = 0; }
+    uint8_t Finish(const char*& str, size_t& len); // bytes at Bytes(), 0 for none
+    const char* Bytes() { return _bytes; }
+    size_t Hold(const char* str, size_t len);
+};
+
+enum
+{
+    TINYTEXT_BEGIN_READY,
+    TINYTEXT_BEGIN_RESET,    // RESX held low
+    TINYTEXT_BEGIN_COMMANDS  // walking initcmd
+};
+
+// The driver, for any bus to the panel (see TinyTextBus.h). TinyTextTFT, the one
+// on CS and DC pins and an SPIClass, is built with the library; for another bus
+// include TinyTextTFTImpl.h in one .cpp file of the sketch as well.
+// The driver as TinyTextWindow, TinyTextField, TinyTextRemote, TinyTextQueue and
+// TinyTextPanels use it, whatever its bus: they take a TinyTextDisplay*, so any
+// TinyTextTFTBus<Bus> can be given to them. The calls are those of the driver
+// below, see there.
+class TinyTextDisplay
+{
+public:
+    virtual uint16_t Rows() = 0;
+    virtual uint16_t Columns() = 0;
+
+    virtual void FillCells(uint8_t col, uint8_t row, uint8_t w, uint8_t h, uint16_t backColor) = 0;
+    virtual void DrawString(uint8_t col, uint8_t row, const char* str, uint8_t len, uint16_t foreColor, uint16_t backColor) = 0;
+    virtual void DrawGlyphs(uint8_t col, uint8_t row, const uint8_t* glyphs, const uint16_t* foreColors, const uint16_t* backColors, uint8_t len) = 0;
+
+    virtual bool GridEnabled() = 0;
+    virtual bool IsDirty() = 0;
+    virtual void Put(uint8_t col, uint8_t row, char chr, uint16_t foreColor, uint16_t backColor) = 0;
+    virtual void PutCode(uint8_t col, uint8_t row, uint16_t code, uint16_t foreColor, uint16_t backColor) = 0;
+    virtual void Print(uint8_t col, uint8_t row, const char* str, size_t len, uint16_t foreColor, uint16_t backColor) = 0;
+    virtual void Flush() = 0;
+    virtual bool FlushAsync(TinyTextCallback callback = NULL) = 0;
+    virtual bool Poll() = 0;
+
+    virtual void SetCursor(uint8_t col, uint8_t row) = 0;
+    virtual uint8_t CursorColumn() = 0;
+    virtual uint8_t CursorRow() = 0;
+    virtual void SetConsoleColors(uint16_t foreColor, uint16_t backColor) = 0;
+    virtual uint16_t ConsoleForeColor() = 0;
+    virtual uint16_t ConsoleBackColor() = 0;
+    virtual void Write(const char* str, size_t len) = 0;
+
+    virtual bool ConsoleHardwareScroll() = 0;
+    virtual bool SetScrollArea(uint8_t row, uint8_t rows) = 0;
+    virtual bool ScrollAreaUp(uint16_t backColor) = 0;
+};
+
+template <class Bus>
+class TinyTextTFTBus : public Print, public TinyTextDisplay
 {
 private:
-    SPIClass* _spi;
+    Bus _bus;
 
-    SPISettings _settings; ///< SPI transaction settings
+    uint32_t _frequency;   // SPI clock for the panel
     uint16_t _width;
     uint16_t _height;
     uint8_t  _rotation;
@@ -44,34 +161,147 @@ private:
     uint8_t _rows;
     uint8_t _columns;
 
-    // pins
-    int8_t _cs;
-    int8_t _dc;
-    int8_t _rst;
+    // last address window sent, see setAddrWindow
+    uint16_t _windowX1;
+    uint16_t _windowX2;
+    uint16_t _windowY1;
+    uint16_t _windowY2;
+
+    int8_t _rst; // reset pin, -1 for a software reset
+
+    TinyTextCanvas* _canvas; // takes everything meant for the panel when set
+    uint8_t* _canvasRun;     // the palettes of a run and a scanline, see writeCanvasRun
+    bool _offline;           // nothing goes to the panel: a canvas is set or it isn't ready
+    uint8_t _madctl;         // for the current rotation
 
-    uint8_t fontMap[256];
+    // BeginAsync state
+    uint8_t  _beginState;
+    uint16_t _beginOffset;   // next initcmd entry
+    uint32_t _beginReset;    // micros() when the reset ended
+    uint32_t _beginTime;     // micros() the wait started
+    uint32_t _beginWait;     // micros to wait before the next step
 
+    // blended tones of the most recently used colour pairs
+    TinyTextPalettes _palettes;
+
+    // optional pre-rendered glyph cache (see EnableGlyphCache)
+    uint8_t*  _glyphImages; // 100 bytes per entry, ready to send
+    uint32_t* _glyphKeys;   // glyph index << 24 | fore << 12 | back
+    uint16_t* _glyphUsed;   // LRU stamps
+    uint16_t  _glyphEntries;
+    uint16_t  _glyphClock;
+    uint32_t  _glyphHits;
+    uint32_t  _glyphMisses;
+
+    // optional shadow grid (see EnableGrid)
+    uint8_t*  _gridGlyphs; // font index per cell
+    uint16_t* _gridFore;
+    uint16_t* _gridBack;
+    uint8_t*  _gridDirty;  // one bit per cell
+    bool      _gridAnyDirty;
+    bool      _gridConsole; // enabled by the console to scroll in software, not by EnableGrid
+
+    // FlushAsync state: one line buffer is rendered while the other goes out
+    uint8_t* _asyncBuffers[2];
+    uint16_t _asyncSize[2]; // bytes waiting in each buffer, 0 when free
+    uint16_t _asyncX[2];
+    uint16_t _asyncY[2];
+    int8_t   _asyncSending; // buffer going out, -1 for none
+    int8_t   _asyncNext;    // buffer rendered and waiting, -1 for none
+    uint16_t _asyncSent;
+    uint8_t  _asyncCol;     // run being rendered
+    uint8_t  _asyncRow;
+    uint8_t  _asyncLen;
+    uint8_t  _asyncLine;    // next scanline of the run
+    bool     _asyncBusy;
+    TinyTextCallback _asyncCallback;
+    uint32_t _asyncTotal;   // bytes the dirty cells came to when the flush started
+    uint32_t _asyncDone;    // bytes sent so far
+
+    // optional pipelined rendering (see EnablePipeline)
+    TinyTextPipeline _pipeline;
+
+#ifdef TINYTEXT_STATS
+    TinyTextStats _stats;
+#endif
+
+    // console (see Write)
+    uint8_t  _scrollRow;  // text rows the hardware scroll has moved its area by
+    uint8_t  _scrollTop;  // first text row of the hardware scroll area (see SetScrollArea)
+    uint8_t  _scrollRows; // text rows in it
+    uint8_t  _cursorCol;
+    uint8_t  _cursorRow;
+    uint16_t _consoleFore;
+    uint16_t _consoleBack;
+    TinyTextUTF8Hold _utf8;
+
+    void init(int8_t rst);
     void startWrite(void);
     void endWrite(void);
     void spiWrite(uint8_t b);
     void spiWrite16(uint16_t w);
+    void spiWriteColor16(uint16_t color);
+    void spiWriteColor32(uint32_t color);
+    void spiWriteBytes(const uint8_t* data, uint32_t len);
+    void spiWritePattern(const uint8_t* data, uint8_t size, uint32_t repeat);
     uint8_t spiRead(void);
 
     void setAddrWindow(uint16_t x1, uint16_t y1, uint16_t w, uint16_t h);
+    void writeAddrWindow(uint16_t x1, uint16_t y1, uint16_t w, uint16_t h);
+    static void pipelineSend(void* tft, const TinyTextLine& line);
+    void invalidateWindow();
     //void writePixel(int16_t x, int16_t y, uint16_t color);
     //void writeColor(uint16_t color, uint32_t len);
     void writeColor32(uint32_t color, uint32_t len);
     uint32_t makeColor32(uint16_t color0, uint16_t color1);
 
-    uint16_t blendPixelColor(uint8_t tone, uint16_t foreColor, uint16_t backColor);
     uint16_t convertToRGB565(uint16_t rgb444);
+    const uint16_t* getPalette(uint16_t foreColor, uint16_t backColor);
+
+    void writeGlyphLine(uint8_t index, uint8_t y, const uint16_t* palette);
+    void renderGlyphLine(uint8_t* line, uint8_t index, uint8_t y, const uint16_t* palette);
+    void renderRunLine(uint8_t* line, uint8_t y, uint8_t len, const uint8_t* glyphs,
+                       const uint16_t* foreColors, const uint16_t* backColors, uint8_t colorStep);
+    void writeCanvasRun(uint8_t len, const uint8_t* glyphs, const uint16_t* foreColors,
+                        const uint16_t* backColors, uint8_t colorStep);
+    void renderGlyph(uint8_t* image, uint8_t index, const uint16_t* palette);
+    const uint8_t* getGlyphImage(uint8_t index, uint16_t foreColor, uint16_t backColor);
+    void writeRun(uint8_t col, uint8_t row, uint8_t len, const uint8_t* glyphs,
+                  const uint16_t* foreColors, const uint16_t* backColors, uint8_t colorStep);
+
+    uint16_t rowY(uint8_t row)
+    {
+        // rows in the hardware scroll area are moved round it by _scrollRow
+        uint8_t i = row - _scrollTop;
+        return ((i < _scrollRows) ? _scrollTop + (i + _scrollRow) % _scrollRows : row) * _cellHeight;
+    }
+    void writeFill(uint8_t col, uint8_t row, uint8_t w, uint8_t h, uint16_t backColor);
+    void sendScroll();
+    void sendScrollArea();
+    bool softScroll() { return ((_rotation & 1) != 0) || (_scrollTop != 0) || (_scrollRows != _rows); }
+    void consoleGrid();
+    void scrollUp();
+    void newLine();
+    void writeText(const char* str, size_t len);
+
+    void gridFill(uint8_t col, uint8_t row, uint8_t w, uint8_t h, uint16_t backColor, bool dirty);
+    void gridScroll(uint8_t row, uint8_t rows, uint16_t backColor, bool dirty);
+    bool nextDirtyRun(uint8_t& col, uint8_t& row, uint8_t& len);
+
+    bool asyncRenderLine();
+    bool asyncTransferBusy();
+    void asyncTransferChunk();
+    bool asyncSendLine();
+    void asyncFinishLine();
+    void gridStore(uint8_t col, uint8_t row, uint8_t len, const uint8_t* glyphs,
+                   const uint16_t* foreColors, const uint16_t* backColors, uint8_t colorStep);
 
     void writeCommand(uint8_t cmd);
     void sendCommand(uint8_t commandByte, uint8_t* dataBytes, uint8_t numDataBytes);
     void sendCommand(uint8_t commandByte, const uint8_t* dataBytes = NULL, uint8_t numDataBytes = 0);
 
-    void initSPI(uint32_t freq);
-    
+    class ClockBus; // the panel as seen by TinyTextTuneClock
+
 
 public:
     uint16_t Height() { return _height; }
@@ -79,14 +309,200 @@ public:
     uint16_t Rows()   { return _rows; }
     uint16_t Columns() { return _columns; }
 
-    TinyTextTFT(int8_t _CS, int8_t _DC, int8_t _RST);
-    void Begin();
+    // Panels can share an SPI bus (each with its own CS) or use another SPIClass.
+    TinyTextTFTBus(int8_t _CS, int8_t _DC, int8_t _RST, SPIClass* spi = &SPI);
+    // any bus, a copy of bus is kept
+    TinyTextTFTBus(const Bus& bus, int8_t _RST = -1);
+    // calibrate: finish with Calibrate() (see below)
+    void Begin(bool calibrate = false);
+    // Non-blocking Begin: BeginAsync starts the reset and PollBegin sends the init
+    // commands a few at a time, returning true while it is waiting out the datasheet
+    // minimum delays (about 125ms in all instead of over half a second). Until
+    // PollBegin returns false the drawing calls update the shadow grid (if enabled)
+    // but nothing reaches the panel; once it is ready the whole grid is marked dirty
+    // so the next Flush shows what was drawn meanwhile.
+    void BeginAsync();
+    bool PollBegin();
+    bool IsReady() { return _beginState == TINYTEXT_BEGIN_READY; }
     void SetRotation(uint8_t m);
     void FillScreen(uint16_t color);
+
+    // SPI clock: Begin uses the one set here (24MHz unless set), e.g. one saved from
+    // an earlier Calibrate so it doesn't have to be run at every start.
+    // Calibrate finds the fastest clock this panel and its wiring take: it writes a
+    // line of test pixels at the top left at rising clocks from TINYTEXT_CLOCK_MIN to
+    // maxFreq, reads each back (MISO has to be connected) and keeps the fastest that
+    // passed less marginPercent. Returns the new clock, or 0 if even the slowest
+    // failed, the panel couldn't be read back at TINYTEXT_READ_FREQ or there is no
+    // panel to read (a canvas is set) and the clock is left as it was. It takes a
+    // few ms, run it before drawing the screen.
+    void SetFrequency(uint32_t freq);
+    uint32_t Frequency() { return _frequency; }
+    uint32_t Calibrate(uint32_t maxFreq = 80000000, uint8_t marginPercent = 20);
+
+    // Text is UTF-8. The font covers printable ASCII (but '`'), the degree, plus-minus
+    // and micro signs, arrows, light box drawing lines and block elements, anything
+    // else is drawn as ' '. Box drawing and blocks reach the cell edges so they join
+    // up. DrawChar and Put take a single byte as Latin-1, DrawCode and PutCode any
+    // code point up to U+FFFF.
     void DrawChar(uint8_t col, uint8_t row, char chr, uint16_t foreColor, uint16_t backColor);
+    void DrawCode(uint8_t col, uint8_t row, uint16_t code, uint16_t foreColor, uint16_t backColor);
+
+    // Blank a block of w x h cells with backColor using one address window per
+    // block, the same as drawing spaces but a fraction of the bus traffic.
+    // The Clear.. calls use the console background colour, ClearToEndOfLine
+    // blanks from the cursor to the right edge.
+    void FillCells(uint8_t col, uint8_t row, uint8_t w, uint8_t h, uint16_t backColor);
+    void ClearRect(uint8_t col, uint8_t row, uint8_t w, uint8_t h);
+    void ClearRow(uint8_t row);
+    void ClearToEndOfLine();
+
+    // Draw the len bytes of str starting at (col, row) using a single address window.
+    // The run is clipped at the right edge of the screen.
+    void DrawString(uint8_t col, uint8_t row, const char* str, uint8_t len, uint16_t foreColor, uint16_t backColor);
+    // Same as DrawString but with a fore and back colour for every cell (character).
+    void DrawRun(uint8_t col, uint8_t row, const char* str, const uint16_t* foreColors, const uint16_t* backColors, uint8_t len);
+
+    // Cells as font glyph indexes, for classes that keep their own copy of what is
+    // on the screen (see TinyTextWindow): GlyphIndex is the glyph DrawCode would use
+    // for code (0 for ' '), DecodeUTF8 the code point at str, moving str past it,
+    // and UTF8Length the bytes in a character starting with lead.
+    // DrawGlyphs sends a run with a colour pair per cell in one address window.
+    static uint8_t GlyphIndex(uint16_t code);
+    static uint16_t DecodeUTF8(const char*& str, const char* end);
+    static uint8_t UTF8Length(uint8_t lead);
+    void DrawGlyphs(uint8_t col, uint8_t row, const uint8_t* glyphs, const uint16_t* foreColors, const uint16_t* backColors, uint8_t len);
+
+    // Glyph cache: keeps fully rendered cells (100 bytes each plus 6 bytes of bookkeeping)
+    // for the most recently drawn (glyph, fore, back) combinations within budgetBytes.
+    // Single cells that hit the cache go out as one bulk transfer.
+    bool EnableGlyphCache(uint16_t budgetBytes);
+    void DisableGlyphCache();
+    uint32_t GlyphCacheHits()   { return _glyphHits; }
+    uint32_t GlyphCacheMisses() { return _glyphMisses; }
+
+    // Shadow grid: an in-RAM copy of every cell (~8K). Put and Print only update the
+    // grid and mark cells that actually changed as dirty, Flush sends the dirty cells.
+    // The Draw.. and Fill.. calls keep the grid in step with what they put on the panel.
+    // SetRotation blanks the grid and marks it all dirty.
+    bool EnableGrid();
+    void DisableGrid();
+    bool GridEnabled() { return (_gridGlyphs != NULL) && !_gridConsole; }
+    bool IsDirty() { return _gridAnyDirty && !_gridConsole; }
+    void Put(uint8_t col, uint8_t row, char chr, uint16_t foreColor, uint16_t backColor);
+    void PutCode(uint8_t col, uint8_t row, uint16_t code, uint16_t foreColor, uint16_t backColor);
+    void Print(uint8_t col, uint8_t row, const char* str, uint16_t foreColor, uint16_t backColor);
+    void Print(uint8_t col, uint8_t row, const char* str, size_t len, uint16_t foreColor, uint16_t backColor);
+    void Flush();
+
+    // Non-blocking Flush: dirty runs are rendered a scanline at a time into one of two
+    // line buffers while the other one is going out. Call Poll() from loop() to keep
+    // it moving: each call starts the next scanline (up to 640 bytes) in a transaction
+    // of its own and returns without waiting for it. Where the bus sends on its own
+    // (the ESP8266's 64 byte FIFO, topped up at each call, or the DMA of
+    // TinyTextDMABus on the ESP32) the line is still going out when Poll returns,
+    // IsBusy() is true and its transaction stays open until a later call finds it
+    // gone; a drawing call made meanwhile waits for it first. Elsewhere the line is
+    // written with writeBytes and the bus is free again when Poll returns. Poll
+    // returns false once the flush is complete and the callback has been called.
+    // Use WaitComplete() (or Flush(budgetMicros)) before another device on the bus.
+    // Cells changed during the flush are sent by the next one.
+    bool FlushAsync(TinyTextCallback callback = NULL);
+    bool Poll();
+    bool IsBusy() { return _asyncBusy; }
+    void WaitComplete();
+
+    // Flush a slice at a time: sends scanlines of dirty runs (as FlushAsync) until
+    // budgetMicros is spent, then returns with the bus released. Call it again from
+    // loop() to carry on, it returns false once everything is out. A slice overruns
+    // the budget by at most one scanline (up to 640 bytes). FlushProgress() is 0..100
+    // for the current flush, 100 when idle.
+    bool Flush(uint32_t budgetMicros);
+    uint8_t FlushProgress();
+
+    // Pipelined rendering: runs of cells (DrawString, DrawRun, Flush and the console)
+    // are rendered a scanline at a time into a ring of line buffers (640 bytes each)
+    // and sent from there. On a dual-core ESP32 with threaded set, a task on
+    // the other core sends each line while the next ones are rendered; elsewhere
+    // the lines are sent as the ring fills. The bytes on the bus are the same as
+    // without it, and every call has finished sending when it returns.
+    // GetPipelineStats times each stage: the cells each renders or sends per second.
+    bool EnablePipeline(uint8_t lines = 4, bool threaded = true);
+    void DisablePipeline();
+    bool PipelineEnabled()  { return _pipeline.Active(); }
+    bool PipelineThreaded() { return _pipeline.Threaded(); }
+    const TinyTextPipelineStats& GetPipelineStats() { return _pipeline.GetStats(); }
+    void ResetPipelineStats() { _pipeline.ResetStats(); }
+
+    // Console: writes text at the cursor, wrapping at the right edge and scrolling
+    // the whole screen up a row when the cursor moves past the bottom. In rotations
+    // 0 and 2 the scroll uses the controller's vertical scroll (a few bytes of
+    // commands plus clearing one row) unless the scroll area has been given to part
+    // of the screen, then it is done as in rotations 1 and 3. In rotations 1 and 3
+    // the scroll axis is across the text rows so the scroll is done in software: the
+    // shadow grid is shifted up and only the cells that changed are resent. Without
+    // EnableGrid the console enables a grid of its own on its first write there; it
+    // keeps Put and Print drawing straight away and GridEnabled() false, SetRotation
+    // and DisableGrid free it and EnableGrid makes it the shadow grid. As what was on
+    // the panel before it isn't known, the first scroll resends every cell that
+    // hasn't been drawn since. Where there isn't the RAM for it (e.g. an AVR) the
+    // screen can't scroll there: the cursor returns to the top row and that row is
+    // cleared.
+    // '\n' moves to the start of the next row, '\r' to the start of the current row.
+    // A UTF-8 character split across two writes is drawn once the rest of it arrives.
+    void SetCursor(uint8_t col, uint8_t row);
+    uint8_t CursorColumn() { return _cursorCol; }
+    uint8_t CursorRow()    { return _cursorRow; }
+    void SetConsoleColors(uint16_t foreColor, uint16_t backColor);
+    uint16_t ConsoleForeColor() { return _consoleFore; }
+    uint16_t ConsoleBackColor() { return _consoleBack; }
+    void Write(char chr);
+    void Write(const char* str);
+    void Write(const char* str, size_t len);
+    // true where the console scrolls with the controller's vertical scroll, so
+    // doesn't need a grid to scroll from
+    bool ConsoleHardwareScroll() { return !softScroll(); }
+
+    // Hardware scroll area: in rotations 0 and 2 the controller can scroll a band of
+    // full width rows (rows row .. row + rows - 1) while the rest stays put. The
+    // console uses the whole screen, a TinyTextWindow the rows it scrolls. The area
+    // can only be moved while it isn't scrolled (no rows moved round it, or a whole
+    // turn of them), otherwise SetScrollArea returns false, as it does in rotations
+    // 1 and 3. ScrollAreaUp moves the area up a row and blanks its bottom row with
+    // backColor: a few bytes of commands plus one row of pixels.
+    // SetRotation goes back to the whole screen.
+    bool SetScrollArea(uint8_t row, uint8_t rows);
+    bool ScrollAreaUp(uint16_t backColor);
+    uint8_t ScrollAreaRow()  { return _scrollTop; }
+    uint8_t ScrollAreaRows() { return _scrollRows; }
+
+    // Arduino Print
+    using ::Print::write;
+    virtual size_t write(uint8_t c);
+    virtual size_t write(const uint8_t* buffer, size_t size);
+
+    // Off-screen rendering: while a canvas is set, the commands and pixels meant for
+    // the panel go to the canvas instead and the panel, its pins and the SPI bus are
+    // left alone. The canvas learns the rotation and scroll position from the
+    // commands it receives, so set it before Begin() or call SetRotation() after.
+    // While a canvas is set runs of cells go to it a scanline at a time, from
+    // about 2.7K taken by SetCanvas and given back by SetCanvas(NULL).
+    // PushCanvas sends a canvas frame to the panel in one window, the canvas must
+    // have been drawn in the current rotation.
+    void SetCanvas(TinyTextCanvas* canvas);
+    TinyTextCanvas* GetCanvas() { return _canvas; }
+    void PushCanvas(TinyTextCanvas* canvas);
+
+#ifdef TINYTEXT_STATS
+    const TinyTextStats& GetStats() { return _stats; }
+    void ResetStats();
+#endif
 
     //uint8_t ReadCommand8(uint8_t commandByte, uint8_t index = 0);
 
 };
 
+typedef TinyTextTFTBus<TinyTextPinBus> TinyTextTFT;
+extern template class TinyTextTFTBus<TinyTextPinBus>; // in TinyTextTFT.cpp
+
 #endif
\ No newline at end of file
@@ -0,0 +1,2534 @@
+#ifndef TinyTextTFTImpl_h
+#define TinyTextTFTImpl_h
+
+#include "Arduino.h"
+#include "SPI.h"
+#include "TinyTextTFT.h"
+
+/*
+  I used code from the Adafruit ILI9341 driver and Adafruit_GFX
+  to create this minimalist tiny anti-aliased text driver for
+  ILI9341 320x240 TFT displays.
+  Support Adafruit's work on drivers by purchasing directly from Adafruit:
+    https://www.adafruit.com/category/825
+  Some Adafruit attribution from the original version follows. Obviously
+  this is my hack so any errors are 100% my fault.
+
+     * Adafruit invests time and resources providing this open source code,
+     * please support Adafruit and open-source hardware by purchasing
+     * products from Adafruit!
+     *
+     * Written by Limor "ladyada" Fried for Adafruit Industries.
+     *
+ */
+
+#define SPI_DEFAULT_FREQ 24000000 ///< Default SPI data clock frequency
+
+#define ILI9341_TFTWIDTH 240  // ILI9341 max TFT width
+#define ILI9341_TFTHEIGHT 320 // ILI9341 max TFT height
+
+#define TINYTEXT_MAX_COLUMNS (ILI9341_TFTHEIGHT / 5) // widest run DrawString can stream
+#define TINYTEXT_CELL_BYTES  (5 * 10 * 2) // one rendered RGB565 cell
+#define TINYTEXT_LINE_BYTES  (TINYTEXT_MAX_COLUMNS * 5 * 2) // one scanline of the widest run
+#define TINYTEXT_CANVAS_RUN_BYTES (TINYTEXT_MAX_COLUMNS * 16 * 2 + TINYTEXT_LINE_BYTES) // see writeCanvasRun
+#define TINYTEXT_MAX_CELLS   ((ILI9341_TFTWIDTH / 5) * (ILI9341_TFTHEIGHT / 10)) // same for every rotation
+
+//#define ILI9488_TFTWIDTH  320
+//#define ILI9488_TFTHEIGHT 480
+
+#define ILI9341_SWRESET 0x01 ///< Software reset register
+#define ILI9341_RDMODE 0x0A     ///< Read Display Power Mode
+#define ILI9341_RDMADCTL 0x0B   ///< Read Display MADCTL
+#define ILI9341_RDPIXFMT 0x0C   ///< Read Display Pixel Format
+#define ILI9341_RDIMGFMT 0x0D   ///< Read Display Image Format
+#define ILI9341_RDSELFDIAG 0x0F ///< Read Display Self-Diagnostic Result
+#define ILI9341_SLPOUT 0x11 ///< Sleep Out
+#define ILI9341_DISPON 0x29   ///< Display ON
+#define ILI9341_GAMMASET 0x26 ///< Gamma Set
+#define ILI9341_CASET 0x2A ///< Column Address Set
+#define ILI9341_PASET 0x2B ///< Page Address Set
+#define ILI9341_RAMWR 0x2C ///< Memory Write
+#define ILI9341_RAMRD 0x2E ///< Memory Read
+#define ILI9341_VSCRDEF 0x33  ///< Vertical Scrolling Definition
+#define ILI9341_MADCTL 0x36   ///< Memory Access Control
+#define ILI9341_VSCRSADD 0x37 ///< Vertical Scrolling Start Address
+#define ILI9341_PIXFMT 0x3A   ///< COLMOD: Pixel Format Set
+#define ILI9341_FRMCTR1 0xB1 ///< Frame Rate Control (In Normal Mode/Full Colors)
+#define ILI9341_DFUNCTR 0xB6 ///< Display Function Control
+#define ILI9341_PWCTR1 0xC0 ///< Power Control 1
+#define ILI9341_PWCTR2 0xC1 ///< Power Control 2
+#define ILI9341_VMCTR1 0xC5 ///< VCOM Control 1
+#define ILI9341_VMCTR2 0xC7 ///< VCOM Control 2
+#define ILI9341_GMCTRP1 0xE0 ///< Positive Gamma Correction
+#define ILI9341_GMCTRN1 0xE1 ///< Negative Gamma Correction
+
+#ifdef TINYTEXT_STATS
+#define TINYTEXT_COUNT(field, n) (_stats.field += (n))
+#define TINYTEXT_TIME_START unsigned long statsStart = micros()
+#define TINYTEXT_TIME_END(call) (_stats.calls[call]++, _stats.callMicros[call] += micros() - statsStart)
+#else
+#define TINYTEXT_COUNT(field, n)
+#define TINYTEXT_TIME_START
+#define TINYTEXT_TIME_END(call)
+#endif
+
+// see SetRotation(..)
+#define MADCTL_MY 0x80  ///< Bottom to top
+#define MADCTL_MX 0x40  ///< Right to left
+#define MADCTL_MV 0x20  ///< Reverse Mode
+//#define MADCTL_ML 0x10  ///< LCD refresh Bottom to top
+//#define MADCTL_RGB 0x00 ///< Red-Green-Blue pixel order
+#define MADCTL_BGR 0x08 ///< Blue-Green-Red pixel order
+//#define MADCTL_MH 0x04  ///< LCD refresh right to left
+
+static const uint8_t PROGMEM initcmd[] =
+{
+  0xEF, 3, 0x03, 0x80, 0x02,
+  0xCF, 3, 0x00, 0xC1, 0x30,
+  0xED, 4, 0x64, 0x03, 0x12, 0x81,
+  0xE8, 3, 0x85, 0x00, 0x78,
+  0xCB, 5, 0x39, 0x2C, 0x00, 0x34, 0x02,
+  0xF7, 1, 0x20,
+  0xEA, 2, 0x00, 0x00,
+  ILI9341_PWCTR1  , 1, 0x23,             // Power control VRH[5:0]
+  ILI9341_PWCTR2  , 1, 0x10,             // Power control SAP[2:0];BT[3:0]
+  ILI9341_VMCTR1  , 2, 0x3e, 0x28,       // VCM control
+  ILI9341_VMCTR2  , 1, 0x86,             // VCM control2
+  ILI9341_MADCTL  , 1, 0x48,             // Memory Access Control
+  ILI9341_VSCRDEF , 6, 0x00, 0x00, 0x01, 0x40, 0x00, 0x00, // Vertical scroll area: all 320 lines
+  ILI9341_VSCRSADD, 1, 0x00,             // Vertical scroll zero
+  ILI9341_PIXFMT  , 1, 0x55,
+  ILI9341_FRMCTR1 , 2, 0x00, 0x18,
+  ILI9341_DFUNCTR , 3, 0x08, 0x82, 0x27, // Display Function Control
+  0xF2, 1, 0x00,                         // 3Gamma Function Disable
+  ILI9341_GAMMASET , 1, 0x01,             // Gamma curve selected
+  ILI9341_GMCTRP1 , 15, 0x0F, 0x31, 0x2B, 0x0C, 0x0E, 0x08, 0x4E, 0xF1, 0x37, 0x07, 0x10, 0x03, 0x0E, 0x09, 0x00, // Set Gamma
+  ILI9341_GMCTRN1 , 15, 0x00, 0x0E, 0x14, 0x03, 0x11, 0x07, 0x31, 0xC1, 0x48, 0x08, 0x0F, 0x0C, 0x31, 0x36, 0x0F, // Set Gamma
+  ILI9341_SLPOUT  , 0x80,                // Exit Sleep
+  ILI9341_DISPON  , 0x80,                // Display on
+  0x00                                   // End of list
+};
+
+// 8 rows of 4 tones per glyph (0 = foreground .. F = background), in the order of
+// fontRanges. The top and bottom rows and the right column of a cell are background.
+static const uint16_t PROGMEM tinyFont[][8] =
+{
+    // ' ' 0x20
+    { 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '!' 0x21
+    { 0xFB7F, 0xFB7F, 0xFE7F, 0xFF7F, 0xFFFF, 0xFB5F, 0xFFFF, 0xFFFF} ,
+    // '"' 0x22
+    { 0xF377, 0xF3B7, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '#' 0x23
+    { 0xFFFF, 0xF6D7, 0x3000, 0xF5BB, 0x3000, 0xF77D, 0xFFFF, 0xFFFF} ,
+    // '$' 0x24
+    { 0xFF6F, 0xC103, 0x896F, 0xE61A, 0xFBB1, 0x7006, 0xF7FF, 0xFFFF} ,
+    // '%' 0x25
+    { 0x50D6, 0x4098, 0xFF5F, 0xF8BF, 0xE660, 0x6E50, 0xFFFF, 0xFFFF} ,
+    // '&' 0x26
+    { 0xE10D, 0xB79B, 0xE28F, 0x7882, 0x3E53, 0xA013, 0xFFFF, 0xFFFF} ,
+    // ''' 0x27
+    { 0xFB3F, 0xFB7F, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '(' 0x28
+    { 0xFF8D, 0xFD6F, 0xF6DF, 0xF3FF, 0xF3FF, 0xF5DF, 0xFD6F, 0xFF7D} ,
+    // ')' 0x29
+    { 0xF7EF, 0xFC5F, 0xFF4E, 0xFF7B, 0xFF7B, 0xFF4F, 0xFD6F, 0xF6EF} ,
+    // '*' 0x2A
+    { 0xFF7F, 0xD748, 0xFF7F, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '+' 0x2B
+    { 0xFFFF, 0xFB7F, 0xFB7F, 0x3000, 0xFB7F, 0xFB7F, 0xFFFF, 0xFFFF} ,
+    // ',' 0x2C
+    { 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFC2F, 0xF07F, 0xFFFF} ,
+    // '-' 0x2D
+    { 0xFFFF, 0xFFFF, 0xFFFF, 0xF007, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '.' 0x2E
+    { 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xF95F, 0xFFFF, 0xFFFF} ,
+    // '/' 0x2F
+    { 0xFFE5, 0xFF8C, 0xFF4F, 0xFC8F, 0xF5EF, 0xE6FF, 0x9AFF, 0xFFFF} ,
+    // '0' 0x30
+    { 0xFFFF, 0xE207, 0x7890, 0x7926, 0x74D1, 0xD109, 0xFFFF, 0xFFFF} ,
+    // '1' 0x31
+    { 0xFFFF, 0x903F, 0xFF3F, 0xFF3F, 0xFF3F, 0xB000, 0xFFFF, 0xFFFF} ,
+    // '2' 0x32
+    { 0xFFFF, 0xE20A, 0xBBE4, 0xFF8C, 0xE6CF, 0x7000, 0xFFFF, 0xFFFF} ,
+    // '3' 0x33
+    { 0xFFFF, 0xB00A, 0xFFA7, 0xF30B, 0xFFE3, 0x7019, 0xFFFF, 0xFFFF} ,
+    // '4' 0x34
+    { 0xFFFF, 0xFE27, 0xF597, 0x8BB7, 0x3000, 0xFFB7, 0xFFFF, 0xFFFF} ,
+    // '5' 0x35
+    { 0xFFFF, 0xB007, 0xB7FF, 0xB009, 0xFFD3, 0xB01B, 0xFFFF, 0xFFFF} ,
+    // '6' 0x36
+    { 0xFFFF, 0xF603, 0xA7FF, 0x7505, 0x85F1, 0xD107, 0xFFFF, 0xFFFF} ,
+    // '7' 0x37
+    { 0xFFFF, 0x7000, 0xFFD5, 0xFF5D, 0xFC7F, 0xF4EF, 0xFFFF, 0xFFFF} ,
+    // '8' 0x38
+    { 0xFFFF, 0xD107, 0xB7D5, 0xF20A, 0x87D2, 0xC006, 0xFFFF, 0xFFFF} ,
+    // '9' 0x39
+    { 0xFFFF, 0xC10A, 0x7CC3, 0xA027, 0xFFB4, 0xB03D, 0xFFFF, 0xFFFF} ,
+    // ':' 0x3A
+    { 0xFFFF, 0xFFFF, 0xFB5F, 0xFFFF, 0xFFFF, 0xFB5F, 0xFFFF, 0xFFFF} ,
+    // ';' 0x3B
+    { 0xFFFF, 0xFFFF, 0xF95F, 0xFFFF, 0xFFFF, 0xFC2F, 0xF07F, 0xFFFF} ,
+    // '<' 0x3C
+    { 0xFFFF, 0xFFFF, 0xFF8B, 0xE5BF, 0xE5BF, 0xFF8B, 0xFFFF, 0xFFFF} ,
+    // '=' 0x3D
+    { 0xFFFF, 0xFFFF, 0x7000, 0xFFFF, 0x7000, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '>' 0x3E
+    { 0xFFFF, 0xFFFF, 0xE4DF, 0xFE5A, 0xFE5A, 0xE4DF, 0xFFFF, 0xFFFF} ,
+    // '?' 0x3F
+    { 0xF35E, 0xFF78, 0xFFA7, 0xF70B, 0xFFFF, 0xF79F, 0xFFFF, 0xFFFF} ,
+    // '@' 0x40
+    { 0xF605, 0xB5F6, 0x5A07, 0x6497, 0x736A, 0x5322, 0x5CFF, 0xC00C} ,
+    // 'A' 0x41
+    { 0xFFFF, 0xF96F, 0xF79C, 0xE7E6, 0x9001, 0x5FF7, 0xFFFF, 0xFFFF} ,
+    // 'B' 0x42
+    { 0xFFFF, 0x7008, 0x7BD4, 0x7009, 0x7BF1, 0x7007, 0xFFFF, 0xFFFF} ,
+    // 'C' 0x43
+    { 0xFFFF, 0xE300, 0x87FF, 0x7BFF, 0x77FF, 0xE300, 0xFFFF, 0xFFFF} ,
+    // 'D' 0x44
+    { 0xFFFF, 0x7009, 0x7BD1, 0x7BF3, 0x7BD2, 0x701A, 0xFFFF, 0xFFFF} ,
+    // 'E' 0x45
+    { 0xFFFF, 0xB003, 0xB7FF, 0xB003, 0xB7FF, 0xB003, 0xFFFF, 0xFFFF} ,
+    // 'F' 0x46
+    { 0xFFFF, 0xB003, 0xB7FF, 0xB007, 0xB7FF, 0xB7FF, 0xFFFF, 0xFFFF} ,
+    // 'G' 0x47
+    { 0xFFFF, 0xE300, 0x68FF, 0x3F30, 0x59F3, 0xD301, 0xFFFF, 0xFFFF} ,
+    // 'H' 0x48
+    { 0xFFFF, 0x7BF3, 0x7BF3, 0x7000, 0x7BF3, 0x7BF3, 0xFFFF, 0xFFFF} ,
+    // 'I' 0x49
+    { 0xFFFF, 0xB003, 0xFB7F, 0xFB7F, 0xFB7F, 0xB003, 0xFFFF, 0xFFFF} ,
+    // 'J' 0x4A
+    { 0xFFFF, 0xB007, 0xFFB7, 0xFFB7, 0xFFA7, 0xB01D, 0xFFFF, 0xFFFF} ,
+    // 'K' 0x4B
+    { 0xFFFF, 0x7BC5, 0x7B5E, 0x73CF, 0x7A4F, 0x7BC6, 0xFFFF, 0xFFFF} ,
+    // 'L' 0x4C
+    { 0xFFFF, 0xF3FF, 0xF3FF, 0xF3FF, 0xF3FF, 0xF000, 0xFFFF, 0xFFFF} ,
+    // 'M' 0x4D
+    { 0xFFFF, 0x79E0, 0x68A7, 0x3B97, 0x3FF7, 0x3FF7, 0xFFFF, 0xFFFF} ,
+    // 'N' 0x4E
+    { 0xFFFF, 0x77F3, 0x77F3, 0x7BA3, 0x7BB3, 0x7BC2, 0xFFFF, 0xFFFF} ,
+    // 'O' 0x4F
+    { 0xFFFF, 0xD107, 0x5AE3, 0x3FF7, 0x5CE3, 0xC109, 0xFFFF, 0xFFFF} ,
+    // 'P' 0x50
+    { 0xFFFF, 0x7006, 0x7BF1, 0x7008, 0x7BFF, 0x7BFF, 0xFFFF, 0xFFFF} ,
+    // 'Q' 0x51
+    { 0xFFFF, 0xD106, 0x5AE3, 0x3FF7, 0x5AE3, 0xC107, 0xFF20, 0xFFFF} ,
+    // 'R' 0x52
+    { 0xFFFF, 0xB009, 0xB7D3, 0xB00B, 0xB786, 0xB7F2, 0xFFFF, 0xFFFF} ,
+    // 'S' 0x53
+    { 0xFFFF, 0xC103, 0x88FF, 0xE73B, 0xFFE1, 0x7007, 0xFFFF, 0xFFFF} ,
+    // 'T' 0x54
+    { 0xFFFF, 0x3000, 0xFB7F, 0xFB7F, 0xFB7F, 0xFB7F, 0xFFFF, 0xFFFF} ,
+    // 'U' 0x55
+    { 0xFFFF, 0x7BF3, 0x7BF3, 0x7BF3, 0x7AE1, 0xC007, 0xFFFF, 0xFFFF} ,
+    // 'V' 0x56
+    { 0xFFFF, 0x3FF6, 0x8AF3, 0xD5D6, 0xF38C, 0xF81F, 0xFFFF, 0xFFFF} ,
+    // 'W' 0x57
+    { 0xFFFF, 0x3FF7, 0x3FF7, 0x5D67, 0x7997, 0x77D1, 0xFFFF, 0xFFFF} ,
+    // 'X' 0x58
+    { 0xFFFF, 0x7AE4, 0xF35B, 0xF92F, 0xE35A, 0x6BE2, 0xFFFF, 0xFFFF} ,
+    // 'Y' 0x59
+    { 0xFFFF, 0x5DF5, 0xD4B7, 0xF83F, 0xFB7F, 0xFB7F, 0xFFFF, 0xFFFF} ,
+    // 'Z' 0x5A
+    { 0xFFFF, 0x7002, 0xFFCC, 0xFE9F, 0xF8FF, 0x9000, 0xFFFF, 0xFFFF} ,
+    // '[' 0x5B
+    { 0xF30B, 0xF3FF, 0xF3FF, 0xF3FF, 0xF3FF, 0xF3FF, 0xF3FF, 0xF30B} ,
+    // '\' 0x5C
+    { 0xC8FF, 0xF4FF, 0xF9BF, 0xFE5F, 0xFF6E, 0xFFB9, 0xFFF5, 0xFFFF} ,
+    // ']' 0x5D
+    { 0xF00F, 0xFF3F, 0xFF3F, 0xFF3F, 0xFF3F, 0xFF3F, 0xFF3F, 0xF00F} ,
+    // '^' 0x5E
+    { 0xFFFF, 0xF94F, 0xF69B, 0xB9E4, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '_' 0x5F
+    { 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x0000} ,
+    // 'a' 0x61
+    { 0xFFFF, 0xFFFF, 0xB008, 0xD103, 0x79D3, 0xB025, 0xFFFF, 0xFFFF} ,
+    // 'b' 0x62
+    { 0x7BFF, 0x7BFF, 0x7306, 0x77F2, 0x7BE2, 0x9009, 0xFFFF, 0xFFFF} ,
+    // 'c' 0x63
+    { 0xFFFF, 0xFFFF, 0xF403, 0xB6FF, 0xB7FF, 0xE303, 0xFFFF, 0xFFFF} ,
+    // 'd' 0x64
+    { 0xFFF3, 0xFFF3, 0xE203, 0x79F3, 0x7AC3, 0xC036, 0xFFFF, 0xFFFF} ,
+    // 'e' 0x65
+    { 0xFFFF, 0xFFFF, 0xE207, 0x7000, 0x79FF, 0xD103, 0xFFFF, 0xFFFF} ,
+    // 'f' 0x66
+    { 0xFD10, 0xF7AF, 0x3003, 0xF7BF, 0xF7BF, 0xF7BF, 0xFFFF, 0xFFFF} ,
+    // 'g' 0x67
+    { 0xFFFF, 0xFFFF, 0xE100, 0xB9D3, 0xC009, 0x9002, 0x7AF2, 0xA006} ,
+    // 'h' 0x68
+    { 0x7BFF, 0x7BFF, 0x7306, 0x75F3, 0x7BF3, 0x7BF3, 0xFFFF, 0xFFFF} ,
+    // 'i' 0x69
+    { 0xFB5F, 0xFFFF, 0xB03F, 0xFF3F, 0xFF3F, 0xB003, 0xFFFF, 0xFFFF} ,
+    // 'j' 0x6A
+    { 0xFF59, 0xFFFF, 0xB00B, 0xFF7B, 0xFF7B, 0xFF7B, 0xFF6B, 0x703F} ,
+    // 'k' 0x6B
+    { 0xB7FF, 0xB7FF, 0xB795, 0xB26F, 0xB64E, 0xB7C4, 0xFFFF, 0xFFFF} ,
+    // 'l' 0x6C
+    { 0xB03F, 0xFF3F, 0xFF3F, 0xFF3F, 0xFF3F, 0xB003, 0xFFFF, 0xFFFF} ,
+    // 'm' 0x6D
+    { 0xFFFF, 0xFFFF, 0x3230, 0x3B27, 0x3F37, 0x3F37, 0xFFFF, 0xFFFF} ,
+    // 'n' 0x6E
+    { 0xFFFF, 0xFFFF, 0x7306, 0x75F3, 0x7BF3, 0x7BF3, 0xFFFF, 0xFFFF} ,
+    // 'o' 0x6F
+    { 0xFFFF, 0xFFFF, 0xD107, 0x7CE2, 0x7CE2, 0xC109, 0xFFFF, 0xFFFF} ,
+    // 'p' 0x70
+    { 0xFFFF, 0xFFFF, 0x7306, 0x77F2, 0x7BE2, 0x7009, 0x7BFF, 0x7BFF} ,
+    // 'q' 0x71
+    { 0xFFFF, 0xFFFF, 0xE203, 0x79F3, 0x7AC3, 0xC023, 0xFFF3, 0xFFF3} ,
+    // 'r' 0x72
+    { 0xFFFF, 0xFFFF, 0xB404, 0xB2E2, 0xB7FF, 0xB7FF, 0xFFFF, 0xFFFF} ,
+    // 's' 0x73
+    { 0xFFFF, 0xFFFF, 0xE207, 0xD3AF, 0xFE94, 0xB008, 0xFFFF, 0xFFFF} ,
+    // 't' 0x74
+    { 0xFFFF, 0xF4FF, 0x3003, 0xF3FF, 0xF3EF, 0xFA03, 0xFFFF, 0xFFFF} ,
+    // 'u' 0x75
+    { 0xFFFF, 0xFFFF, 0x7BF3, 0x7BF3, 0x99C3, 0xD015, 0xFFFF, 0xFFFF} ,
+    // 'v' 0x76
+    { 0xFFFF, 0xFFFF, 0x6CF5, 0xD7E6, 0xF69C, 0xF97F, 0xFFFF, 0xFFFF} ,
+    // 'w' 0x77
+    { 0xFFFF, 0xFFFF, 0x5FF7, 0x5D67, 0x7A96, 0xA5C4, 0xFFFF, 0xFFFF} ,
+    // 'x' 0x78
+    { 0xFFFF, 0xFFFF, 0xB7E4, 0xF75E, 0xF77D, 0xA7E3, 0xFFFF, 0xFFFF} ,
+    // 'y' 0x79
+    { 0xFFFF, 0xFFFF, 0x7CF4, 0xD6D7, 0xF68D, 0xFA5F, 0xF89F, 0x33FF} ,
+    // 'z' 0x7A
+    { 0xFFFF, 0xFFFF, 0xB006, 0xFF8F, 0xFCEF, 0xA003, 0xFFFF, 0xFFFF} ,
+    // '{' 0x7B
+    { 0xFE17, 0xFB6F, 0xFA9F, 0x70DF, 0xFAAF, 0xFB7F, 0xFB6F, 0xFE27} ,
+    // '|' 0x7C
+    { 0xFB7F, 0xFB7F, 0xFB7F, 0xFB7F, 0xFB7F, 0xFB7F, 0xFB7F, 0xFB7F} ,
+    // '} ,' 0x7D
+    { 0xB09F, 0xFE3F, 0xFF2F, 0xFF53, 0xFF3F, 0xFF3F, 0xFE3F, 0xB0AF} ,
+    // '~' 0x7E
+    { 0xFFFF, 0xFFFF, 0xFFFF, 0xA096, 0x3E22, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '°' U+00B0
+    { 0xF66F, 0x6FF6, 0xF66F, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '±' U+00B1
+    { 0xFFFF, 0xFB7F, 0x3000, 0xFB7F, 0xFFFF, 0x3000, 0xFFFF, 0xFFFF} ,
+    // 'µ' U+00B5
+    { 0xFFFF, 0xFFFF, 0x7BF3, 0x7BF3, 0x99C3, 0x5015, 0x7FFF, 0x7FFF} ,
+    // '←' U+2190
+    { 0xFFFF, 0xFFFF, 0xF8FF, 0x0000, 0xF8FF, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '↑' U+2191
+    { 0xFFFF, 0xF0FF, 0x808F, 0xF0FF, 0xF0FF, 0xF0FF, 0xFFFF, 0xFFFF} ,
+    // '→' U+2192
+    { 0xFFFF, 0xFFFF, 0xFF8F, 0x0000, 0xFF8F, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '↓' U+2193
+    { 0xFFFF, 0xF0FF, 0xF0FF, 0xF0FF, 0x808F, 0xF0FF, 0xFFFF, 0xFFFF} ,
+    // '─' U+2500, box drawing and blocks reach the cell edges
+    { 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x0000, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '│' U+2502
+    { 0xFF0F, 0xFF0F, 0xFF0F, 0xFF0F, 0xFF0F, 0xFF0F, 0xFF0F, 0xFF0F} ,
+    // '┌' U+250C
+    { 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFF00, 0xFF0F, 0xFF0F, 0xFF0F} ,
+    // '┐' U+2510
+    { 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x000F, 0xFF0F, 0xFF0F, 0xFF0F} ,
+    // '└' U+2514
+    { 0xFF0F, 0xFF0F, 0xFF0F, 0xFF0F, 0xFF00, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '┘' U+2518
+    { 0xFF0F, 0xFF0F, 0xFF0F, 0xFF0F, 0x000F, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '├' U+251C
+    { 0xFF0F, 0xFF0F, 0xFF0F, 0xFF0F, 0xFF00, 0xFF0F, 0xFF0F, 0xFF0F} ,
+    // '┤' U+2524
+    { 0xFF0F, 0xFF0F, 0xFF0F, 0xFF0F, 0x000F, 0xFF0F, 0xFF0F, 0xFF0F} ,
+    // '┬' U+252C
+    { 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x0000, 0xFF0F, 0xFF0F, 0xFF0F} ,
+    // '┴' U+2534
+    { 0xFF0F, 0xFF0F, 0xFF0F, 0xFF0F, 0x0000, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '┼' U+253C
+    { 0xFF0F, 0xFF0F, 0xFF0F, 0xFF0F, 0x0000, 0xFF0F, 0xFF0F, 0xFF0F} ,
+    // '▀' U+2580
+    { 0x0000, 0x0000, 0x0000, 0x0000, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF} ,
+    // '▄' U+2584
+    { 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x0000, 0x0000, 0x0000, 0x0000} ,
+    // '█' U+2588
+    { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000} ,
+    // '▌' U+258C
+    { 0x07FF, 0x07FF, 0x07FF, 0x07FF, 0x07FF, 0x07FF, 0x07FF, 0x07FF} ,
+    // '▐' U+2590
+    { 0xFF70, 0xFF70, 0xFF70, 0xFF70, 0xFF70, 0xFF70, 0xFF70, 0xFF70} ,
+    // '░' U+2591
+    { 0xAAAA, 0xAAAA, 0xAAAA, 0xAAAA, 0xAAAA, 0xAAAA, 0xAAAA, 0xAAAA} ,
+    // '▒' U+2592
+    { 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666} ,
+    // '▓' U+2593
+    { 0x2222, 0x2222, 0x2222, 0x2222, 0x2222, 0x2222, 0x2222, 0x2222}
+};
+
+// Code points covered by tinyFont, sorted: glyphs are stored for the covered
+// codes only so gaps cost no flash, and finding a glyph needs no RAM table.
+struct TinyFontRange
+{
+    uint16_t first; // first code point
+    uint8_t  count; // code points in the range
+    uint8_t  glyph; // tinyFont index of first
+};
+
+static constexpr TinyFontRange PROGMEM fontRanges[] =
+{
+    { 0x20, 0x40, 0 },      // ' ' .. '_'
+    { 0x61, 0x1E, 0x40 },   // 'a' .. '~' (no '`')
+    { 0xB0, 0x02, 0x5E },   // degree, plus-minus
+    { 0xB5, 0x01, 0x60 },   // micro
+    { 0x2190, 0x04, 0x61 }, // arrows left, up, right, down
+    { 0x2500, 0x01, 0x65 }, // box drawing, light lines
+    { 0x2502, 0x01, 0x66 },
+    { 0x250C, 0x01, 0x67 },
+    { 0x2510, 0x01, 0x68 },
+    { 0x2514, 0x01, 0x69 },
+    { 0x2518, 0x01, 0x6A },
+    { 0x251C, 0x01, 0x6B },
+    { 0x2524, 0x01, 0x6C },
+    { 0x252C, 0x01, 0x6D },
+    { 0x2534, 0x01, 0x6E },
+    { 0x253C, 0x01, 0x6F },
+    { 0x2580, 0x01, 0x70 }, // blocks
+    { 0x2584, 0x01, 0x71 },
+    { 0x2588, 0x01, 0x72 },
+    { 0x258C, 0x01, 0x73 },
+    { 0x2590, 0x04, 0x74 }, // right half, light, medium and dark shade
+};
+
+#define FONT_RANGES (sizeof(fontRanges) / sizeof(fontRanges[0]))
+
+// the ranges must describe tinyFont exactly, checked when compiling
+static constexpr bool fontRangesValid(uint8_t i, uint8_t glyph)
+{
+    return (i == FONT_RANGES) ? (glyph == sizeof(tinyFont) / sizeof(tinyFont[0])) :
+           (fontRanges[i].glyph == glyph) && ((i == 0) || (fontRanges[i].first >= fontRanges[i - 1].first + fontRanges[i - 1].count)) &&
+           fontRangesValid(i + 1, glyph + fontRanges[i].count);
+}
+static_assert(fontRangesValid(0, 0), "fontRanges doesn't match tinyFont");
+static_assert(fontRanges[0].first == 0x20, "glyph 0 must be ' '");
+static_assert(sizeof(tinyFont) / sizeof(tinyFont[0]) <= 256, "glyph indexes are 8 bits");
+
+static constexpr uint8_t fontGlyph(uint16_t code, uint8_t i = 0)
+{
+    return (i == FONT_RANGES) ? 0 :
+           ((code >= fontRanges[i].first) && (code - fontRanges[i].first < fontRanges[i].count)) ? fontRanges[i].glyph + (code - fontRanges[i].first) :
+           fontGlyph(code, i + 1);
+}
+
+// Glyphs from here on (box drawing and blocks) fill the cell to its edges so they
+// join up with their neighbours: the top and bottom scanlines repeat the tone
+// rows next to them and the right column repeats the column next to it.
+static constexpr uint8_t fontEdgeGlyph = fontGlyph(0x2500);
+static_assert(fontEdgeGlyph != 0, "U+2500 is missing from tinyFont");
+
+// Finding a glyph without a search: printable ASCII indexes FontTable::ascii
+// directly. Above it a code point's page (its top 8 bits) picks a row of
+// FontTable::pageRows, an entry for each 16 code point block of the page, and
+// a block with glyphs in it has a row of FontTable::blockRows, a glyph index
+// for each code point. Pages and blocks without glyphs share row 0, all ' '.
+// The tables are built from fontRanges when compiling, about 340 bytes of flash.
+static constexpr uint16_t FONT_PAGES = ((fontRanges[FONT_RANGES - 1].first + fontRanges[FONT_RANGES - 1].count - 1) >> 8) + 1;
+static_assert(FONT_PAGES <= 256, "code points are 16 bits");
+
+// 0, 1, .. N - 1 as a parameter pack, to fill the tables
+template <uint16_t... I> struct FontSeq { };
+template <uint16_t N, uint16_t... I> struct FontMakeSeq : FontMakeSeq<N - 1, N - 1, I...> { };
+template <uint16_t... I> struct FontMakeSeq<0, I...> { typedef FontSeq<I...> Type; };
+
+static constexpr bool fontBlockUsed(uint16_t block, uint8_t i = 0)
+{
+    // any range with glyphs in the block, past ASCII
+    return (i < FONT_RANGES) && ((((block << 4) + 15 >= 0x80) && (fontRanges[i].first < (block << 4) + 16) &&
+                                  (fontRanges[i].first + fontRanges[i].count > (block << 4))) || fontBlockUsed(block, i + 1));
+}
+
+static constexpr uint8_t fontBlocksIn(uint16_t page, uint8_t blocks = 16)
+{
+    // blocks with glyphs among the first blocks of page
+    return (blocks == 0) ? 0 : fontBlocksIn(page, blocks - 1) + fontBlockUsed((page << 4) | (blocks - 1));
+}
+
+// blocks with glyphs in each page, worked out once for the functions below
+template <class Pages> struct FontPageBlocks;
+template <uint16_t... P> struct FontPageBlocks<FontSeq<P...> >
+{
+    static constexpr uint8_t count[] = { fontBlocksIn(P)... };
+};
+typedef FontPageBlocks<FontMakeSeq<FONT_PAGES>::Type> FontPages;
+
+static constexpr uint8_t fontBlocksBefore(uint16_t page)
+{
+    // blocks with glyphs in the pages before page
+    return (page == 0) ? 0 : fontBlocksBefore(page - 1) + FontPages::count[page - 1];
+}
+
+static constexpr uint8_t fontPagesBefore(uint16_t page)
+{
+    // pages with glyphs before page
+    return (page == 0) ? 0 : fontPagesBefore(page - 1) + (FontPages::count[page - 1] != 0);
+}
+
+static constexpr uint8_t fontPageRow(uint16_t page)
+{
+    return (FontPages::count[page] == 0) ? 0 : fontPagesBefore(page) + 1;
+}
+
+static constexpr uint16_t fontRowPage(uint8_t row, uint16_t page = 0, uint8_t before = 0)
+{
+    // the page given row of FontTable::pageRows, before counting the pages with
+    // glyphs skipped
+    return (page == FONT_PAGES - 1) || ((FontPages::count[page] != 0) && (before + 1 == row)) ? page :
+           fontRowPage(row, page + 1, before + (FontPages::count[page] != 0));
+}
+
+static constexpr uint8_t fontBlockRow(uint16_t block)
+{
+    return fontBlockUsed(block) ? fontBlocksBefore(block >> 4) + fontBlocksIn(block >> 4, block & 15) + 1 : 0;
+}
+
+static constexpr uint16_t fontRowBlock(uint8_t row, uint16_t page = 0, uint8_t i = 0, uint8_t before = 0)
+{
+    // the block given row of FontTable::blockRows: its page, then the block in
+    // it, before counting the blocks with glyphs skipped
+    return (i == 0) && (before + FontPages::count[page] < row) && (page < FONT_PAGES - 1) ? fontRowBlock(row, page + 1, 0, before + FontPages::count[page]) :
+           (i == 15) || (fontBlockUsed((page << 4) | i) && (before + 1 == row)) ? ((page << 4) | i) :
+           fontRowBlock(row, page, i + 1, before + fontBlockUsed((page << 4) | i));
+}
+
+static constexpr uint8_t FONT_PAGE_ROWS = fontPagesBefore(FONT_PAGES) + 1;
+static constexpr uint8_t FONT_BLOCK_ROWS = fontBlocksBefore(FONT_PAGES) + 1;
+
+template <class Ascii, class Pages, class PageRows, class BlockRows> struct FontTables;
+template <uint16_t... A, uint16_t... P, uint16_t... R, uint16_t... B>
+struct FontTables<FontSeq<A...>, FontSeq<P...>, FontSeq<R...>, FontSeq<B...> >
+{
+    static constexpr uint8_t PROGMEM ascii[] = { fontGlyph(0x20 + A)... };
+    static constexpr uint8_t PROGMEM pages[] = { fontPageRow(P)... };
+    static constexpr uint8_t PROGMEM pageRows[] = { (uint8_t)((R < 16) ? 0 : fontBlockRow((fontRowPage(R >> 4) << 4) | (R & 15)))... };
+    static constexpr uint8_t PROGMEM blockRows[] = { (uint8_t)((B < 16) ? 0 : fontGlyph((fontRowBlock(B >> 4) << 4) | (B & 15)))... };
+};
+template <uint16_t... A, uint16_t... P, uint16_t... R, uint16_t... B>
+constexpr uint8_t FontTables<FontSeq<A...>, FontSeq<P...>, FontSeq<R...>, FontSeq<B...> >::ascii[];
+template <uint16_t... A, uint16_t... P, uint16_t... R, uint16_t... B>
+constexpr uint8_t FontTables<FontSeq<A...>, FontSeq<P...>, FontSeq<R...>, FontSeq<B...> >::pages[];
+template <uint16_t... A, uint16_t... P, uint16_t... R, uint16_t... B>
+constexpr uint8_t FontTables<FontSeq<A...>, FontSeq<P...>, FontSeq<R...>, FontSeq<B...> >::pageRows[];
+template <uint16_t... A, uint16_t... P, uint16_t... R, uint16_t... B>
+constexpr uint8_t FontTables<FontSeq<A...>, FontSeq<P...>, FontSeq<R...>, FontSeq<B...> >::blockRows[];
+
+typedef FontTables<FontMakeSeq<0x7F - 0x20>::Type, FontMakeSeq<FONT_PAGES>::Type,
+                   FontMakeSeq<FONT_PAGE_ROWS * 16>::Type, FontMakeSeq<FONT_BLOCK_ROWS * 16>::Type> FontTable;
+
+static_assert(FontTable::blockRows[(FontTable::pageRows[(FontTable::pages[0x25] << 4) | 0x0] << 4) | 0x0] == fontEdgeGlyph &&
+              FontTable::blockRows[(FontTable::pageRows[(FontTable::pages[0x25] << 4) | 0x9] << 4) | 0x3] == fontGlyph(0x2593) &&
+              FontTable::blockRows[(FontTable::pageRows[(FontTable::pages[0x00] << 4) | 0xB] << 4) | 0x5] == fontGlyph(0xB5),
+              "font page tables don't match fontRanges");
+
+static uint8_t fontIndex(uint16_t code)
+{
+    // glyph for a code point, 0 (' ') if it is missing from the font
+    if ((uint16_t)(code - 0x20) < sizeof(FontTable::ascii))
+    {
+        return pgm_read_byte(&FontTable::ascii[code - 0x20]);
+    }
+    if ((code >> 8) >= FONT_PAGES)
+    {
+        return 0;
+    }
+    uint8_t pageRow = pgm_read_byte(&FontTable::pages[code >> 8]);
+    uint8_t blockRow = pgm_read_byte(&FontTable::pageRows[(pageRow << 4) | ((code >> 4) & 15)]);
+    return pgm_read_byte(&FontTable::blockRows[(blockRow << 4) | (code & 15)]);
+}
+
+static uint8_t fontToneRow(uint8_t y)
+{
+    // tone row for scanline y of an edge glyph (scanlines 1..8 of the others)
+    return (y == 0) ? 0 : ((y == 9) ? 7 : y - 1);
+}
+
+static uint8_t utf8Length(uint8_t lead)
+{
+    // bytes in the UTF-8 sequence starting with lead, 1 for a stray byte
+    if (lead < 0xC0)
+    {
+        return 1;
+    }
+    return (lead < 0xE0) ? 2 : ((lead < 0xF0) ? 3 : ((lead < 0xF8) ? 4 : 1));
+}
+
+static uint16_t utf8Decode(const char*& str, const char* end)
+{
+    // the code point at str, moving str past it. Malformed sequences and code
+    // points beyond U+FFFF come back as U+FFFD (drawn as ' ')
+    uint8_t lead = *str++;
+    uint8_t len = utf8Length(lead);
+    if (lead < 0x80)
+    {
+        return lead;
+    }
+    if ((len == 1) || (end - str < len - 1))
+    {
+        return 0xFFFD;
+    }
+    uint32_t code = lead & (0x7F >> len);
+    for (uint8_t i = 1; i < len; i++)
+    {
+        uint8_t next = *str;
+        if ((next & 0xC0) != 0x80)
+        {
+            return 0xFFFD; // next starts the following character
+        }
+        code = (code << 6) | (next & 0x3F);
+        str++;
+    }
+    return (code > 0xFFFF) ? 0xFFFD : code;
+}
+
+static uint8_t utf8Glyphs(const char* str, uint8_t len, uint8_t* glyphs)
+{
+    // font indexes of the UTF-8 text, returns the number of cells (up to TINYTEXT_MAX_COLUMNS)
+    const char* end = str + len;
+    uint8_t cells = 0;
+    while ((str < end) && (cells < TINYTEXT_MAX_COLUMNS))
+    {
+        uint8_t c = *str;
+        if (c < 0x80)
+        {
+            glyphs[cells++] = fontIndex(c); // if it is missing from the font, index will be 0 (' ')
+            str++;
+        }
+        else
+        {
+            glyphs[cells++] = fontIndex(utf8Decode(str, end));
+        }
+    }
+    return cells;
+}
+
+template <class Bus>
+TinyTextTFTBus<Bus>::TinyTextTFTBus(int8_t _CS, int8_t _DC, int8_t _RST, SPIClass* spi) : _bus(_CS, _DC, spi)
+{
+    init(_RST);
+}
+
+template <class Bus>
+TinyTextTFTBus<Bus>::TinyTextTFTBus(const Bus& bus, int8_t _RST) : _bus(bus)
+{
+    init(_RST);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::init(int8_t rst)
+{
+    _frequency = SPI_DEFAULT_FREQ;
+    _width = ILI9341_TFTWIDTH;
+    _height = ILI9341_TFTHEIGHT;
+    _rotation = 0;
+    _rst = rst;
+    _canvas = NULL;
+    _canvasRun = NULL;
+    _offline = false;
+    _beginState = TINYTEXT_BEGIN_READY;
+    _madctl = MADCTL_MX | MADCTL_BGR; // as initcmd
+
+    _cellWidth = 5;
+    _cellHeight = 10;
+
+    invalidateWindow();
+
+    _rows    = _height / _cellHeight;
+    _columns = _width / _cellWidth;
+
+    _glyphImages = NULL;
+    _glyphKeys = NULL;
+    _glyphUsed = NULL;
+    _glyphEntries = 0;
+    _glyphClock = 0;
+    _glyphHits = 0;
+    _glyphMisses = 0;
+
+    _gridGlyphs = NULL;
+    _gridFore = NULL;
+    _gridBack = NULL;
+    _gridDirty = NULL;
+    _gridAnyDirty = false;
+    _gridConsole = false;
+
+#ifdef TINYTEXT_STATS
+    ResetStats();
+#endif
+
+    _asyncBuffers[0] = NULL;
+    _asyncBuffers[1] = NULL;
+    _asyncSize[0] = 0;
+    _asyncSize[1] = 0;
+    _asyncSending = -1;
+    _asyncNext = -1;
+    _asyncBusy = false;
+    _asyncCallback = NULL;
+    _asyncTotal = 0;
+    _asyncDone = 0;
+
+    _scrollRow = 0;
+    _scrollTop = 0;
+    _scrollRows = _rows;
+    _cursorCol = 0;
+    _cursorRow = 0;
+    _utf8.Clear();
+    _consoleFore = RGB444_WHITE;
+    _consoleBack = RGB444_BLACK;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::startWrite(void)
+{
+    asyncFinishLine(); // a line of FlushAsync may still be going out
+    _pipeline.Drain();
+    TINYTEXT_COUNT(transactions, 1);
+    if (_offline)
+    {
+        return; // the panel is left alone
+    }
+    TINYTEXT_COUNT(csToggles, 1);
+    _bus.BeginTransaction();
+}
+template <class Bus>
+void TinyTextTFTBus<Bus>::endWrite(void)
+{
+    _pipeline.Drain(); // the lines still in the ring are part of this transaction
+    if (_offline)
+    {
+        return;
+    }
+    TINYTEXT_COUNT(csToggles, 1);
+    _bus.EndTransaction();
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::spiWrite(uint8_t b)
+{
+    TINYTEXT_COUNT(dataBytes, 1);
+    if (_offline)
+    {
+        if (_canvas != NULL)
+        {
+            _canvas->Data(b);
+        }
+        return;
+    }
+    _bus.Write(b);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::spiWrite16(uint16_t w)
+{
+    TINYTEXT_COUNT(dataBytes, 2);
+    if (_offline)
+    {
+        if (_canvas != NULL)
+        {
+            _canvas->Data(w >> 8);
+            _canvas->Data(w);
+        }
+        return;
+    }
+    _bus.Write16(w);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::spiWriteColor16(uint16_t color)
+{
+    // color is already byte swapped
+    TINYTEXT_COUNT(dataBytes, 2);
+    if (_offline)
+    {
+        if (_canvas != NULL)
+        {
+            uint8_t bytes[2] = { (uint8_t)color, (uint8_t)(color >> 8) };
+            _canvas->Data(bytes, 2);
+        }
+        return;
+    }
+    _bus.WriteColor16(color);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::spiWriteColor32(uint32_t color)
+{
+    // two byte swapped colours, see makeColor32
+    TINYTEXT_COUNT(dataBytes, 4);
+    if (_offline)
+    {
+        if (_canvas != NULL)
+        {
+            uint8_t bytes[4] = { (uint8_t)color, (uint8_t)(color >> 8), (uint8_t)(color >> 16), (uint8_t)(color >> 24) };
+            _canvas->Data(bytes, 4);
+        }
+        return;
+    }
+    _bus.WriteColor32(color);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::spiWriteBytes(const uint8_t* data, uint32_t len)
+{
+    TINYTEXT_COUNT(dataBytes, len);
+    if (_offline)
+    {
+        if (_canvas != NULL)
+        {
+            _canvas->Data(data, len);
+        }
+        return;
+    }
+    _bus.WriteBytes(data, len);
+}
+
+#ifdef TINYTEXT_SPI_PATTERN
+template <class Bus>
+void TinyTextTFTBus<Bus>::spiWritePattern(const uint8_t* data, uint8_t size, uint32_t repeat)
+{
+    TINYTEXT_COUNT(dataBytes, (uint32_t)size * repeat);
+    if (_offline)
+    {
+        if (_canvas != NULL)
+        {
+            while (repeat--)
+            {
+                _canvas->Data(data, size);
+            }
+        }
+        return;
+    }
+    _bus.WritePattern(data, size, repeat);
+}
+#endif
+
+template <class Bus>
+uint8_t TinyTextTFTBus<Bus>::spiRead(void)
+{
+    if (_offline)
+    {
+        return 0;
+    }
+    return _bus.Read();
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::writeCommand(uint8_t cmd)
+{
+    TINYTEXT_COUNT(commandBytes, 1);
+    if (_offline)
+    {
+        if (_canvas != NULL)
+        {
+            _canvas->Command(cmd);
+        }
+        return;
+    }
+    TINYTEXT_COUNT(dcToggles, 2);
+    _bus.Command(cmd);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::sendCommand(uint8_t commandByte, uint8_t* dataBytes, uint8_t numDataBytes)
+{
+    startWrite();
+
+    writeCommand(commandByte); // Send the command byte, back in data mode
+
+    for (int i = 0; i < numDataBytes; i++)
+    {
+        spiWrite(*dataBytes); // Send the data bytes
+        dataBytes++;
+    }
+
+    endWrite();
+}
+template <class Bus>
+void TinyTextTFTBus<Bus>::sendCommand(uint8_t commandByte, const uint8_t* dataBytes, uint8_t numDataBytes)
+{
+    startWrite();
+
+    writeCommand(commandByte); // Send the command byte, back in data mode
+
+    for (int i = 0; i < numDataBytes; i++)
+    {
+        spiWrite(pgm_read_byte(dataBytes++));
+    }
+    endWrite();
+}
+/*
+uint8_t TinyTextTFTBus<Bus>::ReadCommand8(uint8_t commandByte, uint8_t index)
+{
+    uint8_t data = 0x10 + index;
+    sendCommand(0xD9, &data, 1); // Set Index Register
+    uint8_t result;
+    startWrite();
+    writeCommand(commandByte);
+    do
+    {
+        result = spiRead();
+    }
+    while (index--); // Discard bytes up to index'th
+    endWrite();
+    return result;
+}
+*/
+
+template <class Bus>
+class TinyTextTFTBus<Bus>::ClockBus : public TinyTextClockBus
+{
+private:
+    TinyTextTFTBus* _tft;
+
+public:
+    ClockBus(TinyTextTFTBus* tft) { _tft = tft; }
+
+    virtual void SetFrequency(uint32_t freq)
+    {
+        _tft->_bus.SetFrequency(freq); // from the next transaction
+    }
+
+    virtual void Write(uint8_t command, const uint8_t* data, uint16_t len)
+    {
+        _tft->startWrite();
+        _tft->writeCommand(command);
+        _tft->spiWriteBytes(data, len);
+        _tft->endWrite();
+    }
+
+    virtual void Read(uint8_t command, uint8_t* data, uint16_t len)
+    {
+        _tft->startWrite();
+        _tft->writeCommand(command);
+        while (len--)
+        {
+            *data++ = _tft->spiRead();
+        }
+        _tft->endWrite();
+    }
+};
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::SetFrequency(uint32_t freq)
+{
+    WaitComplete();
+    _frequency = freq;
+    _bus.SetFrequency(freq);
+}
+
+template <class Bus>
+uint32_t TinyTextTFTBus<Bus>::Calibrate(uint32_t maxFreq, uint8_t marginPercent)
+{
+    if (_offline)
+    {
+        return 0; // nothing to read back
+    }
+    WaitComplete();
+    ClockBus bus(this);
+    uint32_t freq = TinyTextTuneClock(bus, TINYTEXT_CLOCK_MIN, maxFreq, TINYTEXT_READ_FREQ, marginPercent);
+    invalidateWindow(); // the test pixels had a window of their own
+    SetFrequency((freq != 0) ? freq : _frequency);
+    return freq;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::invalidateWindow()
+{
+    // the next setAddrWindow sends both CASET and PASET
+    _windowX1 = 0xffff;
+    _windowX2 = 0xffff;
+    _windowY1 = 0xffff;
+    _windowY2 = 0xffff;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::setAddrWindow(uint16_t x1, uint16_t y1, uint16_t w, uint16_t h)
+{
+    _pipeline.Drain(); // the pipeline's lines go out first
+    writeAddrWindow(x1, y1, w, h);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::writeAddrWindow(uint16_t x1, uint16_t y1, uint16_t w, uint16_t h)
+{
+    uint16_t x2 = (x1 + w - 1), y2 = (y1 + h - 1);
+    if (x1 != _windowX1 || x2 != _windowX2)
+    {
+        TINYTEXT_COUNT(columnSets, 1);
+        writeCommand(ILI9341_CASET); // Column address set
+        spiWrite16(x1);
+        spiWrite16(x2);
+        _windowX1 = x1;
+        _windowX2 = x2;
+    }
+    else
+    {
+        TINYTEXT_COUNT(columnSkips, 1);
+    }
+    if (y1 != _windowY1 || y2 != _windowY2)
+    {
+        TINYTEXT_COUNT(pageSets, 1);
+        writeCommand(ILI9341_PASET); // Row address set
+        spiWrite16(y1);
+        spiWrite16(y2);
+        _windowY1 = y1;
+        _windowY2 = y2;
+    }
+    else
+    {
+        TINYTEXT_COUNT(pageSkips, 1);
+    }
+    writeCommand(ILI9341_RAMWR); // Write to RAM
+}
+/*
+void TinyTextTFTBus<Bus>::writePixel(int16_t x, int16_t y, uint16_t color)
+{
+    // Clip first...
+    if ((x >= 0) && (x < _width) && (y >= 0) && (y < _height))
+    {
+        // THEN set up transaction (if needed) and draw...
+        startWrite();
+        setAddrWindow(x, y, 1, 1);
+        spiWrite16(color);
+        endWrite();
+    }
+}
+void TinyTextTFTBus<Bus>::writeColor(uint16_t color, uint32_t len)
+{
+    if (!len)
+    {
+        return; // Avoid 0-byte transfers
+    }
+    do
+    {
+        uint32_t pixelsThisPass = len;
+        if (pixelsThisPass > 50000)
+        {
+            pixelsThisPass = 50000;
+        }
+        len -= pixelsThisPass;
+        yield(); // Periodic yield() on long fills
+        while (pixelsThisPass--)
+        {
+            spiWrite16(color);
+        }
+    }
+    while (len);
+}
+*/
+template <class Bus>
+void TinyTextTFTBus<Bus>::writeColor32(uint32_t color, uint32_t len)
+{
+    if (!len)
+    {
+        return; // Avoid 0-byte transfers
+    }
+    do
+    {
+        uint32_t pixelsThisPass = len;
+        if (pixelsThisPass > 50000)
+        {
+            pixelsThisPass = 50000;
+        }
+        len -= pixelsThisPass;
+        yield(); // Periodic yield() on long fills
+#ifdef TINYTEXT_SPI_PATTERN
+        // color is already byte swapped, so memory order is transfer order
+        uint32_t pattern[8];
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            pattern[i] = color;
+        }
+        if (pixelsThisPass >= 8)
+        {
+            spiWritePattern((const uint8_t*)pattern, sizeof(pattern), pixelsThisPass / 8);
+        }
+        pixelsThisPass &= 7;
+#else
+        if ((_canvas != NULL) && (pixelsThisPass >= 8))
+        {
+            // a canvas copies a block at a time into its frame
+            uint32_t pattern[8];
+            for (uint8_t i = 0; i < 8; i++)
+            {
+                pattern[i] = color;
+            }
+            for (uint32_t i = pixelsThisPass / 8; i != 0; i--)
+            {
+                spiWriteBytes((const uint8_t*)pattern, sizeof(pattern));
+            }
+            pixelsThisPass &= 7;
+        }
+#endif
+        while (pixelsThisPass--)
+        {
+            spiWriteColor32(color);
+        }
+    }
+    while (len);
+}
+
+
+template <class Bus>
+uint32_t TinyTextTFTBus<Bus>::makeColor32(uint16_t color0, uint16_t color1)
+{
+    // flip bytes so the bus can send it least significant byte first (WriteColor32)
+    uint32_t color32 = ((color0 >> 8) | ((color0 & 0xFF) << 8) | ((color1 & 0xFF00) << 8) | ((color1 & 0xFF) << 24));
+    return color32;
+}
+
+template <class Bus>
+uint16_t TinyTextTFTBus<Bus>::convertToRGB565(uint16_t rgb444)
+{
+    uint8_t rColor = (rgb444 >> 8);
+    uint8_t gColor = ((rgb444 >> 4) & (0x0F));
+    uint8_t bColor = (rgb444 & 0x0F);
+    uint16_t c565 = (uint16_t)((rColor << 12) + (gColor << 7) + (bColor << 1));
+    if (rColor & 0x01 != 0)
+    {
+        c565 |= 0x0800;
+    }
+    if (gColor & 0x01 != 0)
+    {
+        c565 |= 0x0060;
+    }
+    if (bColor & 0x01 != 0)
+    {
+        c565 |= 0x0001;
+    }
+    return c565;
+}
+
+template <class Bus>
+const uint16_t* TinyTextTFTBus<Bus>::getPalette(uint16_t foreColor, uint16_t backColor)
+{
+#ifdef TINYTEXT_STATS
+    uint32_t builds = _palettes.Builds();
+    const uint16_t* palette = _palettes.Get(foreColor, backColor);
+    _stats.blendCalls += (_palettes.Builds() - builds) * 16;
+    return palette;
+#else
+    return _palettes.Get(foreColor, backColor);
+#endif
+}
+
+#ifdef TINYTEXT_STATS
+template <class Bus>
+void TinyTextTFTBus<Bus>::ResetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+#endif
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::Begin(bool calibrate)
+{
+    invalidateWindow();
+    _bus.Begin(_frequency);
+    _beginState = TINYTEXT_BEGIN_READY;
+    _offline = (_canvas != NULL);
+    if (_rst >= 0)
+    {
+        // hardware reset
+        pinMode(_rst, OUTPUT);
+        digitalWrite(_rst, HIGH);
+        delay(100);
+        digitalWrite(_rst, LOW);
+        delay(100);
+        digitalWrite(_rst, HIGH);
+        delay(200);
+    }
+    else
+    {
+        // software reset
+        sendCommand(ILI9341_SWRESET); // Engage software reset
+        delay(150);
+    }
+
+    uint8_t cmd, x, numArgs;
+    const uint8_t* addr = initcmd;
+    while ((cmd = pgm_read_byte(addr++)) > 0)
+    {
+        x = pgm_read_byte(addr++);
+        numArgs = x & 0x7F;
+        sendCommand(cmd, addr, numArgs);
+        addr += numArgs;
+        if (x & 0x80)
+        {
+            delay(150);
+        }
+    }
+    if (calibrate)
+    {
+        Calibrate();
+    }
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::BeginAsync()
+{
+    invalidateWindow();
+    _bus.Begin(_frequency);
+    _beginState = TINYTEXT_BEGIN_RESET;
+    _offline = true; // drawing calls don't reach the panel until it is ready
+    _beginOffset = 0;
+    _beginTime = micros();
+    if (_rst >= 0)
+    {
+        // hardware reset: RESX low for at least 10us
+        pinMode(_rst, OUTPUT);
+        digitalWrite(_rst, LOW);
+        _beginWait = 10;
+    }
+    else
+    {
+        // software reset: 5ms before the next command
+        _offline = (_canvas != NULL);
+        sendCommand(ILI9341_SWRESET);
+        _offline = true;
+        _beginState = TINYTEXT_BEGIN_COMMANDS;
+        _beginReset = _beginTime;
+        _beginWait = 5000;
+    }
+}
+
+template <class Bus>
+bool TinyTextTFTBus<Bus>::PollBegin()
+{
+    if (_beginState == TINYTEXT_BEGIN_READY)
+    {
+        return false;
+    }
+    if (micros() - _beginTime < _beginWait)
+    {
+        return true;
+    }
+    if (_beginState == TINYTEXT_BEGIN_RESET)
+    {
+        // 5ms after RESX goes high before the first command
+        digitalWrite(_rst, HIGH);
+        _beginState = TINYTEXT_BEGIN_COMMANDS;
+        _beginReset = micros();
+        _beginTime = _beginReset;
+        _beginWait = 5000;
+        return true;
+    }
+
+    // send commands up to the next one that needs a wait
+    _offline = (_canvas != NULL);
+    uint8_t cmd, x, numArgs;
+    const uint8_t* addr = initcmd + _beginOffset;
+    while ((cmd = pgm_read_byte(addr)) > 0)
+    {
+        if ((cmd == ILI9341_SLPOUT) && (micros() - _beginReset < 120000))
+        {
+            // no Sleep Out within 120ms of a reset
+            _offline = true;
+            _beginTime = _beginReset;
+            _beginWait = 120000;
+            return true;
+        }
+        x = pgm_read_byte(addr + 1);
+        numArgs = x & 0x7F;
+        sendCommand(cmd, addr + 2, numArgs);
+        addr += 2 + numArgs;
+        _beginOffset = addr - initcmd;
+        if ((x & 0x80) && (cmd != ILI9341_DISPON))
+        {
+            // 5ms after Sleep Out for the supplies to settle, Display On needs none
+            _offline = true;
+            _beginTime = micros();
+            _beginWait = 5000;
+            return true;
+        }
+    }
+
+    // ready: catch the panel up with what was drawn meanwhile
+    _beginState = TINYTEXT_BEGIN_READY;
+    sendCommand(ILI9341_MADCTL, &_madctl, 1);
+    sendScroll();
+    if (_gridGlyphs != NULL)
+    {
+        memset(_gridDirty, 0xFF, TINYTEXT_MAX_CELLS / 8);
+        _gridAnyDirty = true;
+    }
+    return false;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::FillScreen(uint16_t color)
+{
+    TINYTEXT_TIME_START;
+    uint16_t color565 = convertToRGB565(color);
+    startWrite();
+    setAddrWindow(0, 0, _width, _height);
+    uint32_t color32 = makeColor32(color565, color565);
+    writeColor32(color32, (uint32_t)_width * _height / 2);
+    endWrite();
+    gridFill(0, 0, _columns, _rows, color, false);
+    TINYTEXT_TIME_END(TINYTEXT_CALL_FILL);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::FillCells(uint8_t col, uint8_t row, uint8_t w, uint8_t h, uint16_t backColor)
+{
+    if ((col >= _columns) || (row >= _rows) || (w == 0) || (h == 0))
+    {
+        return; // clipping
+    }
+    TINYTEXT_TIME_START;
+    startWrite();
+    writeFill(col, row, w, h, backColor);
+    endWrite();
+    gridFill(col, row, w, h, backColor, false);
+    TINYTEXT_TIME_END(TINYTEXT_CALL_FILL);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::ClearRect(uint8_t col, uint8_t row, uint8_t w, uint8_t h)
+{
+    FillCells(col, row, w, h, _consoleBack);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::ClearRow(uint8_t row)
+{
+    FillCells(0, row, _columns, 1, _consoleBack);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::ClearToEndOfLine()
+{
+    FillCells(_cursorCol, _cursorRow, _columns - _cursorCol, 1, _consoleBack);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::DrawChar(uint8_t col, uint8_t row, char chr, uint16_t foreColor, uint16_t backColor)
+{
+    DrawCode(col, row, (uint8_t)chr, foreColor, backColor); // Latin-1
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::DrawCode(uint8_t col, uint8_t row, uint16_t code, uint16_t foreColor, uint16_t backColor)
+{
+    TINYTEXT_TIME_START;
+    for (;;)
+    {
+        uint8_t index = fontIndex(code); // if it is missing from the font, index will be 0 (' ')
+        if ((col >= _columns) || (row >= _rows))
+        {
+            break; // clipping
+        }
+        gridStore(col, row, 1, &index, &foreColor, &backColor, 0);
+
+        startWrite();
+        if (index == 0)
+        {
+            // ' '
+            TINYTEXT_COUNT(blankCells, 1);
+            uint16_t backColor16 = getPalette(backColor, backColor)[0xF];
+            setAddrWindow(col * _cellWidth, rowY(row), 5, 10);
+            writeColor32(backColor16 | ((uint32_t)backColor16 << 16), 25); // 5x10/2
+        }
+        else
+        {
+            writeRun(col, row, 1, &index, &foreColor, &backColor, 0);
+        }
+        endWrite();
+        break;
+    } // for (;;)
+    TINYTEXT_TIME_END(TINYTEXT_CALL_DRAWCHAR);
+}
+
+template <class Bus>
+uint8_t TinyTextTFTBus<Bus>::GlyphIndex(uint16_t code)
+{
+    return fontIndex(code);
+}
+
+template <class Bus>
+uint16_t TinyTextTFTBus<Bus>::DecodeUTF8(const char*& str, const char* end)
+{
+    return utf8Decode(str, end);
+}
+
+template <class Bus>
+uint8_t TinyTextTFTBus<Bus>::UTF8Length(uint8_t lead)
+{
+    return utf8Length(lead);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::writeGlyphLine(uint8_t index, uint8_t y, const uint16_t* palette)
+{
+    // writes the 5 pixels of scanline y (0..9) of one cell
+    uint16_t backColor16 = palette[0xF];
+    bool edge = (index >= fontEdgeGlyph);
+
+    if ((index == 0) || (!edge && ((y == 0) || (y == 9))))
+    {
+        // ' ', top row or bottom row
+        uint32_t backColor32 = backColor16 | ((uint32_t)backColor16 << 16);
+        spiWriteColor32(backColor32);
+        spiWriteColor32(backColor32);
+        spiWriteColor16(backColor16);
+        return;
+    }
+
+    const uint16_t* addr = (const uint16_t*)tinyFont;
+    addr = addr + (8 * index) + fontToneRow(y);
+    uint16_t tones = pgm_read_word(addr);
+
+    spiWriteColor32(palette[(tones >> 12) & 0x0F] | ((uint32_t)palette[(tones >> 8) & 0x0F] << 16));
+    spiWriteColor32(palette[(tones >> 4) & 0x0F] | ((uint32_t)palette[tones & 0x0F] << 16));
+
+    //right column
+    spiWriteColor16(edge ? palette[tones & 0x0F] : backColor16);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::renderGlyphLine(uint8_t* line, uint8_t index, uint8_t y, const uint16_t* palette)
+{
+    // same 5 pixels as writeGlyphLine, in transfer order
+    uint16_t tones = 0xFFFF;
+    bool edge = (index >= fontEdgeGlyph);
+    if ((index != 0) && (edge || ((y != 0) && (y != 9))))
+    {
+        const uint16_t* addr = (const uint16_t*)tinyFont;
+        tones = pgm_read_word(addr + (8 * index) + fontToneRow(y));
+    }
+    for (uint8_t x = 0; x < 5; x++)
+    {
+        uint16_t pixel = palette[(x == 4) ? (edge ? (tones & 0x0F) : 0xF) : ((tones >> (12 - 4 * x)) & 0x0F)];
+        *line++ = (uint8_t)pixel; // palette entries are already byte swapped
+        *line++ = (uint8_t)(pixel >> 8);
+    }
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::renderGlyph(uint8_t* image, uint8_t index, const uint16_t* palette)
+{
+    for (uint8_t y = 0; y < 10; y++)
+    {
+        renderGlyphLine(image, index, y, palette);
+        image += 10;
+    }
+}
+
+template <class Bus>
+const uint8_t* TinyTextTFTBus<Bus>::getGlyphImage(uint8_t index, uint16_t foreColor, uint16_t backColor)
+{
+    uint32_t key = ((uint32_t)index << 24) | ((uint32_t)(foreColor & 0xFFF) << 12) | (backColor & 0xFFF);
+    _glyphClock++;
+    if (_glyphClock == 0)
+    {
+        // stamps wrapped, start again
+        memset(_glyphUsed, 0, _glyphEntries * sizeof(uint16_t));
+        _glyphClock = 1;
+    }
+    uint16_t oldest = 0;
+    for (uint16_t i = 0; i < _glyphEntries; i++)
+    {
+        if (_glyphKeys[i] == key)
+        {
+            _glyphHits++;
+            _glyphUsed[i] = _glyphClock;
+            return _glyphImages + (uint32_t)i * TINYTEXT_CELL_BYTES;
+        }
+        if (_glyphUsed[i] < _glyphUsed[oldest])
+        {
+            oldest = i;
+        }
+    }
+    // miss: render over the least recently used entry
+    _glyphMisses++;
+    _glyphKeys[oldest] = key;
+    _glyphUsed[oldest] = _glyphClock;
+    uint8_t* image = _glyphImages + (uint32_t)oldest * TINYTEXT_CELL_BYTES;
+    renderGlyph(image, index, getPalette(foreColor, backColor));
+    return image;
+}
+
+template <class Bus>
+bool TinyTextTFTBus<Bus>::EnableGlyphCache(uint16_t budgetBytes)
+{
+    DisableGlyphCache();
+    uint16_t entries = budgetBytes / (TINYTEXT_CELL_BYTES + sizeof(uint32_t) + sizeof(uint16_t));
+    if (entries == 0)
+    {
+        return false;
+    }
+    _glyphImages = (uint8_t*)malloc((uint32_t)entries * TINYTEXT_CELL_BYTES);
+    _glyphKeys = (uint32_t*)malloc(entries * sizeof(uint32_t));
+    _glyphUsed = (uint16_t*)malloc(entries * sizeof(uint16_t));
+    if ((_glyphImages == NULL) || (_glyphKeys == NULL) || (_glyphUsed == NULL))
+    {
+        DisableGlyphCache();
+        return false;
+    }
+    for (uint16_t i = 0; i < entries; i++)
+    {
+        _glyphKeys[i] = 0; // glyph 0 (' ') never goes through the cache
+        _glyphUsed[i] = 0;
+    }
+    _glyphEntries = entries;
+    _glyphClock = 0;
+    _glyphHits = 0;
+    _glyphMisses = 0;
+    return true;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::DisableGlyphCache()
+{
+    free(_glyphImages);
+    free(_glyphKeys);
+    free(_glyphUsed);
+    _glyphImages = NULL;
+    _glyphKeys = NULL;
+    _glyphUsed = NULL;
+    _glyphEntries = 0;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::writeRun(uint8_t col, uint8_t row, uint8_t len, const uint8_t* glyphs,
+                           const uint16_t* foreColors, const uint16_t* backColors, uint8_t colorStep)
+{
+    // colorStep is 0 for a single colour pair, 1 for a colour pair per cell
+    if ((col >= _columns) || (row >= _rows) || (len == 0))
+    {
+        return; // clipping
+    }
+    if (len > _columns - col)
+    {
+        len = _columns - col;
+    }
+#ifdef TINYTEXT_STATS
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (glyphs[i] == 0)
+        {
+            _stats.blankCells++;
+        }
+        else
+        {
+            _stats.glyphsDrawn++;
+        }
+    }
+#endif
+
+    if ((len == 1) && (_glyphEntries != 0) && (glyphs[0] != 0))
+    {
+        // single cell: one bulk transfer of the cached image
+        const uint8_t* image = getGlyphImage(glyphs[0], foreColors[0], backColors[0]);
+        setAddrWindow(col * _cellWidth, rowY(row), _cellWidth, _cellHeight);
+        spiWriteBytes(image, TINYTEXT_CELL_BYTES);
+        return;
+    }
+
+    if (_pipeline.Active())
+    {
+        // rendered here, the window and pixels are sent by the pipeline
+        for (uint8_t y = 0; y < _cellHeight; y++)
+        {
+            TinyTextLine* line = _pipeline.Acquire();
+            line->x = col * _cellWidth;
+            line->y = rowY(row);
+            line->w = len * _cellWidth;
+            line->h = _cellHeight;
+            line->window = (y == 0);
+            line->size = len * _cellWidth * 2;
+            renderRunLine(line->data, y, len, glyphs, foreColors, backColors, colorStep);
+            _pipeline.Publish();
+        }
+        return;
+    }
+
+    // one window for the whole run, streamed a scanline at a time
+    setAddrWindow(col * _cellWidth, rowY(row), len * _cellWidth, _cellHeight);
+    if (_canvasRun != NULL)
+    {
+        writeCanvasRun(len, glyphs, foreColors, backColors, colorStep);
+        return;
+    }
+    for (uint8_t y = 0; y < _cellHeight; y++)
+    {
+        const uint16_t* foreColor = foreColors;
+        const uint16_t* backColor = backColors;
+        const uint16_t* palette = NULL;
+        uint16_t paletteFore = 0xFFFF; // not a valid RGB444 colour
+        uint16_t paletteBack = 0xFFFF;
+        for (uint8_t i = 0; i < len; i++)
+        {
+            if ((*foreColor != paletteFore) || (*backColor != paletteBack))
+            {
+                paletteFore = *foreColor;
+                paletteBack = *backColor;
+                palette = getPalette(paletteFore, paletteBack);
+            }
+            writeGlyphLine(glyphs[i], y, palette);
+            foreColor += colorStep;
+            backColor += colorStep;
+        }
+    }
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::renderRunLine(uint8_t* line, uint8_t y, uint8_t len, const uint8_t* glyphs,
+                                        const uint16_t* foreColors, const uint16_t* backColors, uint8_t colorStep)
+{
+    // scanline y of a run of cells, in transfer order
+    const uint16_t* palette = NULL;
+    uint16_t paletteFore = 0xFFFF; // not a valid RGB444 colour
+    uint16_t paletteBack = 0xFFFF;
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if ((*foreColors != paletteFore) || (*backColors != paletteBack))
+        {
+            paletteFore = *foreColors;
+            paletteBack = *backColors;
+            palette = getPalette(paletteFore, paletteBack);
+        }
+        renderGlyphLine(line, glyphs[i], y, palette);
+        line += _cellWidth * 2;
+        foreColors += colorStep;
+        backColors += colorStep;
+    }
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::writeCanvasRun(uint8_t len, const uint8_t* glyphs, const uint16_t* foreColors,
+                                         const uint16_t* backColors, uint8_t colorStep)
+{
+    // to a canvas a whole scanline at a time, which it copies straight into its
+    // frame. Each cell's palette is looked up once for the run rather than once a
+    // scanline: a run of more colour pairs than the palette cache holds would
+    // otherwise blend every one of them again on every scanline.
+    uint16_t (*palettes)[16] = (uint16_t (*)[16])_canvasRun;
+    uint8_t* line = _canvasRun + TINYTEXT_MAX_COLUMNS * 16 * sizeof(uint16_t);
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if ((i == 0) || (foreColors[i * colorStep] != foreColors[(i - 1) * colorStep]) ||
+            (backColors[i * colorStep] != backColors[(i - 1) * colorStep]))
+        {
+            memcpy(palettes[i], getPalette(foreColors[i * colorStep], backColors[i * colorStep]), 16 * sizeof(uint16_t));
+        }
+        else
+        {
+            memcpy(palettes[i], palettes[i - 1], 16 * sizeof(uint16_t));
+        }
+    }
+    for (uint8_t y = 0; y < _cellHeight; y++)
+    {
+        for (uint8_t i = 0; i < len; i++)
+        {
+            renderGlyphLine(line + i * _cellWidth * 2, glyphs[i], y, palettes[i]);
+        }
+        spiWriteBytes(line, len * _cellWidth * 2);
+    }
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::DrawString(uint8_t col, uint8_t row, const char* str, uint8_t len, uint16_t foreColor, uint16_t backColor)
+{
+    TINYTEXT_TIME_START;
+    uint8_t glyphs[TINYTEXT_MAX_COLUMNS];
+    len = utf8Glyphs(str, len, glyphs); // now in cells
+    startWrite();
+    writeRun(col, row, len, glyphs, &foreColor, &backColor, 0);
+    endWrite();
+    gridStore(col, row, len, glyphs, &foreColor, &backColor, 0);
+    TINYTEXT_TIME_END(TINYTEXT_CALL_DRAWSTRING);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::DrawRun(uint8_t col, uint8_t row, const char* str, const uint16_t* foreColors, const uint16_t* backColors, uint8_t len)
+{
+    TINYTEXT_TIME_START;
+    uint8_t glyphs[TINYTEXT_MAX_COLUMNS];
+    len = utf8Glyphs(str, len, glyphs); // now in cells
+    startWrite();
+    writeRun(col, row, len, glyphs, foreColors, backColors, 1);
+    endWrite();
+    gridStore(col, row, len, glyphs, foreColors, backColors, 1);
+    TINYTEXT_TIME_END(TINYTEXT_CALL_DRAWSTRING);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::DrawGlyphs(uint8_t col, uint8_t row, const uint8_t* glyphs, const uint16_t* foreColors, const uint16_t* backColors, uint8_t len)
+{
+    TINYTEXT_TIME_START;
+    startWrite();
+    writeRun(col, row, len, glyphs, foreColors, backColors, 1);
+    endWrite();
+    gridStore(col, row, len, glyphs, foreColors, backColors, 1);
+    TINYTEXT_TIME_END(TINYTEXT_CALL_DRAWSTRING);
+}
+
+template <class Bus>
+bool TinyTextTFTBus<Bus>::EnableGrid()
+{
+    if (_gridGlyphs != NULL)
+    {
+        _gridConsole = false; // the console's grid is the shadow grid from now on
+        return true;
+    }
+    _gridGlyphs = (uint8_t*)malloc(TINYTEXT_MAX_CELLS);
+    _gridFore = (uint16_t*)malloc(TINYTEXT_MAX_CELLS * sizeof(uint16_t));
+    _gridBack = (uint16_t*)malloc(TINYTEXT_MAX_CELLS * sizeof(uint16_t));
+    _gridDirty = (uint8_t*)malloc(TINYTEXT_MAX_CELLS / 8);
+    if ((_gridGlyphs == NULL) || (_gridFore == NULL) || (_gridBack == NULL) || (_gridDirty == NULL))
+    {
+        DisableGrid();
+        return false;
+    }
+    gridFill(0, 0, _columns, _rows, RGB444_BLACK, true); // we don't know what is on the panel
+    return true;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::DisableGrid()
+{
+    WaitComplete();
+    free(_asyncBuffers[0]);
+    free(_asyncBuffers[1]);
+    _asyncBuffers[0] = NULL;
+    _asyncBuffers[1] = NULL;
+    free(_gridGlyphs);
+    free(_gridFore);
+    free(_gridBack);
+    free(_gridDirty);
+    _palettes.Clear();
+
+    _gridGlyphs = NULL;
+    _gridFore = NULL;
+    _gridBack = NULL;
+    _gridDirty = NULL;
+    _gridAnyDirty = false;
+    _gridConsole = false;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::gridFill(uint8_t col, uint8_t row, uint8_t w, uint8_t h, uint16_t backColor, bool dirty)
+{
+    if ((_gridGlyphs == NULL) || (col >= _columns) || (row >= _rows))
+    {
+        return;
+    }
+    if (w > _columns - col)
+    {
+        w = _columns - col;
+    }
+    if (h > _rows - row)
+    {
+        h = _rows - row;
+    }
+    for (uint8_t r = row; r < row + h; r++)
+    {
+        uint16_t cell = r * _columns + col;
+        for (uint8_t i = 0; i < w; i++)
+        {
+            _gridGlyphs[cell] = 0;
+            _gridFore[cell] = backColor;
+            _gridBack[cell] = backColor;
+            if (dirty)
+            {
+                _gridDirty[cell >> 3] |= (1 << (cell & 7));
+            }
+            else
+            {
+                _gridDirty[cell >> 3] &= ~(1 << (cell & 7));
+            }
+            cell++;
+        }
+    }
+    if (dirty)
+    {
+        _gridAnyDirty = true;
+    }
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::gridScroll(uint8_t row, uint8_t rows, uint16_t backColor, bool dirty)
+{
+    // move rows row + 1 .. row + rows - 1 of the grid up one, the last becomes blank
+    // dirty: the panel did not move so mark the cells that now differ
+    if (_gridGlyphs == NULL)
+    {
+        return;
+    }
+    uint16_t first = row * _columns;
+    uint16_t cells = (rows - 1) * _columns;
+    if (dirty)
+    {
+        for (uint16_t cell = first; cell < first + cells; cell++)
+        {
+            uint16_t below = cell + _columns;
+            if ((_gridGlyphs[cell] != _gridGlyphs[below]) || (_gridFore[cell] != _gridFore[below]) || (_gridBack[cell] != _gridBack[below]))
+            {
+                _gridDirty[cell >> 3] |= (1 << (cell & 7));
+                _gridAnyDirty = true;
+            }
+        }
+    }
+    else
+    {
+        // the panel moved with us, dirty bits move too (rows are a whole number of bytes)
+        memmove(_gridDirty + first / 8, _gridDirty + (first + _columns) / 8, cells / 8);
+    }
+    memmove(_gridGlyphs + first, _gridGlyphs + first + _columns, cells);
+    memmove(_gridFore + first, _gridFore + first + _columns, cells * sizeof(uint16_t));
+    memmove(_gridBack + first, _gridBack + first + _columns, cells * sizeof(uint16_t));
+    gridFill(0, row + rows - 1, _columns, 1, backColor, dirty);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::gridStore(uint8_t col, uint8_t row, uint8_t len, const uint8_t* glyphs,
+                            const uint16_t* foreColors, const uint16_t* backColors, uint8_t colorStep)
+{
+    // record cells that were just drawn directly: stored clean
+    if ((_gridGlyphs == NULL) || (col >= _columns) || (row >= _rows))
+    {
+        return;
+    }
+    if (len > _columns - col)
+    {
+        len = _columns - col;
+    }
+    uint16_t cell = row * _columns + col;
+    for (uint8_t i = 0; i < len; i++)
+    {
+        _gridGlyphs[cell] = glyphs[i];
+        _gridFore[cell] = (glyphs[i] == 0) ? *backColors : *foreColors; // fore colour of a blank cell doesn't matter
+        _gridBack[cell] = *backColors;
+        _gridDirty[cell >> 3] &= ~(1 << (cell & 7));
+        foreColors += colorStep;
+        backColors += colorStep;
+        cell++;
+    }
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::Put(uint8_t col, uint8_t row, char chr, uint16_t foreColor, uint16_t backColor)
+{
+    PutCode(col, row, (uint8_t)chr, foreColor, backColor); // Latin-1
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::PutCode(uint8_t col, uint8_t row, uint16_t code, uint16_t foreColor, uint16_t backColor)
+{
+    if ((_gridGlyphs == NULL) || _gridConsole)
+    {
+        DrawCode(col, row, code, foreColor, backColor);
+        return;
+    }
+    if ((col >= _columns) || (row >= _rows))
+    {
+        return; // clipping
+    }
+    uint8_t index = fontIndex(code);
+    if (index == 0)
+    {
+        foreColor = backColor;
+    }
+    uint16_t cell = row * _columns + col;
+    if ((_gridGlyphs[cell] != index) || (_gridFore[cell] != foreColor) || (_gridBack[cell] != backColor))
+    {
+        _gridGlyphs[cell] = index;
+        _gridFore[cell] = foreColor;
+        _gridBack[cell] = backColor;
+        _gridDirty[cell >> 3] |= (1 << (cell & 7));
+        _gridAnyDirty = true;
+    }
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::Print(uint8_t col, uint8_t row, const char* str, uint16_t foreColor, uint16_t backColor)
+{
+    Print(col, row, str, strlen(str), foreColor, backColor);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::Print(uint8_t col, uint8_t row, const char* str, size_t len, uint16_t foreColor, uint16_t backColor)
+{
+    const char* end = str + len;
+    while ((str < end) && (col < _columns))
+    {
+        PutCode(col, row, utf8Decode(str, end), foreColor, backColor);
+        col++;
+    }
+}
+
+template <class Bus>
+bool TinyTextTFTBus<Bus>::nextDirtyRun(uint8_t& col, uint8_t& row, uint8_t& len)
+{
+    // finds the next run of adjacent dirty cells on a row at or after (col, row)
+    // and marks it clean
+    for (; row < _rows; row++)
+    {
+        uint16_t rowCell = row * _columns;
+        while (col < _columns)
+        {
+            uint16_t cell = rowCell + col;
+            if ((_gridDirty[cell >> 3] & (1 << (cell & 7))) == 0)
+            {
+                col++;
+                continue;
+            }
+            len = 0;
+            while ((col + len < _columns) && (_gridDirty[(cell + len) >> 3] & (1 << ((cell + len) & 7))))
+            {
+                _gridDirty[(cell + len) >> 3] &= ~(1 << ((cell + len) & 7));
+                len++;
+            }
+            return true;
+        }
+        col = 0;
+    }
+    return false;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::Flush()
+{
+    if ((_gridGlyphs == NULL) || !_gridAnyDirty)
+    {
+        return;
+    }
+    TINYTEXT_TIME_START;
+    WaitComplete();
+    _gridAnyDirty = false;
+    startWrite();
+    uint8_t col = 0;
+    uint8_t row = 0;
+    uint8_t len;
+    while (nextDirtyRun(col, row, len))
+    {
+        uint16_t cell = row * _columns + col;
+        writeRun(col, row, len, _gridGlyphs + cell, _gridFore + cell, _gridBack + cell, 1);
+        col += len;
+    }
+    endWrite();
+    TINYTEXT_TIME_END(TINYTEXT_CALL_FLUSH);
+}
+
+template <class Bus>
+bool TinyTextTFTBus<Bus>::FlushAsync(TinyTextCallback callback)
+{
+    if (_gridGlyphs == NULL)
+    {
+        return false;
+    }
+    WaitComplete();
+    if (_asyncBuffers[0] == NULL)
+    {
+        // + 4 so the FIFO can be loaded a whole word at a time
+        _asyncBuffers[0] = (uint8_t*)malloc(TINYTEXT_LINE_BYTES + 4);
+        _asyncBuffers[1] = (uint8_t*)malloc(TINYTEXT_LINE_BYTES + 4);
+        if ((_asyncBuffers[0] == NULL) || (_asyncBuffers[1] == NULL))
+        {
+            free(_asyncBuffers[0]);
+            free(_asyncBuffers[1]);
+            _asyncBuffers[0] = NULL;
+            _asyncBuffers[1] = NULL;
+            return false;
+        }
+    }
+    _asyncCallback = callback;
+    _asyncCol = 0;
+    _asyncRow = 0;
+    _asyncLen = 0;
+    _asyncLine = _cellHeight; // no run yet
+    _asyncNext = -1;
+    _asyncBusy = true;
+    _asyncTotal = 0;
+    _asyncDone = 0;
+    for (uint8_t i = 0; i < TINYTEXT_MAX_CELLS / 8; i++)
+    {
+        _asyncTotal += __builtin_popcount(_gridDirty[i]);
+    }
+    _asyncTotal *= TINYTEXT_CELL_BYTES;
+    _gridAnyDirty = false;
+    Poll();
+    return true;
+}
+
+template <class Bus>
+bool TinyTextTFTBus<Bus>::Flush(uint32_t budgetMicros)
+{
+    uint32_t start = micros();
+    if (!_asyncBusy)
+    {
+        if ((_gridGlyphs == NULL) || !_gridAnyDirty)
+        {
+            return false;
+        }
+        if (!FlushAsync())
+        {
+            Flush(); // no line buffers: all in one go
+            return false;
+        }
+    }
+    while (Poll())
+    {
+        if (micros() - start >= budgetMicros)
+        {
+            asyncFinishLine(); // the bus is left free
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class Bus>
+uint8_t TinyTextTFTBus<Bus>::FlushProgress()
+{
+    if (!_asyncBusy || (_asyncDone >= _asyncTotal))
+    {
+        return 100;
+    }
+    return (uint8_t)(_asyncDone / ((_asyncTotal + 99) / 100));
+}
+
+template <class Bus>
+bool TinyTextTFTBus<Bus>::asyncRenderLine()
+{
+    // renders the next scanline into the free line buffer, false when there is nothing left
+    if (_asyncNext >= 0)
+    {
+        return true; // one is already waiting
+    }
+    int8_t k = (_asyncSending == 0) ? 1 : 0;
+    if (_asyncLine >= _cellHeight)
+    {
+        _asyncCol += _asyncLen;
+        if (!nextDirtyRun(_asyncCol, _asyncRow, _asyncLen))
+        {
+            _asyncLen = 0;
+            return false;
+        }
+        _asyncLine = 0;
+#ifdef TINYTEXT_STATS
+        for (uint8_t i = 0; i < _asyncLen; i++)
+        {
+            if (_gridGlyphs[_asyncRow * _columns + _asyncCol + i] == 0)
+            {
+                _stats.blankCells++;
+            }
+            else
+            {
+                _stats.glyphsDrawn++;
+            }
+        }
+#endif
+    }
+    uint16_t cell = _asyncRow * _columns + _asyncCol;
+    uint8_t* line = _asyncBuffers[k];
+    for (uint8_t i = 0; i < _asyncLen; i++)
+    {
+        // cells changed while the run is going out are caught by the next flush
+        renderGlyphLine(line, _gridGlyphs[cell], _asyncLine, getPalette(_gridFore[cell], _gridBack[cell]));
+        line += 10;
+        cell++;
+    }
+    _asyncX[k] = _asyncCol * _cellWidth;
+    _asyncY[k] = rowY(_asyncRow) + _asyncLine;
+    _asyncSize[k] = _asyncLen * 10;
+    _asyncNext = k;
+    _asyncLine++;
+    return true;
+}
+
+template <class Bus>
+bool TinyTextTFTBus<Bus>::asyncTransferBusy()
+{
+    return !_offline && _bus.Busy();
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::asyncTransferChunk()
+{
+    // sends the next part of the line buffer that is going out
+    uint8_t* data = _asyncBuffers[_asyncSending] + _asyncSent;
+    uint16_t size = _asyncSize[_asyncSending] - _asyncSent;
+    if (_offline)
+    {
+        spiWriteBytes(data, size);
+    }
+    else
+    {
+        // the ESP8266 takes what fits in its FIFO and clocks it out on its own,
+        // elsewhere it blocks for the whole line
+        size = _bus.StartBytes(data, size);
+        TINYTEXT_COUNT(dataBytes, size);
+    }
+    _asyncSent += size;
+}
+
+template <class Bus>
+bool TinyTextTFTBus<Bus>::asyncSendLine()
+{
+    // moves the line buffer that is going out along without waiting for the bus,
+    // true once it has all gone and its transaction has ended
+    int8_t k = _asyncSending;
+    if (!asyncTransferBusy() && (_asyncSent < _asyncSize[k]))
+    {
+        asyncTransferChunk();
+    }
+    if (asyncTransferBusy() || (_asyncSent < _asyncSize[k]))
+    {
+        return false;
+    }
+    _asyncSize[k] = 0;
+    _asyncSending = -1;
+    endWrite();
+    return true;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::asyncFinishLine()
+{
+    // blocks until the line buffer that is going out (if any) has gone
+    while ((_asyncSending >= 0) && !asyncSendLine())
+    {
+    }
+}
+
+template <class Bus>
+bool TinyTextTFTBus<Bus>::Poll()
+{
+    // never waits for the bus: while a line is going out it is topped up (or left
+    // to go) and Poll returns, the next one starts on the call after it has gone
+    if (!_asyncBusy)
+    {
+        return false;
+    }
+    if ((_asyncSending >= 0) && !asyncSendLine())
+    {
+        return true; // still going out, its transaction stays open
+    }
+    if (!asyncRenderLine())
+    {
+        // nothing left to send
+        _asyncBusy = false;
+        if (_asyncCallback != NULL)
+        {
+            _asyncCallback();
+        }
+        return false;
+    }
+    int8_t k = _asyncNext;
+    _asyncNext = -1;
+    startWrite();
+    setAddrWindow(_asyncX[k], _asyncY[k], _asyncSize[k] / 2, 1);
+    _asyncDone += _asyncSize[k];
+    _asyncSending = k;
+    _asyncSent = 0;
+    asyncTransferChunk();
+    asyncRenderLine(); // the next line while this one goes out
+    asyncSendLine();   // gone already where the bus sends it all at once
+    return true;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::WaitComplete()
+{
+    while (Poll())
+    {
+        yield();
+    }
+    _pipeline.Drain();
+}
+
+template <class Bus>
+bool TinyTextTFTBus<Bus>::EnablePipeline(uint8_t lines, bool threaded)
+{
+    WaitComplete();
+    return _pipeline.Begin(lines, TINYTEXT_LINE_BYTES, threaded, pipelineSend, this);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::DisablePipeline()
+{
+    WaitComplete();
+    _pipeline.End();
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::pipelineSend(void* tft, const TinyTextLine& line)
+{
+    // the consumer stage, inside the transaction of the call that rendered the line
+    TinyTextTFTBus* self = (TinyTextTFTBus*)tft;
+    if (line.window)
+    {
+        self->writeAddrWindow(line.x, line.y, line.w, line.h);
+    }
+    self->spiWriteBytes(line.data, line.size);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::writeFill(uint8_t col, uint8_t row, uint8_t w, uint8_t h, uint16_t backColor)
+{
+    // blank cells, same colour as the background of a drawn cell
+    if ((col >= _columns) || (row >= _rows) || (w == 0) || (h == 0))
+    {
+        return; // clipping
+    }
+    if (w > _columns - col)
+    {
+        w = _columns - col;
+    }
+    if (h > _rows - row)
+    {
+        h = _rows - row;
+    }
+    TINYTEXT_COUNT(blankCells, (uint16_t)w * h);
+    uint16_t backColor16 = getPalette(backColor, backColor)[0xF];
+    uint32_t backColor32 = backColor16 | ((uint32_t)backColor16 << 16);
+    while (h != 0)
+    {
+        // rows are contiguous in frame memory up to where the hardware scroll area
+        // wraps, starts or ends
+        uint8_t rows;
+        uint8_t i = row - _scrollTop;
+        if (i < _scrollRows)
+        {
+            uint8_t moved = (i + _scrollRow) % _scrollRows;
+            rows = _scrollRows - ((moved > i) ? moved : i);
+        }
+        else
+        {
+            rows = (row < _scrollTop) ? _scrollTop - row : _rows - row;
+        }
+        if (rows > h)
+        {
+            rows = h;
+        }
+        setAddrWindow(col * _cellWidth, rowY(row), w * _cellWidth, rows * _cellHeight);
+        writeColor32(backColor32, (uint32_t)w * rows * 25); // 5x10/2 per cell
+        row += rows;
+        h -= rows;
+    }
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::sendScroll()
+{
+    // frame memory line shown at the top of the scroll area for _scrollRow
+    uint16_t top = _scrollTop * _cellHeight;
+    uint16_t lines = _scrollRows * _cellHeight;
+    uint16_t line = top + _scrollRow * _cellHeight;
+    if (_rotation == 2)
+    {
+        // MY: frame memory runs the other way
+        top = ILI9341_TFTHEIGHT - top - lines;
+        line = top + (lines - _scrollRow * _cellHeight) % lines;
+    }
+    uint8_t scroll[2] = { (uint8_t)(line >> 8), (uint8_t)line };
+    sendCommand(ILI9341_VSCRSADD, scroll, 2);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::sendScrollArea()
+{
+    // fixed lines above the scroll area, its lines and fixed lines below, in frame memory order
+    uint16_t above = _scrollTop * _cellHeight;
+    uint16_t lines = _scrollRows * _cellHeight;
+    if (_rotation == 2)
+    {
+        above = ILI9341_TFTHEIGHT - above - lines;
+    }
+    uint16_t below = ILI9341_TFTHEIGHT - above - lines;
+    uint8_t area[6] = { (uint8_t)(above >> 8), (uint8_t)above, (uint8_t)(lines >> 8), (uint8_t)lines,
+                        (uint8_t)(below >> 8), (uint8_t)below };
+    sendCommand(ILI9341_VSCRDEF, area, 6);
+}
+
+template <class Bus>
+bool TinyTextTFTBus<Bus>::SetScrollArea(uint8_t row, uint8_t rows)
+{
+    if (((_rotation & 1) != 0) || (row >= _rows) || (rows == 0))
+    {
+        return false; // the controller scrolls across the text rows
+    }
+    if (rows > _rows - row)
+    {
+        rows = _rows - row;
+    }
+    if ((row == _scrollTop) && (rows == _scrollRows))
+    {
+        return true;
+    }
+    if (_scrollRow != 0)
+    {
+        return false; // the rows of the area are out of place in frame memory
+    }
+    WaitComplete();
+    _scrollTop = row;
+    _scrollRows = rows;
+    sendScrollArea();
+    sendScroll();
+    return true;
+}
+
+template <class Bus>
+bool TinyTextTFTBus<Bus>::ScrollAreaUp(uint16_t backColor)
+{
+    if ((_rotation & 1) != 0)
+    {
+        return false;
+    }
+    WaitComplete(); // the grid and frame memory are about to move
+    _scrollRow = (_scrollRow + 1) % _scrollRows;
+    sendScroll();
+    gridScroll(_scrollTop, _scrollRows, backColor, false);
+    startWrite();
+    writeFill(0, _scrollTop + _scrollRows - 1, _columns, 1, backColor);
+    endWrite();
+    return true;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::consoleGrid()
+{
+    // where the console has to scroll in software it needs the grid to scroll from
+    if ((_gridGlyphs != NULL) || !softScroll() || !EnableGrid())
+    {
+        return;
+    }
+    _gridConsole = true;
+    gridFill(0, 0, _columns, _rows, _consoleBack, true); // not known, resent by the first scroll
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::scrollUp()
+{
+    WaitComplete(); // the grid and frame memory are about to move
+    if (!softScroll())
+    {
+        // text rows run along the controller's vertical scroll
+        ScrollAreaUp(_consoleBack);
+    }
+    else if (_gridGlyphs != NULL)
+    {
+        gridScroll(0, _rows, _consoleBack, true);
+        Flush();
+    }
+    else
+    {
+        // nothing to scroll from (no RAM for the grid): start again at the top
+        _cursorRow = 0;
+        startWrite();
+        writeFill(0, 0, _columns, 1, _consoleBack);
+        endWrite();
+        gridFill(0, 0, _columns, 1, _consoleBack, false);
+        return;
+    }
+    _cursorRow = _rows - 1;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::newLine()
+{
+    _cursorCol = 0;
+    _cursorRow++;
+    if (_cursorRow >= _rows)
+    {
+        scrollUp();
+    }
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::SetCursor(uint8_t col, uint8_t row)
+{
+    _cursorCol = (col < _columns) ? col : _columns - 1;
+    _cursorRow = (row < _rows) ? row : _rows - 1;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::SetConsoleColors(uint16_t foreColor, uint16_t backColor)
+{
+    _consoleFore = foreColor;
+    _consoleBack = backColor;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::Write(char chr)
+{
+    Write(&chr, 1);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::Write(const char* str)
+{
+    Write(str, strlen(str));
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::Write(const char* str, size_t len)
+{
+    TINYTEXT_TIME_START;
+    uint8_t pending = _utf8.Finish(str, len);
+    if (pending != 0)
+    {
+        writeText(_utf8.Bytes(), pending);
+    }
+    writeText(str, _utf8.Hold(str, len));
+    TINYTEXT_TIME_END(TINYTEXT_CALL_WRITE);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::writeText(const char* str, size_t len)
+{
+    consoleGrid();
+    while (len != 0)
+    {
+        char chr = *str;
+        if (chr == '\n')
+        {
+            newLine();
+            str++;
+            len--;
+            continue;
+        }
+        if (chr == '\r')
+        {
+            _cursorCol = 0;
+            str++;
+            len--;
+            continue;
+        }
+        if (_cursorCol >= _columns)
+        {
+            newLine(); // wrap
+        }
+        // printable run up to the next control character or the end of the row,
+        // in bytes and in cells (characters)
+        const char* end = str + len;
+        const char* next = str;
+        uint8_t cells = 0;
+        while ((next < end) && (*next != '\n') && (*next != '\r') && (cells < _columns - _cursorCol) && (next - str <= 0xFF - 4))
+        {
+            utf8Decode(next, end);
+            cells++;
+        }
+        uint8_t run = next - str;
+        DrawString(_cursorCol, _cursorRow, str, run, _consoleFore, _consoleBack);
+        _cursorCol += cells;
+        str += run;
+        len -= run;
+    }
+}
+
+template <class Bus>
+size_t TinyTextTFTBus<Bus>::write(uint8_t c)
+{
+    Write((const char*)&c, 1);
+    return 1;
+}
+
+template <class Bus>
+size_t TinyTextTFTBus<Bus>::write(const uint8_t* buffer, size_t size)
+{
+    Write((const char*)buffer, size);
+    return size;
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::SetCanvas(TinyTextCanvas* canvas)
+{
+    WaitComplete();
+    _canvas = canvas;
+    _offline = (_canvas != NULL) || (_beginState != TINYTEXT_BEGIN_READY);
+    invalidateWindow(); // the window cache was for the other target
+    if ((_canvas != NULL) && (_canvasRun == NULL))
+    {
+        // runs go to a canvas a scanline at a time (none if there isn't the RAM)
+        _canvasRun = (uint8_t*)malloc(TINYTEXT_CANVAS_RUN_BYTES);
+    }
+    else if (_canvas == NULL)
+    {
+        free(_canvasRun);
+        _canvasRun = NULL;
+    }
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::PushCanvas(TinyTextCanvas* canvas)
+{
+    // the canvas frame memory in one window, then its scroll position
+    TinyTextCanvas* attached = _canvas;
+    SetCanvas(NULL);
+    uint8_t line[ILI9341_TFTHEIGHT * 2];
+    startWrite();
+    setAddrWindow(0, 0, _width, _height);
+    for (uint16_t y = 0; y < _height; y++)
+    {
+        for (uint16_t x = 0; x < _width; x++)
+        {
+            uint16_t pixel = canvas->GetMemoryPixel(x, y);
+            line[2 * x] = pixel >> 8;
+            line[2 * x + 1] = pixel;
+        }
+        spiWriteBytes(line, _width * 2);
+    }
+    endWrite();
+    uint16_t start = canvas->ScrollStart();
+    uint8_t scroll[2] = { (uint8_t)(start >> 8), (uint8_t)start };
+    sendCommand(ILI9341_VSCRSADD, scroll, 2);
+    SetCanvas(attached);
+}
+
+template <class Bus>
+void TinyTextTFTBus<Bus>::SetRotation(uint8_t m)
+{
+    WaitComplete();
+    if ((_scrollTop != 0) || (_scrollRows != _rows))
+    {
+        // back to the whole screen as the scroll area
+        _scrollTop = 0;
+        _scrollRows = _rows;
+        sendScrollArea();
+    }
+    _rotation = m % 4; // can't be higher than 3
+    switch (_rotation)
+    {
+        case 0:
+            m = (MADCTL_MX | MADCTL_BGR);
+            _width = ILI9341_TFTWIDTH;
+            _height = ILI9341_TFTHEIGHT;
+            break;
+        case 1:
+            m = (MADCTL_MV | MADCTL_BGR);
+            _width = ILI9341_TFTHEIGHT;
+            _height = ILI9341_TFTWIDTH;
+            break;
+        case 2:
+            m = (MADCTL_MY | MADCTL_BGR);
+            _width = ILI9341_TFTWIDTH;
+            _height = ILI9341_TFTHEIGHT;
+            break;
+        case 3:
+            m = (MADCTL_MX | MADCTL_MY | MADCTL_MV | MADCTL_BGR);
+            _width = ILI9341_TFTHEIGHT;
+            _height = ILI9341_TFTWIDTH;
+            break;
+    }
+    _rows = _height / _cellHeight;
+    _columns = _width / _cellWidth;
+    _scrollTop = 0;
+    _scrollRows = _rows;
+    _madctl = m;
+    sendCommand(ILI9341_MADCTL, &m, 1);
+    invalidateWindow();
+
+    // back to an unscrolled frame memory
+    _scrollRow = 0;
+    sendScroll();
+    _cursorCol = 0;
+    _cursorRow = 0;
+
+    if (_gridConsole)
+    {
+        DisableGrid(); // the console enables it again if it still needs it
+    }
+    gridFill(0, 0, _columns, _rows, RGB444_BLACK, true);
+}
+
+#endif
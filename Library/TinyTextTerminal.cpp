@@ -0,0 +1,62 @@
+#include "Arduino.h"
+#include "TinyTextTerminal.h"
+
+TinyTextTerminal::TinyTextTerminal(TinyTextWindow* window, Stream* stream)
+{
+    _window = window;
+    _stream = stream;
+    _bytes = 0;
+}
+
+void TinyTextTerminal::Begin(uint16_t foreColor, uint16_t backColor)
+{
+    _ansi.Begin(this, foreColor, backColor);
+}
+
+uint16_t TinyTextTerminal::Poll()
+{
+    // only what is there now, so a host that keeps sending can't hold up loop()
+    if (_stream == NULL)
+    {
+        return 0;
+    }
+    uint8_t buffer[TINYTEXT_TERMINAL_BUFFER];
+    uint16_t total = 0;
+    int available = _stream->available();
+    while (available > 0)
+    {
+        uint8_t len = 0;
+        while ((available > 0) && (len < sizeof(buffer)))
+        {
+            int b = _stream->read();
+            if (b < 0)
+            {
+                available = 0;
+                break;
+            }
+            buffer[len++] = (uint8_t)b;
+            available--;
+        }
+        Write((const char*)buffer, len);
+        total += len;
+    }
+    return total;
+}
+
+void TinyTextTerminal::Write(const char* str, size_t len)
+{
+    _bytes += len;
+    _ansi.Write((const uint8_t*)str, len);
+}
+
+size_t TinyTextTerminal::write(uint8_t c)
+{
+    Write((const char*)&c, 1);
+    return 1;
+}
+
+size_t TinyTextTerminal::write(const uint8_t* buffer, size_t size)
+{
+    Write((const char*)buffer, size);
+    return size;
+}
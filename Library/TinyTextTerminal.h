@@ -0,0 +1,67 @@
+#ifndef TinyTextTerminal_h
+#define TinyTextTerminal_h
+
+#include "TinyTextWindow.h"
+#include "TinyTextAnsi.h"
+
+/*
+  A VT100 / ANSI terminal in a TinyTextWindow, for the output of a program on
+  the other end of a Stream (usually a Serial port), e.g. a shell on a Linux
+  board, or for escape sequences printed by the sketch itself. See TinyTextAnsi.h
+  for the sequences it knows.
+
+  Each run of printable characters is written to the window in one go, so it
+  goes out as one address window however long it is, and erasing part of a line
+  or of the screen is a single fill. A window as wide as the screen scrolls with
+  the hardware scroll where it can (see TinyTextWindow), with a TinyTextScrollback
+  set on the window the lines scrolled off the top are kept.
+
+  Call Poll() from loop(): it takes the bytes that have arrived, a buffer at a
+  time, and returns. Without a Stream, bytes are fed with Write or print.
+*/
+
+#define TINYTEXT_TERMINAL_BUFFER 64 // bytes read from the stream at a time
+
+class TinyTextTerminal : public Print, private TinyTextAnsiScreen
+{
+private:
+    TinyTextWindow* _window;
+    Stream*  _stream;
+    TinyTextAnsi _ansi;
+    uint32_t _bytes;
+
+    // TinyTextAnsiScreen, on the window
+    virtual uint8_t Columns()      { return _window->Columns(); }
+    virtual uint8_t Rows()         { return _window->Rows(); }
+    virtual uint8_t CursorColumn() { return _window->CursorColumn(); }
+    virtual uint8_t CursorRow()    { return _window->CursorRow(); }
+    virtual void SetCursor(uint8_t col, uint8_t row)              { _window->SetCursor(col, row); }
+    virtual void SetColors(uint16_t foreColor, uint16_t backColor) { _window->SetColors(foreColor, backColor); }
+    virtual void SetWrap(bool wrap)                               { _window->SetWrap(wrap); }
+    virtual void SetScrollRegion(uint8_t top, uint8_t bottom)     { _window->SetScrollRegion(top, bottom); }
+    virtual void Text(const char* str, size_t len)                { _window->Write(str, len); }
+    virtual void Erase(uint8_t col, uint8_t row, uint8_t w, uint8_t h) { _window->ClearRect(col, row, w, h); }
+    virtual void ScrollUp(bool history) { _window->ScrollUp(history); }
+    virtual void ScrollDown()           { _window->ScrollDown(); }
+
+public:
+    TinyTextTerminal(TinyTextWindow* window, Stream* stream = NULL);
+
+    // After the window is attached: default colours, the cursor at its top left.
+    // The window isn't cleared, Reset() does that.
+    void Begin(uint16_t foreColor = RGB444_WHITE, uint16_t backColor = RGB444_BLACK);
+    void Reset() { _ansi.Reset(); }
+
+    // Takes what the stream has, returns the number of bytes.
+    uint16_t Poll();
+    void Write(const char* str, size_t len);
+
+    uint32_t Bytes() { return _bytes; }
+
+    // Arduino Print
+    using ::Print::write;
+    virtual size_t write(uint8_t c);
+    virtual size_t write(const uint8_t* buffer, size_t size);
+};
+
+#endif
@@ -0,0 +1,454 @@
+#include "Arduino.h"
+#include "TinyTextWindow.h"
+
+#define WINDOW_COLUMNS 64 // widest window: 320 pixels of 5 pixel cells
+
+TinyTextWindow::TinyTextWindow()
+{
+    _tft = NULL;
+    _glyphs = NULL;
+    _fore = NULL;
+    _back = NULL;
+    _width = 0;
+    _height = 0;
+    _utf8.Clear();
+    _scrollback = NULL;
+    _view = 0;
+}
+
+TinyTextWindow::~TinyTextWindow()
+{
+    Detach();
+}
+
+bool TinyTextWindow::Attach(TinyTextDisplay* tft, uint8_t col, uint8_t row, uint8_t width, uint8_t height,
+                            uint16_t foreColor, uint16_t backColor)
+{
+    Detach();
+    if ((col >= tft->Columns()) || (row >= tft->Rows()) || (width == 0) || (height == 0))
+    {
+        return false;
+    }
+    _width = (width < tft->Columns() - col) ? width : tft->Columns() - col;
+    _height = (height < tft->Rows() - row) ? height : tft->Rows() - row;
+    uint16_t cells = (uint16_t)_width * _height;
+    // glyphs, padded to an even length, then the fore and back colours
+    _glyphs = (uint8_t*)malloc(cells + (cells & 1) + cells * 2 * sizeof(uint16_t));
+    if (_glyphs == NULL)
+    {
+        _width = 0;
+        _height = 0;
+        return false;
+    }
+    _fore = (uint16_t*)(_glyphs + cells + (cells & 1)); // aligned
+    _back = _fore + cells;
+    _tft = tft;
+    _col = col;
+    _row = row;
+    _foreColor = foreColor;
+    _backColor = backColor;
+    _wrap = true;
+    _scrollTop = 0;
+    _scrollBottom = _height - 1;
+    _utf8.Clear();
+    _view = 0;
+    Clear();
+    return true;
+}
+
+void TinyTextWindow::Detach()
+{
+    free(_glyphs);
+    _glyphs = NULL;
+    _fore = NULL;
+    _back = NULL;
+    _tft = NULL;
+    _width = 0;
+    _height = 0;
+}
+
+void TinyTextWindow::SetColors(uint16_t foreColor, uint16_t backColor)
+{
+    _foreColor = foreColor;
+    _backColor = backColor;
+}
+
+void TinyTextWindow::SetScrollRegion(uint8_t top, uint8_t bottom)
+{
+    ScrollBack(0);
+    if ((top > bottom) || (bottom >= _height))
+    {
+        top = 0;
+        bottom = _height - 1; // the whole window
+    }
+    _scrollTop = top;
+    _scrollBottom = bottom;
+}
+
+void TinyTextWindow::SetCursor(uint8_t col, uint8_t row)
+{
+    _cursorCol = (col < _width) ? col : _width - 1;
+    _cursorRow = (row < _height) ? row : _height - 1;
+}
+
+void TinyTextWindow::sendCells(uint8_t row, uint8_t col, uint8_t len, const uint8_t* glyphs, const uint16_t* fore, const uint16_t* back)
+{
+    // len cells from col of row as one run, trailing blanks as a fill
+    uint8_t end = len;
+    while ((end != 0) && (glyphs[end - 1] == 0) && (back[end - 1] == back[len - 1]))
+    {
+        end--;
+    }
+    if (end != 0)
+    {
+        _tft->DrawGlyphs(_col + col, _row + row, glyphs, fore, back, end);
+    }
+    if (end < len)
+    {
+        _tft->FillCells(_col + col + end, _row + row, len - end, 1, back[len - 1]);
+    }
+}
+
+void TinyTextWindow::drawRow(uint8_t row, uint8_t col, uint8_t len)
+{
+    // sends len cells of row from the copy, unless the row is scrolled back
+    if (viewing(row))
+    {
+        return;
+    }
+    uint16_t first = cell(col, row);
+    sendCells(row, col, len, _glyphs + first, _fore + first, _back + first);
+}
+
+void TinyTextWindow::drawRegion()
+{
+    // the scroll region as it is scrolled back: rows from the scrollback, then the
+    // live rows below them
+    uint8_t glyphs[WINDOW_COLUMNS];
+    uint16_t fore[WINDOW_COLUMNS];
+    uint16_t back[WINDOW_COLUMNS];
+    for (uint8_t row = _scrollTop; row <= _scrollBottom; row++)
+    {
+        uint16_t line = row - _scrollTop;
+        if (line >= _view)
+        {
+            uint16_t first = cell(0, _scrollTop + line - _view);
+            sendCells(row, 0, _width, _glyphs + first, _fore + first, _back + first);
+        }
+        else if (_scrollback->Get(_view - line - 1, glyphs, fore, back, _width))
+        {
+            sendCells(row, 0, _width, glyphs, fore, back);
+        }
+    }
+}
+
+void TinyTextWindow::setRow(uint8_t row, const uint8_t* glyphs, const uint16_t* fore, const uint16_t* back)
+{
+    // new contents for row (glyphs NULL for blank), sends the span that changed
+    uint16_t start = cell(0, row);
+    uint8_t first = _width;
+    uint8_t last = 0;
+    for (uint8_t i = 0; i < _width; i++)
+    {
+        uint8_t glyph = (glyphs == NULL) ? 0 : glyphs[i];
+        uint16_t foreColor = (glyphs == NULL) ? _backColor : fore[i];
+        uint16_t backColor = (glyphs == NULL) ? _backColor : back[i];
+        uint16_t c = start + i;
+        if ((_glyphs[c] != glyph) || (_fore[c] != foreColor) || (_back[c] != backColor))
+        {
+            _glyphs[c] = glyph;
+            _fore[c] = foreColor;
+            _back[c] = backColor;
+            first = (first < i) ? first : i;
+            last = i;
+        }
+    }
+    if (first < _width)
+    {
+        drawRow(row, first, last - first + 1);
+    }
+}
+
+bool TinyTextWindow::hardwareScroll()
+{
+    // the controller can scroll the region if it spans the screen and the
+    // scroll area is, or can be made, the region's rows
+    uint8_t row = _row + _scrollTop;
+    uint8_t rows = _scrollBottom - _scrollTop + 1;
+    if ((_col != 0) || (_width != _tft->Columns()) || (rows < 2))
+    {
+        return false;
+    }
+    return _tft->SetScrollArea(row, rows); // true at once if it already is, false in rotations 1 and 3
+}
+
+void TinyTextWindow::ScrollUp(bool history)
+{
+    if (_tft == NULL)
+    {
+        return;
+    }
+    if (history && (_scrollback != NULL) && (_scrollTop == 0))
+    {
+        // only rows leaving the top of the window, as a terminal does
+        uint16_t top = cell(0, _scrollTop);
+        _scrollback->Append(_glyphs + top, _fore + top, _back + top, _width);
+        if (_view != 0)
+        {
+            // keep showing the same rows
+            _view = (_view < _scrollback->Lines()) ? _view + 1 : _view;
+        }
+    }
+    if ((_view == 0) && hardwareScroll())
+    {
+        // the copy moves up, the panel is moved by the controller
+        uint16_t first = cell(0, _scrollTop);
+        uint16_t cells = (uint16_t)(_scrollBottom - _scrollTop) * _width;
+        memmove(_glyphs + first, _glyphs + first + _width, cells);
+        memmove(_fore + first, _fore + first + _width, cells * sizeof(uint16_t));
+        memmove(_back + first, _back + first + _width, cells * sizeof(uint16_t));
+        uint16_t bottom = cell(0, _scrollBottom);
+        for (uint8_t i = 0; i < _width; i++)
+        {
+            _glyphs[bottom + i] = 0;
+            _fore[bottom + i] = _backColor;
+            _back[bottom + i] = _backColor;
+        }
+        _tft->ScrollAreaUp(_backColor);
+        return;
+    }
+    // each row takes the one below, only what differs is sent (nothing while scrolled back)
+    for (uint8_t row = _scrollTop; row < _scrollBottom; row++)
+    {
+        uint16_t below = cell(0, row + 1);
+        setRow(row, _glyphs + below, _fore + below, _back + below);
+    }
+    setRow(_scrollBottom, NULL, NULL, NULL);
+}
+
+void TinyTextWindow::ScrollDown()
+{
+    if (_tft == NULL)
+    {
+        return;
+    }
+    // each row takes the one above, from the bottom up
+    for (uint8_t row = _scrollBottom; row > _scrollTop; row--)
+    {
+        uint16_t above = cell(0, row - 1);
+        setRow(row, _glyphs + above, _fore + above, _back + above);
+    }
+    setRow(_scrollTop, NULL, NULL, NULL);
+}
+
+void TinyTextWindow::Clear()
+{
+    if (_tft == NULL)
+    {
+        return;
+    }
+    uint16_t cells = (uint16_t)_width * _height;
+    memset(_glyphs, 0, cells);
+    for (uint16_t i = 0; i < cells; i++)
+    {
+        _fore[i] = _backColor;
+        _back[i] = _backColor;
+    }
+    _tft->FillCells(_col, _row, _width, _height, _backColor);
+    _cursorCol = 0;
+    _cursorRow = 0;
+    _view = 0;
+}
+
+void TinyTextWindow::ClearToEndOfLine()
+{
+    ClearRect(_cursorCol, _cursorRow, _width, 1);
+}
+
+void TinyTextWindow::ClearRect(uint8_t col, uint8_t row, uint8_t w, uint8_t h)
+{
+    if ((_tft == NULL) || (col >= _width) || (row >= _height))
+    {
+        return;
+    }
+    w = (w < _width - col) ? w : _width - col;
+    h = (h < _height - row) ? h : _height - row;
+    for (uint8_t r = row; r < row + h; r++)
+    {
+        uint16_t start = cell(col, r);
+        for (uint16_t i = start; i < start + w; i++)
+        {
+            _glyphs[i] = 0;
+            _fore[i] = _backColor;
+            _back[i] = _backColor;
+        }
+    }
+    // one fill for the block, less any rows that are scrolled back
+    uint8_t end = row + h;
+    while (row < end)
+    {
+        while ((row < end) && viewing(row))
+        {
+            row++;
+        }
+        uint8_t first = row;
+        while ((row < end) && !viewing(row))
+        {
+            row++;
+        }
+        if (row > first)
+        {
+            _tft->FillCells(_col + col, _row + first, w, row - first, _backColor);
+        }
+    }
+}
+
+void TinyTextWindow::Redraw()
+{
+    if (_tft == NULL)
+    {
+        return;
+    }
+    for (uint8_t row = 0; row < _height; row++)
+    {
+        if ((row < _scrollTop) || (row > _scrollBottom))
+        {
+            drawRow(row, 0, _width);
+        }
+    }
+    drawRegion();
+}
+
+void TinyTextWindow::SetScrollback(TinyTextScrollback* scrollback)
+{
+    ScrollBack(0);
+    _scrollback = scrollback;
+}
+
+void TinyTextWindow::ScrollBack(uint16_t lines)
+{
+    if (_tft == NULL)
+    {
+        return;
+    }
+    uint16_t most = (_scrollback != NULL) ? _scrollback->Lines() : 0;
+    lines = (lines < most) ? lines : most;
+    if (lines != _view)
+    {
+        _view = lines;
+        drawRegion();
+    }
+}
+
+void TinyTextWindow::PageUp()
+{
+    ScrollBack(_view + (_scrollBottom - _scrollTop + 1));
+}
+
+void TinyTextWindow::PageDown()
+{
+    uint8_t page = _scrollBottom - _scrollTop + 1;
+    ScrollBack((_view > page) ? _view - page : 0);
+}
+
+void TinyTextWindow::newLine()
+{
+    _cursorCol = 0;
+    if (_cursorRow == _scrollBottom)
+    {
+        ScrollUp();
+    }
+    else if (_cursorRow + 1 < _height)
+    {
+        _cursorRow++;
+    }
+}
+
+void TinyTextWindow::Write(char chr)
+{
+    Write(&chr, 1);
+}
+
+void TinyTextWindow::Write(const char* str)
+{
+    Write(str, strlen(str));
+}
+
+void TinyTextWindow::Write(const char* str, size_t len)
+{
+    if (_tft == NULL)
+    {
+        return;
+    }
+    uint8_t pending = _utf8.Finish(str, len);
+    if (pending != 0)
+    {
+        writeText(_utf8.Bytes(), pending);
+    }
+    writeText(str, _utf8.Hold(str, len));
+}
+
+void TinyTextWindow::writeText(const char* str, size_t len)
+{
+    const char* end = str + len;
+    while (str < end)
+    {
+        char chr = *str;
+        if (chr == '\n')
+        {
+            newLine();
+            str++;
+            continue;
+        }
+        if (chr == '\r')
+        {
+            _cursorCol = 0;
+            str++;
+            continue;
+        }
+        if (_cursorCol >= _width)
+        {
+            if (!_wrap)
+            {
+                TinyTextTFT::DecodeUTF8(str, end); // off the right edge
+                continue;
+            }
+            newLine();
+        }
+        // printable run up to the next control character or the end of the row,
+        // sending the span of cells that changed
+        uint8_t first = _width;
+        uint8_t last = 0;
+        while ((str < end) && (*str != '\n') && (*str != '\r') && (_cursorCol < _width))
+        {
+            uint8_t glyph = TinyTextTFT::GlyphIndex(TinyTextTFT::DecodeUTF8(str, end));
+            uint16_t foreColor = (glyph == 0) ? _backColor : _foreColor; // fore colour of a blank cell doesn't matter
+            uint16_t c = cell(_cursorCol, _cursorRow);
+            if ((_glyphs[c] != glyph) || (_fore[c] != foreColor) || (_back[c] != _backColor))
+            {
+                _glyphs[c] = glyph;
+                _fore[c] = foreColor;
+                _back[c] = _backColor;
+                first = (first < _cursorCol) ? first : _cursorCol;
+                last = _cursorCol;
+            }
+            _cursorCol++;
+        }
+        if (first < _width)
+        {
+            drawRow(_cursorRow, first, last - first + 1);
+        }
+    }
+}
+
+size_t TinyTextWindow::write(uint8_t c)
+{
+    Write((const char*)&c, 1);
+    return 1;
+}
+
+size_t TinyTextWindow::write(const uint8_t* buffer, size_t size)
+{
+    Write((const char*)buffer, size);
+    return size;
+}
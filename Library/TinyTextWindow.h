@@ -0,0 +1,111 @@
+#ifndef TinyTextWindow_h
+#define TinyTextWindow_h
+
+#include "TinyTextTFT.h"
+#include "TinyTextScrollback.h"
+
+/*
+  A rectangle of cells with a console of its own: a cursor, colours, wrapping
+  and a scroll region, so a log, a status bar and a block of readings can share
+  one screen without redrawing each other.
+
+  Each window keeps a copy of its cells (5 bytes each) and only ever draws inside
+  its rectangle. Scrolling moves the copy and resends, row by row, the span of
+  cells that changed, each span as one run in a single address window, so blank
+  or repeated rows cost nothing. A window as wide as the screen scrolls with the
+  controller's hardware scroll instead (see TinyTextTFT::SetScrollArea) when the
+  rotation allows it and no other window has the scroll area: then a scroll is a
+  few bytes of commands plus clearing one row.
+
+  With a TinyTextScrollback set, rows scrolled off the top of the window are
+  kept and the region can be scrolled back through them a page at a time,
+  each row redrawn as one run.
+
+  Windows shouldn't overlap. Write takes UTF-8, '\n' moves to the start of the
+  next row (scrolling when the cursor is on the bottom row of the scroll region),
+  '\r' to the start of the current row.
+*/
+
+class TinyTextWindow : public Print
+{
+private:
+    TinyTextDisplay* _tft;
+    uint8_t   _col;       // on the screen
+    uint8_t   _row;
+    uint8_t   _width;
+    uint8_t   _height;
+    uint8_t*  _glyphs;    // what is in each cell, _width x _height
+    uint16_t* _fore;
+    uint16_t* _back;
+    uint8_t   _cursorCol;
+    uint8_t   _cursorRow;
+    uint8_t   _scrollTop; // scroll region, rows of the window
+    uint8_t   _scrollBottom;
+    uint16_t  _foreColor;
+    uint16_t  _backColor;
+    bool      _wrap;
+    TinyTextScrollback* _scrollback;
+    uint16_t  _view;      // rows the scroll region is scrolled back by, 0 for the live rows
+    TinyTextUTF8Hold _utf8;
+
+    uint16_t cell(uint8_t col, uint8_t row) { return (uint16_t)row * _width + col; }
+    bool viewing(uint8_t row) { return (_view != 0) && (row >= _scrollTop) && (row <= _scrollBottom); }
+    void sendCells(uint8_t row, uint8_t col, uint8_t len, const uint8_t* glyphs, const uint16_t* fore, const uint16_t* back);
+    void drawRow(uint8_t row, uint8_t col, uint8_t len);
+    void drawRegion();
+    void setRow(uint8_t row, const uint8_t* glyphs, const uint16_t* fore, const uint16_t* back);
+    bool hardwareScroll();
+    void newLine();
+    void writeText(const char* str, size_t len);
+
+public:
+    TinyTextWindow();
+    ~TinyTextWindow();
+
+    // Allocates the copy of the cells and blanks the window, false if there isn't
+    // the RAM. The rectangle is clipped to the screen.
+    bool Attach(TinyTextDisplay* tft, uint8_t col, uint8_t row, uint8_t width, uint8_t height,
+                uint16_t foreColor = RGB444_WHITE, uint16_t backColor = RGB444_BLACK);
+    void Detach();
+    uint8_t Columns() { return _width; }
+    uint8_t Rows()    { return _height; }
+
+    void SetColors(uint16_t foreColor, uint16_t backColor);
+    void SetWrap(bool wrap) { _wrap = wrap; } // false: text past the right edge is dropped
+    // rows top .. bottom of the window scroll, the rest stay put
+    void SetScrollRegion(uint8_t top, uint8_t bottom);
+    void SetCursor(uint8_t col, uint8_t row);
+    uint8_t CursorColumn() { return _cursorCol; }
+    uint8_t CursorRow()    { return _cursorRow; }
+
+    void Clear(); // blanks the window with the background colour, cursor to the top left
+    void ClearToEndOfLine();
+    void ClearRect(uint8_t col, uint8_t row, uint8_t w, uint8_t h); // in one fill
+    void ScrollUp(bool history = true); // the scroll region, by one row
+    void ScrollDown();                  // never with the hardware scroll, it only goes up
+    void Redraw();                      // sends every cell again, e.g. after SetRotation
+
+    // Scrollback: rows scrolling off the top of the window are added to scrollback
+    // (one per window), not those leaving a scroll region that starts lower down
+    // or taken out by ScrollUp(false), as a terminal deleting lines does.
+    // ScrollBack shows the region lines rows back, 0 for the live rows, and PageUp
+    // and PageDown move by the height of the region. Writing carries on while
+    // scrolled back, the live rows are shown again by ScrollBack(0), and rows that
+    // scroll off meanwhile leave the view where it is.
+    void SetScrollback(TinyTextScrollback* scrollback);
+    void ScrollBack(uint16_t lines);
+    uint16_t ScrolledBack() { return _view; }
+    void PageUp();
+    void PageDown();
+
+    void Write(char chr);
+    void Write(const char* str);
+    void Write(const char* str, size_t len);
+
+    // Arduino Print
+    using ::Print::write;
+    virtual size_t write(uint8_t c);
+    virtual size_t write(const uint8_t* buffer, size_t size);
+};
+
+#endif
@@ -0,0 +1,265 @@
+#include <SPI.h>
+#include <TinyTextTFT.h>
+#include <TinyTextField.h>
+
+// Standard scenarios for comparing changes to the library.
+// Uncomment TINYTEXT_STATS in TinyTextTFT.h to also get the bus cost of each
+// scenario: bytes, CS/DC toggles, transactions, the time the bytes alone
+// take at BENCH_SPI_CLOCK, CASET/PASET sent out of those needed, blends and cells.
+
+#define WEMOS_D1_MINI_D2 4
+#define WEMOS_D1_MINI_D3 0
+#define WEMOS_D1_MINI_D4 2   // built in LED
+
+// Configurable pins (MOSI, MISO and SCK are predefined):
+#define TFT_CS    WEMOS_D1_MINI_D2
+#define TFT_RST   WEMOS_D1_MINI_D3
+#define TFT_DC    WEMOS_D1_MINI_D4
+
+#define BENCH_SPI_CLOCK 24000000
+
+TinyTextTFT tft = TinyTextTFT(TFT_CS, TFT_DC, TFT_RST);
+
+static const char line[] = "The quick brown fox jumps over the lazy dog. 0123456789 !@#$%^&*";
+
+#define BENCH_FIELDS 40
+TinyTextField fields[BENCH_FIELDS];
+
+void setup()
+{
+  Serial.begin(115200);
+  delay(500);
+  Serial.println();
+  Serial.println("TinyText Benchmark!");
+
+  tft.Begin();
+  tft.EnableGrid();
+}
+
+void report(const char* name, unsigned long us)
+{
+  Serial.print(name);
+  Serial.print(F(" us="));
+  Serial.print(us);
+#ifdef TINYTEXT_STATS
+  const TinyTextStats& stats = tft.GetStats();
+  uint32_t bytes = stats.commandBytes + stats.dataBytes;
+  Serial.print(F(" bytes="));
+  Serial.print(bytes);
+  Serial.print(F(" cmd="));
+  Serial.print(stats.commandBytes);
+  Serial.print(F(" cs="));
+  Serial.print(stats.csToggles);
+  Serial.print(F(" dc="));
+  Serial.print(stats.dcToggles);
+  Serial.print(F(" transactions="));
+  Serial.print(stats.transactions);
+  Serial.print(F(" busUs="));
+  Serial.print((unsigned long)((uint64_t)bytes * 8 * 1000000 / BENCH_SPI_CLOCK));
+  Serial.print(F(" windows="));
+  Serial.print(stats.columnSets + stats.pageSets);
+  Serial.print(F("/"));
+  Serial.print(stats.columnSets + stats.columnSkips + stats.pageSets + stats.pageSkips);
+  Serial.print(F(" blends="));
+  Serial.print(stats.blendCalls);
+  Serial.print(F(" glyphs="));
+  Serial.print(stats.glyphsDrawn);
+  Serial.print(F(" blanks="));
+  Serial.print(stats.blankCells);
+#endif
+  Serial.println();
+}
+
+void startScenario()
+{
+#ifdef TINYTEXT_STATS
+  tft.ResetStats();
+#endif
+}
+
+unsigned long benchFill()
+{
+  startScenario();
+  unsigned long start = micros();
+  tft.FillScreen(RGB444_BLACK);
+  return micros() - start;
+}
+
+unsigned long benchDrawChar()
+{
+  // every cell through DrawChar (1536 in every rotation)
+  startScenario();
+  unsigned long start = micros();
+  for (uint8_t row = 0; row < tft.Rows(); row++)
+  {
+    for (uint8_t col = 0; col < tft.Columns(); col++)
+    {
+      tft.DrawChar(col, row, line[col], 0xFFF, 0x07D);
+    }
+  }
+  return micros() - start;
+}
+
+unsigned long benchDrawString()
+{
+  startScenario();
+  unsigned long start = micros();
+  for (uint8_t row = 0; row < tft.Rows(); row++)
+  {
+    tft.DrawString(0, row, line, tft.Columns(), 0xFFF, 0x07D);
+  }
+  return micros() - start;
+}
+
+unsigned long benchClearRows()
+{
+  // every row blanked, one window per row
+  startScenario();
+  unsigned long start = micros();
+  for (uint8_t row = 0; row < tft.Rows(); row++)
+  {
+    tft.FillCells(0, row, tft.Columns(), 1, 0x07D);
+  }
+  return micros() - start;
+}
+
+unsigned long benchSingleCells()
+{
+  // 100 scattered single cell updates
+  startScenario();
+  unsigned long start = micros();
+  for (uint8_t i = 0; i < 100; i++)
+  {
+    tft.DrawChar((i * 7) % tft.Columns(), (i * 5) % tft.Rows(), '0' + (i % 10), 0xFF0, 0x000);
+  }
+  return micros() - start;
+}
+
+unsigned long benchFlush()
+{
+  // about 5% of the cells change between frames
+  uint8_t counter = millis();
+  for (uint8_t row = 0; row < tft.Rows(); row += 2)
+  {
+    tft.Print(0, row, line, 0x000, 0xEEE);
+  }
+  tft.Flush();
+  startScenario();
+  unsigned long start = micros();
+  for (uint8_t row = 0; row < tft.Rows(); row += 2)
+  {
+    tft.Put(10, row, '0' + (counter % 10), 0xF00, 0xEEE);
+    tft.Put(11, row, '0' + (row % 10), 0xF00, 0xEEE);
+    tft.Put(40, row, 'A' + (counter % 26), 0xF00, 0xEEE);
+    tft.Put(41, row, 'a' + (counter % 26), 0xF00, 0xEEE);
+    tft.Put(42, row, '#', 0xF00, 0xEEE);
+    tft.Put(43, row, '#', 0xF00, 0xEEE);
+  }
+  tft.Flush();
+  return micros() - start;
+}
+
+int32_t fieldValue(uint8_t field, uint16_t tick)
+{
+  // telemetry: counters, slowly moving readings and a few that jump about
+  switch (field % 4)
+  {
+  case 0: return tick;
+  case 1: return 2150 + (tick * (field + 1)) % 37;
+  case 2: return (tick * 7919L) % 100000;
+  default: return -40 + (tick % 3);
+  }
+}
+
+unsigned long benchFieldsDrawChar()
+{
+  // 40 fields at 10Hz for a second the old way: formatted, then every digit through DrawChar
+  startScenario();
+  unsigned long start = micros();
+  for (uint16_t tick = 0; tick < 10; tick++)
+  {
+    for (uint8_t field = 0; field < BENCH_FIELDS; field++)
+    {
+      char text[9];
+      snprintf(text, sizeof(text), "%8ld", (long)fieldValue(field, tick));
+      for (uint8_t i = 0; i < 8; i++)
+      {
+        tft.DrawChar((field % 4) * 12 + i, 2 + field / 4, text[i], 0x0F0, 0x000);
+      }
+    }
+  }
+  return micros() - start;
+}
+
+unsigned long benchFields()
+{
+  // the same with TinyTextField: only the digits that change are sent
+  for (uint8_t field = 0; field < BENCH_FIELDS; field++)
+  {
+    fields[field].Attach(&tft, (field % 4) * 12, 2 + field / 4, 8, TINYTEXT_ALIGN_RIGHT, 0x0F0, 0x000);
+  }
+  startScenario();
+  unsigned long start = micros();
+  for (uint16_t tick = 0; tick < 10; tick++)
+  {
+    for (uint8_t field = 0; field < BENCH_FIELDS; field++)
+    {
+      fields[field].SetInt(fieldValue(field, tick));
+    }
+  }
+  return micros() - start;
+}
+
+unsigned long cellsPerSecond(uint32_t bytes, uint32_t us)
+{
+  // 5x10 pixels of 2 bytes a cell
+  return (us == 0) ? 0 : (unsigned long)(bytes / 100.0 * 1000000.0 / us);
+}
+
+void reportPipeline()
+{
+  // cells per second each stage manages while it is busy
+  const TinyTextPipelineStats& stats = tft.GetPipelineStats();
+  Serial.print(F("  render cells/s="));
+  Serial.print(cellsPerSecond(stats.bytes, stats.renderMicros));
+  Serial.print(F(" send cells/s="));
+  Serial.print(cellsPerSecond(stats.bytes, stats.sendMicros));
+  Serial.print(F(" stallUs="));
+  Serial.println((unsigned long)stats.stallMicros);
+}
+
+unsigned long benchPipeline(bool threaded)
+{
+  // drawString with the rendering and sending pipelined (threaded: on both ESP32 cores)
+  if (!tft.EnablePipeline(4, threaded))
+  {
+    return 0;
+  }
+  tft.ResetPipelineStats();
+  unsigned long us = benchDrawString();
+  tft.DisablePipeline();
+  return us;
+}
+
+void loop()
+{
+  for (uint8_t rotation = 0; rotation < 4; rotation++)
+  {
+    tft.SetRotation(rotation);
+    Serial.print(F("rotation "));
+    Serial.println(rotation);
+    report("fill       ", benchFill());
+    report("drawChar   ", benchDrawChar());
+    report("drawString ", benchDrawString());
+    report("clearRows  ", benchClearRows());
+    report("singleCells", benchSingleCells());
+    report("flush5%    ", benchFlush());
+    report("fieldsChar ", benchFieldsDrawChar());
+    report("fields     ", benchFields());
+    report("pipeline   ", benchPipeline(false));
+    reportPipeline();
+    report("pipeline2  ", benchPipeline(true));
+    reportPipeline();
+  }
+  delay(10000);
+}
@@ -0,0 +1,36 @@
+#include <SPI.h>
+#include <TinyTextTFT.h>
+#include <TinyTextRemote.h>
+
+// Shows a screen sent from a PC over the serial port, see TinyTextProtocol.h
+// for the commands and Tools/Remote for the encoder that sends only what changed.
+
+#define WEMOS_D1_MINI_D2 4
+#define WEMOS_D1_MINI_D3 0
+#define WEMOS_D1_MINI_D4 2   // built in LED
+
+// Configurable pins (MOSI, MISO and SCK are predefined):
+#define TFT_CS    WEMOS_D1_MINI_D2
+#define TFT_RST   WEMOS_D1_MINI_D3
+#define TFT_DC    WEMOS_D1_MINI_D4
+
+#define REMOTE_BAUD 921600
+
+TinyTextTFT tft = TinyTextTFT(TFT_CS, TFT_DC, TFT_RST);
+TinyTextRemote remote = TinyTextRemote(&tft, &Serial);
+
+void setup()
+{
+  Serial.setRxBufferSize(1024); // a full screen is about 1K, most updates far less
+  Serial.begin(REMOTE_BAUD);
+
+  tft.Begin();
+  tft.SetRotation(1);
+  tft.EnableGrid(); // updates are collected and sent at each FLUSH
+  tft.FillScreen(RGB444_BLACK);
+}
+
+void loop()
+{
+  remote.Poll();
+}
@@ -3177,6 +3177,29 @@ unsigned long testSimple()
   return micros() - start;
 }
 
+unsigned long testString()
+{
+  static const char line[] = "The quick brown fox jumps over the lazy dog. 0123456789 !@#$%^&*";
+  unsigned long start = micros();
+  for (uint8_t row = 0; row < tft.Rows(); row++)
+  {
+    tft.DrawString(0, row, line, tft.Columns(), (row & 1) ? 0xFFF : 0x000, (row & 1) ? 0x07D : 0xEEE);
+  }
+  return micros() - start;
+}
+
+unsigned long testConsole()
+{
+  unsigned long start = micros();
+  tft.SetConsoleColors(0x0F0, RGB444_BLACK);
+  for (uint8_t i = 0; i < 100; i++)
+  {
+    tft.print(F("Log line "));
+    tft.println(i);
+  }
+  return micros() - start;
+}
+
 void loop() 
 {
   tft.SetRotation(3);
@@ -3188,6 +3211,14 @@ void loop()
   Serial.print(F("testText       "));
   Serial.println(testText());
   delay(10000);
+  Serial.print(F("testString     "));
+  Serial.println(testString());
+  delay(10000);
+  tft.SetRotation(0); // hardware scrolling
+  tft.FillScreen(RGB444_BLACK);
+  Serial.print(F("testConsole    "));
+  Serial.println(testConsole());
+  delay(10000);
   //Serial.print(F("testColours       "));
   //Serial.println(testColours());
   //delay(10000);
@@ -0,0 +1,44 @@
+#include <SPI.h>
+#include <TinyTextTFT.h>
+#include <TinyTextWindow.h>
+#include <TinyTextTerminal.h>
+
+// A VT100 / ANSI terminal on the whole screen for whatever arrives over the
+// serial port, e.g. the console of a Linux board (set its terminal to 48x32,
+// "stty cols 48 rows 32"), with colours, cursor movement and scroll regions.
+// In rotation 0 it scrolls with the controller's hardware scroll.
+// Tools/Terminal measures how many bytes a second it keeps up with.
+
+#define WEMOS_D1_MINI_D2 4
+#define WEMOS_D1_MINI_D3 0
+#define WEMOS_D1_MINI_D4 2   // built in LED
+
+// Configurable pins (MOSI, MISO and SCK are predefined):
+#define TFT_CS    WEMOS_D1_MINI_D2
+#define TFT_RST   WEMOS_D1_MINI_D3
+#define TFT_DC    WEMOS_D1_MINI_D4
+
+#define TERMINAL_BAUD 115200
+
+TinyTextTFT tft = TinyTextTFT(TFT_CS, TFT_DC, TFT_RST);
+TinyTextWindow screen;
+TinyTextTerminal terminal = TinyTextTerminal(&screen, &Serial);
+
+void setup()
+{
+  Serial.setRxBufferSize(1024); // room for a burst while a scroll is sent
+  Serial.begin(TERMINAL_BAUD);
+
+  tft.Begin();
+  tft.SetRotation(0);
+  tft.FillScreen(RGB444_BLACK);
+
+  screen.Attach(&tft, 0, 0, tft.Columns(), tft.Rows());
+  terminal.Begin(0xCCC, RGB444_BLACK);
+  terminal.print(F("\x1b[1;32mTinyTextTerminal\x1b[0m ready\r\n"));
+}
+
+void loop()
+{
+  terminal.Poll();
+}
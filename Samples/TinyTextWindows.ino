@@ -0,0 +1,86 @@
+#include <SPI.h>
+#include <TinyTextTFT.h>
+#include <TinyTextWindow.h>
+
+// A scrolling log of events, a status bar and a block of readings on one
+// screen, each in a TinyTextWindow of its own. In rotation 0 the events window
+// spans the screen so it scrolls with the controller's hardware scroll.
+// The events that scroll off are kept: send 'u' or 'd' over the serial port to
+// page up and down through them, 'l' to go back to the live events.
+
+#define WEMOS_D1_MINI_D2 4
+#define WEMOS_D1_MINI_D3 0
+#define WEMOS_D1_MINI_D4 2   // built in LED
+
+// Configurable pins (MOSI, MISO and SCK are predefined):
+#define TFT_CS    WEMOS_D1_MINI_D2
+#define TFT_RST   WEMOS_D1_MINI_D3
+#define TFT_DC    WEMOS_D1_MINI_D4
+
+TinyTextTFT tft = TinyTextTFT(TFT_CS, TFT_DC, TFT_RST);
+TinyTextWindow status;
+TinyTextWindow events;
+TinyTextWindow readings;
+TinyTextScrollback history;
+
+uint32_t lines = 0;
+
+void setup()
+{
+  Serial.begin(115200);
+
+  tft.Begin();
+  tft.SetRotation(0);
+  tft.FillScreen(RGB444_BLACK);
+
+  uint8_t rows = tft.Rows();
+  status.Attach(&tft, 0, 0, tft.Columns(), 1, RGB444_BLACK, 0xFF0);
+  events.Attach(&tft, 0, 1, tft.Columns(), rows - 5, RGB444_WHITE, RGB444_BLACK);
+  readings.Attach(&tft, 0, rows - 4, 24, 4, RGB444_GREEN, 0x004);
+
+  if (history.Begin(8192)) // a few hundred events
+  {
+    events.SetScrollback(&history);
+  }
+}
+
+void loop()
+{
+  switch (Serial.read())
+  {
+    case 'u': events.PageUp();      break;
+    case 'd': events.PageDown();    break;
+    case 'l': events.ScrollBack(0); break;
+  }
+
+  events.SetColors((lines % 10 == 0) ? RGB444_RED : RGB444_WHITE, RGB444_BLACK);
+  events.print(F("event "));
+  events.print(lines);
+  events.print(F(" at "));
+  events.print(millis());
+  events.println(F(" ms"));
+  lines++;
+
+  status.Write('\r');
+  status.print(F("up "));
+  status.print(millis() / 1000);
+  status.print(F("s, "));
+  status.print(lines);
+  status.print(F(" lines, "));
+  status.print(history.Lines());
+  status.print(F(" kept in "));
+  status.print(history.Used());
+  status.print(F(" bytes"));
+  status.ClearToEndOfLine();
+
+  for (uint8_t i = 0; i < 4; i++)
+  {
+    readings.SetCursor(0, i);
+    readings.print(F("ch"));
+    readings.print(i);
+    readings.print(F(" = "));
+    readings.print((lines * (i + 3)) % 1000);
+    readings.ClearToEndOfLine();
+  }
+  delay(50);
+}
@@ -0,0 +1,307 @@
+/*
+  FlushAsync and Flush(budgetMicros) on a PC, against the mock SPI bus of
+  Tools/Bench, which completes every transfer on a simulated clock.
+
+    g++ -std=c++11 -O2 -I../Bench -I../../Library AsyncTest.cpp ../Bench/ArduinoMock.cpp ../../Library/TinyTextTFT.cpp \
+        ../../Library/TinyTextBus.cpp ../../Library/TinyTextBlend.cpp ../../Library/TinyTextCanvas.cpp ../../Library/TinyTextClock.cpp \
+        ../../Library/TinyTextPipeline.cpp -o AsyncTest
+    ./AsyncTest [SPI MHz]
+
+  In every rotation a screen of random cells is put on the shadow grid and
+  sent four ways, each to a canvas of its own: with Flush(), with FlushAsync
+  and Poll() (a DrawString and a FillCells going in between the polls, and the
+  same calls made after the Flush() for the reference), in slices with
+  Flush(budgetMicros), and with FlushAsync and Poll() again on a bus that sends
+  each line in the background (StartBytes as DMA, MockStartBytes), with loop()
+  doing LOOP_MICROS of other work between the polls. It checks:
+    - the four pictures are the same, pixel for pixel
+    - after every Poll() on the pin bus and every slice the transaction has
+      ended and CS is high
+    - on the background bus no Poll() waits for a line: it takes no longer than
+      a window's commands, IsBusy() is true between polls while a line is still
+      going out, and nothing is sent, nor CS or DC changed, until it has gone
+    - the callback is called once, at the end, and FlushProgress() only rises
+    - no slice takes longer on the bus than its budget and one more scanline
+  Exits 1 if anything fails.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "ArduinoMock.h"
+#include "TinyTextTFT.h"
+#include "TinyTextTFTImpl.h" // TinyTextTFTBus<BackgroundBus> is built here
+
+#define PIN_CS 10
+#define PIN_DC 9
+
+#define BUDGET_MICROS 500
+#define LOOP_MICROS   20 // what loop() does between polls
+
+// The pin bus with a DMA engine: StartBytes hands the whole line over and the
+// mock sends it in the background.
+class BackgroundBus : public TinyTextPinBus
+{
+public:
+    BackgroundBus() : TinyTextPinBus(PIN_CS, PIN_DC) { }
+
+    uint16_t StartBytes(const uint8_t* data, uint16_t len)
+    {
+        MockStartBytes(data, len);
+        return len;
+    }
+    bool Busy()
+    {
+        if (!MockBusy())
+        {
+            return false;
+        }
+        MockAdvance(50); // reading the status takes time too, so waiting ends
+        return true;
+    }
+};
+
+static uint32_t failures = 0;
+static uint32_t callbacks = 0;
+
+static void fail(const char* what, uint8_t rotation)
+{
+    if (failures < 20)
+    {
+        printf("rotation %u: %s\n", rotation, what);
+    }
+    failures++;
+}
+
+static void flushed()
+{
+    callbacks++;
+}
+
+template <class Bus>
+static void begin(TinyTextTFTBus<Bus>& tft, TinyTextCanvas& canvas, uint32_t freq, uint8_t rotation)
+{
+    MockReset(PIN_CS, PIN_DC);
+    MockAttach(&canvas);
+    tft.SetFrequency(freq);
+    tft.Begin();
+    tft.EnableGrid();
+    tft.SetRotation(rotation);
+    tft.FillScreen(0x07D);
+    tft.Flush();
+
+    uint32_t seed = rotation + 1;
+    for (uint16_t i = 0; i < 1200; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        uint8_t col = (seed >> 8) % tft.Columns();
+        uint8_t row = (seed >> 16) % tft.Rows();
+        tft.Put(col, row, ' ' + (seed >> 24) % 95, (seed >> 4) & 0xFFF, 0x07D);
+    }
+    tft.Print(0, tft.Rows() - 1, "the bottom row, one run", 0xFF0, 0x000);
+}
+
+template <class Bus>
+static void between(TinyTextTFTBus<Bus>& tft)
+{
+    // drawing calls made while the flush is going on
+    tft.DrawString(2, 3, "drawn in between", 16, 0xFFF, 0x00F);
+    tft.FillCells(10, 8, 6, 3, 0xF00);
+}
+
+static bool released()
+{
+    return !MockInTransaction() && !MockSelected();
+}
+
+static uint32_t compare(TinyTextCanvas& a, TinyTextCanvas& b)
+{
+    uint32_t different = 0;
+    for (uint16_t y = 0; y < a.Height(); y++)
+    {
+        for (uint16_t x = 0; x < a.Width(); x++)
+        {
+            different += (a.GetPixel(x, y) != b.GetPixel(x, y));
+        }
+    }
+    return different;
+}
+
+int main(int argc, char** argv)
+{
+    double mhz = (argc > 1) ? atof(argv[1]) : 24;
+    if (mhz <= 0)
+    {
+        printf("usage: AsyncTest [SPI MHz]\n");
+        return 1;
+    }
+    uint32_t freq = (uint32_t)(mhz * 1e6);
+    // a scanline of the widest run and its window (CASET, PASET and RAMWR), rounded up
+    uint64_t lineNanos = (640 + 11) * 8000000000ULL / freq + 1000;
+
+    for (uint8_t rotation = 0; rotation < 4; rotation++)
+    {
+        TinyTextCanvas reference;
+        TinyTextCanvas polled;
+        TinyTextCanvas sliced;
+        TinyTextCanvas background;
+        if (!reference.Begin() || !polled.Begin() || !sliced.Begin() || !background.Begin())
+        {
+            printf("can't allocate the canvases\n");
+            return 1;
+        }
+
+        // blocking
+        {
+            TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+            begin(tft, reference, freq, rotation);
+            tft.Flush();
+            between(tft);
+        }
+
+        // FlushAsync and Poll
+        uint32_t polls = 0;
+        {
+            TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+            begin(tft, polled, freq, rotation);
+            callbacks = 0;
+            if (!tft.FlushAsync(flushed))
+            {
+                fail("FlushAsync failed", rotation);
+                continue;
+            }
+            uint8_t progress = 0;
+            bool busy = true;
+            while (busy)
+            {
+                if (!released())
+                {
+                    fail("the bus is held between polls", rotation);
+                }
+                if (callbacks != 0)
+                {
+                    fail("the callback came early", rotation);
+                }
+                if (tft.FlushProgress() < progress)
+                {
+                    fail("the progress went back", rotation);
+                }
+                progress = tft.FlushProgress();
+                if (++polls == 20)
+                {
+                    between(tft);
+                }
+                busy = tft.Poll();
+            }
+            if (polls < 20)
+            {
+                between(tft);
+            }
+            if ((callbacks != 1) || tft.IsBusy() || (tft.FlushProgress() != 100) || !released())
+            {
+                fail("not finished properly", rotation);
+            }
+        }
+
+        // Flush(budgetMicros)
+        uint32_t slices = 0;
+        uint64_t longest = 0;
+        {
+            TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+            begin(tft, sliced, freq, rotation);
+            bool more = true;
+            while (more)
+            {
+                uint64_t start = MockNanos();
+                more = tft.Flush((uint32_t)BUDGET_MICROS);
+                uint64_t took = MockNanos() - start;
+                longest = (took > longest) ? took : longest;
+                if (took > BUDGET_MICROS * 1000ULL + lineNanos)
+                {
+                    fail("a slice overran its budget by more than a line", rotation);
+                }
+                if (!released())
+                {
+                    fail("the bus is held between slices", rotation);
+                }
+                if (++slices == 3)
+                {
+                    between(tft);
+                }
+            }
+            if (slices < 3)
+            {
+                between(tft);
+            }
+        }
+
+        // FlushAsync and Poll, the lines going out in the background
+        uint32_t backgroundPolls = 0;
+        uint32_t inFlight = 0;
+        {
+            TinyTextTFTBus<BackgroundBus> tft((BackgroundBus()), -1);
+            begin(tft, background, freq, rotation);
+            callbacks = 0;
+            if (!tft.FlushAsync(flushed) || (callbacks != 0))
+            {
+                fail("FlushAsync failed or called back straight away", rotation);
+                continue;
+            }
+            // a window's commands (CASET, PASET and RAMWR with their arguments)
+            // and a few reads of the status
+            uint64_t windowNanos = 11 * 8000000000ULL / freq + 1000;
+            bool busy = true;
+            while (busy)
+            {
+                MockAdvance(LOOP_MICROS * 1000ULL);
+                if (++backgroundPolls == 20)
+                {
+                    between(tft);
+                }
+                uint64_t start = MockNanos();
+                busy = tft.Poll();
+                if (MockNanos() - start > windowNanos)
+                {
+                    fail("a Poll waited for the bus", rotation);
+                }
+                if (busy && tft.IsBusy() && MockBusy() && MockInTransaction())
+                {
+                    inFlight++; // returned with the line still going out
+                }
+                else if (!released())
+                {
+                    fail("the bus is held between polls with nothing going out", rotation);
+                }
+            }
+            if (backgroundPolls < 20)
+            {
+                between(tft);
+            }
+            if ((callbacks != 1) || tft.IsBusy() || !released())
+            {
+                fail("not finished properly in the background", rotation);
+            }
+            if (inFlight == 0)
+            {
+                fail("no Poll returned while a line was going out", rotation);
+            }
+            if (MockCounts().overlaps != 0)
+            {
+                fail("the bus was used while a line was going out", rotation);
+            }
+        }
+
+        uint32_t polledDiff = compare(reference, polled);
+        uint32_t slicedDiff = compare(reference, sliced);
+        uint32_t backgroundDiff = compare(reference, background);
+        if ((polledDiff != 0) || (slicedDiff != 0) || (backgroundDiff != 0))
+        {
+            fail("the pictures differ", rotation);
+        }
+        printf("rotation %u: %4u polls, %3u slices of %u us (longest %.0f us), %4u polls in the background"
+               " (%4u with a line going out), pixels different %u, %u and %u\n",
+               rotation, polls, slices, BUDGET_MICROS, longest / 1000.0, backgroundPolls, inFlight,
+               polledDiff, slicedDiff, backgroundDiff);
+    }
+    printf(failures ? "FAILED\n" : "passed\n");
+    return failures ? 1 : 0;
+}
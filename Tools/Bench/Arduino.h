@@ -0,0 +1,104 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+/*
+  Stand-in for the parts of the Arduino core the library uses, for building it
+  on a PC. Pins only matter for CS and DC, which the SPI mock watches, and time
+  is simulated: it moves on with the bytes clocked out and with delay(), see
+  ArduinoMock.h.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROGMEM
+#define F(str) (str)
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+
+#define HIGH 1
+#define LOW  0
+#define INPUT  0
+#define OUTPUT 1
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size)
+    {
+        size_t n = 0;
+        while (size--)
+        {
+            n += write(*buffer++);
+        }
+        return n;
+    }
+    size_t write(const char* str) { return (str == NULL) ? 0 : write((const uint8_t*)str, strlen(str)); }
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+
+    size_t print(const char* str) { return write(str); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int n) { return printNumber("%d", n); }
+    size_t print(unsigned int n) { return printNumber("%u", n); }
+    size_t print(long n) { return printNumber("%ld", n); }
+    size_t print(unsigned long n) { return printNumber("%lu", n); }
+    size_t print(double n, int digits = 2)
+    {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.*f", digits, n);
+        return write(buffer);
+    }
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+
+private:
+    template <typename T> size_t printNumber(const char* format, T n)
+    {
+        char buffer[24];
+        snprintf(buffer, sizeof(buffer), format, n);
+        return write(buffer);
+    }
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+// stdout, nothing to read
+class HardwareSerial : public Stream
+{
+public:
+    void begin(unsigned long) {}
+    virtual size_t write(uint8_t c) { return (putchar(c) == EOF) ? 0 : 1; }
+    using Print::write;
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
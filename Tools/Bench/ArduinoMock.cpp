@@ -0,0 +1,288 @@
+#include <chrono>
+#include "ArduinoMock.h"
+#include "TinyTextCanvas.h"
+
+HardwareSerial Serial;
+SPIClass SPI;
+
+static MockBusCounts counts;
+static uint64_t nanos;
+static int8_t csPin = -1;
+static int8_t dcPin = -1;
+static bool csLevel = true;
+static bool dcLevel = true;
+static bool inTransaction = false;
+static uint32_t clockHz = 4000000;
+static TinyTextCanvas* canvas = NULL;
+static MockByteCallback watch = NULL;
+static bool pace = false;
+static uint64_t paceUntil; // on the PC's clock
+static uint64_t busyUntil; // end of the MockStartBytes transfer
+
+void MockReset(int8_t cs, int8_t dc)
+{
+    MockResetCounts();
+    nanos = 0;
+    csPin = cs;
+    dcPin = dc;
+    csLevel = true;
+    dcLevel = true;
+    inTransaction = false;
+    clockHz = 4000000;
+    canvas = NULL;
+    watch = NULL;
+    pace = false;
+    busyUntil = 0;
+}
+
+const MockBusCounts& MockCounts()
+{
+    return counts;
+}
+
+void MockResetCounts()
+{
+    memset(&counts, 0, sizeof(counts));
+}
+
+uint64_t MockNanos()
+{
+    return nanos;
+}
+
+void MockAdvance(uint64_t ns)
+{
+    nanos += ns;
+}
+
+bool MockSelected()
+{
+    return !csLevel;
+}
+
+bool MockInTransaction()
+{
+    return inTransaction;
+}
+
+static uint64_t wallNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void MockPace(bool on)
+{
+    pace = on;
+    paceUntil = wallNanos();
+}
+
+void MockAttach(TinyTextCanvas* panel)
+{
+    canvas = panel;
+}
+
+void MockWatch(MockByteCallback callback)
+{
+    watch = callback;
+}
+
+bool MockBusy()
+{
+    return nanos < busyUntil;
+}
+
+static void overlap()
+{
+    if (MockBusy())
+    {
+        counts.overlaps++;
+    }
+}
+
+static void send(uint8_t b)
+{
+    if (MockBusy())
+    {
+        counts.overlaps++;
+        nanos = busyUntil;
+    }
+    uint64_t ns = 8000000000ULL / clockHz;
+    counts.busNanos += ns;
+    nanos += ns;
+    if (pace)
+    {
+        uint64_t now = wallNanos();
+        paceUntil = ((paceUntil > now) ? paceUntil : now) + ns;
+        while (wallNanos() < paceUntil)
+        {
+        }
+    }
+    if (csLevel)
+    {
+        counts.strayBytes++;
+        return;
+    }
+    counts.bytes++;
+    if (dcLevel)
+    {
+        counts.dataBytes++;
+    }
+    else
+    {
+        counts.commandBytes++;
+    }
+    if (watch != NULL)
+    {
+        watch(b, !dcLevel);
+    }
+    if (canvas != NULL)
+    {
+        if (dcLevel)
+        {
+            canvas->Data(b);
+        }
+        else
+        {
+            canvas->Command(b);
+        }
+    }
+}
+
+void MockStartBytes(const uint8_t* data, uint32_t size)
+{
+    // sent now, but the clock only reaches the end of it later
+    uint64_t start = nanos;
+    while (size--)
+    {
+        send(*data++);
+    }
+    busyUntil = nanos;
+    nanos = start;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    if ((int8_t)pin == csPin)
+    {
+        overlap();
+        counts.csToggles++;
+        csLevel = (value != LOW);
+    }
+    else if ((int8_t)pin == dcPin)
+    {
+        overlap();
+        counts.dcToggles++;
+        dcLevel = (value != LOW);
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    if ((int8_t)pin == csPin)
+    {
+        return csLevel ? HIGH : LOW;
+    }
+    if ((int8_t)pin == dcPin)
+    {
+        return dcLevel ? HIGH : LOW;
+    }
+    return LOW;
+}
+
+unsigned long micros()
+{
+    return (unsigned long)(nanos / 1000);
+}
+
+unsigned long millis()
+{
+    return (unsigned long)(nanos / 1000000);
+}
+
+void delay(unsigned long ms)
+{
+    nanos += (uint64_t)ms * 1000000;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    nanos += (uint64_t)us * 1000;
+}
+
+void yield()
+{
+}
+
+void SPIClass::beginTransaction(SPISettings settings)
+{
+    counts.transactions++;
+    inTransaction = true;
+    clockHz = (settings.clock != 0) ? settings.clock : 4000000;
+}
+
+void SPIClass::endTransaction()
+{
+    overlap();
+    inTransaction = false;
+}
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+    send(data);
+    return 0; // nothing to read back, a calibration fails
+}
+
+void SPIClass::write(uint8_t data)
+{
+    send(data);
+}
+
+void SPIClass::write16(uint16_t data, bool msb)
+{
+    if (msb)
+    {
+        send(data >> 8);
+        send(data);
+    }
+    else
+    {
+        send(data);
+        send(data >> 8);
+    }
+}
+
+void SPIClass::write32(uint32_t data, bool msb)
+{
+    if (msb)
+    {
+        write16(data >> 16);
+        write16(data);
+    }
+    else
+    {
+        write16(data, false);
+        write16(data >> 16, false);
+    }
+}
+
+void SPIClass::writeBytes(const uint8_t* data, uint32_t size)
+{
+    while (size--)
+    {
+        send(*data++);
+    }
+}
+
+void SPIClass::writePattern(const uint8_t* data, uint8_t size, uint32_t repeat)
+{
+    while (repeat--)
+    {
+        writeBytes(data, size);
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef ArduinoMock_h
+#define ArduinoMock_h
+
+#include "Arduino.h"
+#include "SPI.h"
+
+class TinyTextCanvas;
+
+/*
+  The bus as the mock Arduino.h and SPI.h see it. Give it the CS and DC pins
+  of the panel and it counts what a logic analyser on the bus would: bytes
+  sent with CS low, split by DC into commands and data, transactions and the
+  digitalWrite calls on each pin. Time is simulated: each byte takes 8 clocks
+  at the SPISettings of its transaction, delay() and delayMicroseconds() move
+  it on and micros() and millis() read it. Nothing else takes time, so runs
+  are repeatable to the byte and the nanosecond.
+
+  With a canvas attached the bytes also go to it, in place of a panel, so
+  what the library sent can be checked pixel for pixel.
+
+  MockPace makes the bytes take their time on the PC's clock as well: each
+  one returns when a bus at the clock would have sent it, so a thread that
+  sends to the bus goes at the panel's speed (see Tools/Pipeline).
+
+  MockStartBytes stands for hardware that sends on its own (a FIFO or DMA):
+  the bytes are counted and reach the canvas straight away, but the clock
+  doesn't move and MockBusy() is true until it has passed the time they take.
+  A byte sent or a CS or DC change meanwhile counts as an overlap (and a byte
+  waits for the transfer first, as the hardware would).
+*/
+
+struct MockBusCounts
+{
+    uint64_t bytes;        // sent with CS low
+    uint64_t commandBytes; // .. and DC low
+    uint64_t dataBytes;    // .. and DC high
+    uint64_t strayBytes;   // sent with CS high, no panel sees them
+    uint32_t transactions; // beginTransaction
+    uint32_t csToggles;    // digitalWrite on the CS pin
+    uint32_t dcToggles;    // digitalWrite on the DC pin
+    uint64_t busNanos;     // time the bytes took
+    uint32_t overlaps;     // bus activity while a MockStartBytes transfer was going
+};
+
+typedef void (*MockByteCallback)(uint8_t b, bool command);
+
+// Counts, clock and pins back to zero, CS and DC high, the canvas and watch removed.
+void MockReset(int8_t cs, int8_t dc);
+const MockBusCounts& MockCounts();
+void MockResetCounts();
+
+uint64_t MockNanos();
+void MockAdvance(uint64_t nanos);
+void MockPace(bool pace);
+
+void MockStartBytes(const uint8_t* data, uint32_t size);
+bool MockBusy();
+
+bool MockSelected();      // CS is low
+bool MockInTransaction(); // between beginTransaction and endTransaction
+
+// Every byte sent with CS low goes to canvas as Command() or Data().
+void MockAttach(TinyTextCanvas* canvas);
+// Called for every byte sent with CS low.
+void MockWatch(MockByteCallback callback);
+
+#endif
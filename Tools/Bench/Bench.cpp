@@ -0,0 +1,360 @@
+/*
+  What the standard screens cost on the bus, measured on a PC: the library is
+  built against the mock Arduino.h and SPI.h in this folder, which count the
+  bytes and pin writes a panel would see and time them at the SPI clock.
+
+    g++ -std=c++11 -O2 -I. -I../../Library Bench.cpp ArduinoMock.cpp ../../Library/TinyTextTFT.cpp ../../Library/TinyTextBus.cpp \
+        ../../Library/TinyTextBlend.cpp ../../Library/TinyTextCanvas.cpp ../../Library/TinyTextClock.cpp ../../Library/TinyTextPipeline.cpp -o Bench
+    ./Bench [SPI MHz]                  (a table)
+    ./Bench [SPI MHz] --save FILE      (the table as a baseline)
+    ./Bench [SPI MHz] --check FILE     (against a baseline, exits 1 on a regression)
+
+  In every rotation:
+    fill     FillScreen
+    text     1536 DrawChar calls, a screen of text a cell at a time (as testText)
+    string   the same text a row at a time with DrawString
+    cells    256 single cells at scattered places with DrawChar
+    update   256 single cells with Put and a Flush after each, on the shadow grid
+    console  3072 characters of console text, scrolling
+
+  For each it reports the bytes sent (commands and data), digitalWrite calls on
+  CS and DC, transactions and the time the bytes take at the clock, which is a
+  floor: the CPU time between them isn't modelled. The bytes go to a canvas and
+  a hash of the resulting picture is kept too, so --check also catches a change
+  in what is drawn. A count that is higher than in the baseline, or a different
+  picture, is a regression; Baseline.txt is the current tree's.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ArduinoMock.h"
+#include "TinyTextTFT.h"
+
+#define PIN_CS 10
+#define PIN_DC 9
+
+#define MAX_RESULTS 32
+
+struct Result
+{
+    char     name[16];
+    uint8_t  rotation;
+    uint64_t commandBytes;
+    uint64_t dataBytes;
+    uint32_t csToggles;
+    uint32_t dcToggles;
+    uint32_t transactions;
+    uint32_t picture; // FNV-1a of the canvas
+    uint64_t busNanos;
+};
+
+static uint32_t random32(uint32_t& seed)
+{
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+static void screenText(uint32_t i, char& chr, uint16_t& fore)
+{
+    static const char text[] = "The quick brown fox jumps over the lazy dog. 0123456789 {}[]()<>+-*/=%$#@!?";
+    static const uint16_t colors[] = { 0xFFF, 0x000, 0xFF0, 0x0F0, 0xF00, 0x0FF };
+    chr = text[i % (sizeof(text) - 1)];
+    fore = colors[(i / 7) % 6];
+}
+
+static void fill(TinyTextTFT& tft)
+{
+    tft.FillScreen(RGB444_BLACK);
+}
+
+static void text(TinyTextTFT& tft)
+{
+    uint32_t i = 0;
+    for (uint8_t row = 0; row < tft.Rows(); row++)
+    {
+        for (uint8_t col = 0; col < tft.Columns(); col++, i++)
+        {
+            char chr;
+            uint16_t fore;
+            screenText(i, chr, fore);
+            tft.DrawChar(col, row, chr, fore, 0x07D);
+        }
+    }
+}
+
+static void string(TinyTextTFT& tft)
+{
+    uint32_t i = 0;
+    for (uint8_t row = 0; row < tft.Rows(); row++)
+    {
+        char line[64];
+        uint16_t fore;
+        for (uint8_t col = 0; col < tft.Columns(); col++, i++)
+        {
+            screenText(i, line[col], fore);
+        }
+        tft.DrawString(0, row, line, tft.Columns(), 0xFFF, 0x07D);
+    }
+}
+
+static void cells(TinyTextTFT& tft)
+{
+    uint32_t seed = 1;
+    for (uint16_t i = 0; i < 256; i++)
+    {
+        uint8_t col = random32(seed) % tft.Columns();
+        uint8_t row = random32(seed) % tft.Rows();
+        tft.DrawChar(col, row, '0' + i % 10, 0xFFF, 0x07D);
+    }
+}
+
+static void update(TinyTextTFT& tft)
+{
+    uint32_t seed = 2;
+    for (uint16_t i = 0; i < 256; i++)
+    {
+        uint8_t col = random32(seed) % tft.Columns();
+        uint8_t row = random32(seed) % tft.Rows();
+        tft.Put(col, row, 'A' + i % 26, 0xFF0, 0x07D);
+        tft.Flush();
+    }
+}
+
+static void console(TinyTextTFT& tft)
+{
+    tft.SetCursor(0, 0);
+    for (uint16_t i = 0; i < 3072; i += 48)
+    {
+        char line[64];
+        int len = snprintf(line, sizeof(line), "%04u the console scrolls the whole screen up\n", (unsigned)i);
+        tft.Write(line, len);
+    }
+}
+
+static const struct
+{
+    const char* name;
+    void (*run)(TinyTextTFT& tft);
+    bool grid;
+}
+scenarios[] =
+{
+    { "fill",    fill,    false },
+    { "text",    text,    false },
+    { "string",  string,  false },
+    { "cells",   cells,   false },
+    { "update",  update,  true  },
+    { "console", console, false },
+};
+
+static uint32_t pictureHash(TinyTextCanvas& canvas)
+{
+    uint32_t hash = 2166136261UL;
+    for (uint16_t y = 0; y < canvas.Height(); y++)
+    {
+        for (uint16_t x = 0; x < canvas.Width(); x++)
+        {
+            uint16_t pixel = canvas.GetPixel(x, y);
+            hash = (hash ^ (pixel & 0xFF)) * 16777619UL;
+            hash = (hash ^ (pixel >> 8)) * 16777619UL;
+        }
+    }
+    return hash;
+}
+
+static uint8_t runAll(uint32_t freq, Result* results)
+{
+    uint8_t count = 0;
+    for (uint8_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++)
+    {
+        for (uint8_t rotation = 0; rotation < 4; rotation++)
+        {
+            TinyTextCanvas canvas;
+            if (!canvas.Begin())
+            {
+                printf("can't allocate the canvas\n");
+                exit(1);
+            }
+            MockReset(PIN_CS, PIN_DC);
+            MockAttach(&canvas);
+
+            TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+            tft.SetFrequency(freq);
+            tft.Begin();
+            if (scenarios[s].grid)
+            {
+                tft.EnableGrid();
+            }
+            tft.SetRotation(rotation);
+            tft.FillScreen(0x07D);
+            if (scenarios[s].grid)
+            {
+                tft.Flush();
+            }
+
+            MockResetCounts();
+            scenarios[s].run(tft);
+            const MockBusCounts& counts = MockCounts();
+
+            Result& result = results[count++];
+            snprintf(result.name, sizeof(result.name), "%s", scenarios[s].name);
+            result.rotation = rotation;
+            result.commandBytes = counts.commandBytes;
+            result.dataBytes = counts.dataBytes;
+            result.csToggles = counts.csToggles;
+            result.dcToggles = counts.dcToggles;
+            result.transactions = counts.transactions;
+            result.picture = pictureHash(canvas);
+            result.busNanos = counts.busNanos;
+            if (counts.strayBytes != 0)
+            {
+                printf("%s %u: %llu bytes sent with CS high\n", result.name, rotation, (unsigned long long)counts.strayBytes);
+            }
+        }
+    }
+    return count;
+}
+
+static void printResult(FILE* out, const Result& result)
+{
+    fprintf(out, "%-8s %u %10llu %8llu %8u %8u %6u %08x\n", result.name, result.rotation,
+            (unsigned long long)result.dataBytes, (unsigned long long)result.commandBytes,
+            result.csToggles, result.dcToggles, result.transactions, result.picture);
+}
+
+static bool readResult(const char* line, Result& result)
+{
+    unsigned rotation;
+    unsigned long long dataBytes;
+    unsigned long long commandBytes;
+    unsigned picture;
+    if (sscanf(line, "%15s %u %llu %llu %u %u %u %x", result.name, &rotation, &dataBytes, &commandBytes,
+               &result.csToggles, &result.dcToggles, &result.transactions, &picture) != 8)
+    {
+        return false;
+    }
+    result.rotation = rotation;
+    result.dataBytes = dataBytes;
+    result.commandBytes = commandBytes;
+    result.picture = picture;
+    return true;
+}
+
+static bool check(const char* path, const Result* results, uint8_t count)
+{
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+    {
+        printf("can't read %s\n", path);
+        return false;
+    }
+    bool passed = true;
+    uint8_t found = 0;
+    char line[160];
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        Result base;
+        if ((line[0] == '#') || !readResult(line, base))
+        {
+            continue;
+        }
+        for (uint8_t i = 0; i < count; i++)
+        {
+            const Result& now = results[i];
+            if ((strcmp(now.name, base.name) != 0) || (now.rotation != base.rotation))
+            {
+                continue;
+            }
+            found++;
+            bool worse = (now.dataBytes > base.dataBytes) || (now.commandBytes > base.commandBytes) ||
+                         (now.csToggles > base.csToggles) || (now.dcToggles > base.dcToggles) ||
+                         (now.transactions > base.transactions);
+            bool better = (now.dataBytes < base.dataBytes) || (now.commandBytes < base.commandBytes) ||
+                          (now.csToggles < base.csToggles) || (now.dcToggles < base.dcToggles) ||
+                          (now.transactions < base.transactions);
+            if (worse || (now.picture != base.picture))
+            {
+                printf("REGRESSION %s %u:%s\n  was ", now.name, now.rotation,
+                       (now.picture != base.picture) ? " the picture changed" : "");
+                printResult(stdout, base);
+                printf("  now ");
+                printResult(stdout, now);
+                passed = false;
+            }
+            else if (better)
+            {
+                printf("improved %s %u, update the baseline\n", now.name, now.rotation);
+            }
+        }
+    }
+    fclose(file);
+    if (found != count)
+    {
+        printf("%u of %u scenarios are in %s\n", found, count, path);
+        passed = false;
+    }
+    printf(passed ? "no regressions\n" : "FAILED\n");
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    double mhz = 24;
+    const char* save = NULL;
+    const char* baseline = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--save") == 0) && (i + 1 < argc))
+        {
+            save = argv[++i];
+        }
+        else if ((strcmp(argv[i], "--check") == 0) && (i + 1 < argc))
+        {
+            baseline = argv[++i];
+        }
+        else if (atof(argv[i]) > 0)
+        {
+            mhz = atof(argv[i]);
+        }
+        else
+        {
+            printf("usage: Bench [SPI MHz] [--save FILE | --check FILE]\n");
+            return 1;
+        }
+    }
+
+    Result results[MAX_RESULTS];
+    uint32_t freq = (uint32_t)(mhz * 1e6);
+    uint8_t count = runAll(freq, results);
+
+    printf("%-8s %s %10s %8s %8s %8s %6s %8s %10s\n", "scenario", "r", "data", "command", "CS", "DC", "trans", "picture", "us");
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const Result& result = results[i];
+        printf("%-8s %u %10llu %8llu %8u %8u %6u %08x %10.0f\n", result.name, result.rotation,
+               (unsigned long long)result.dataBytes, (unsigned long long)result.commandBytes,
+               result.csToggles, result.dcToggles, result.transactions, result.picture, result.busNanos / 1000.0);
+    }
+
+    if (save != NULL)
+    {
+        FILE* file = fopen(save, "w");
+        if (file == NULL)
+        {
+            printf("can't write %s\n", save);
+            return 1;
+        }
+        fprintf(file, "# scenario rotation data command CS DC transactions picture\n");
+        for (uint8_t i = 0; i < count; i++)
+        {
+            printResult(file, results[i]);
+        }
+        fclose(file);
+    }
+    if (baseline != NULL)
+    {
+        return check(baseline, results, count) ? 0 : 1;
+    }
+    return 0;
+}
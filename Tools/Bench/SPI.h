@@ -0,0 +1,40 @@
+#ifndef SPI_h
+#define SPI_h
+
+#include "Arduino.h"
+
+/*
+  Stand-in for the ESP8266 / ESP32 SPIClass: every byte is counted and takes
+  8 clocks of the current transaction on the simulated clock, see ArduinoMock.h.
+*/
+
+#define SPI_MODE0 0x00
+
+class SPISettings
+{
+public:
+    uint32_t clock;
+
+    SPISettings() : clock(4000000) {}
+    SPISettings(uint32_t clockHz, uint8_t bitOrder, uint8_t dataMode) : clock(clockHz) { (void)bitOrder; (void)dataMode; }
+};
+
+class SPIClass
+{
+public:
+    void begin() {}
+    void end() {}
+    void beginTransaction(SPISettings settings);
+    void endTransaction();
+
+    uint8_t transfer(uint8_t data);
+    void write(uint8_t data);
+    void write16(uint16_t data, bool msb = true);
+    void write32(uint32_t data, bool msb = true);
+    void writeBytes(const uint8_t* data, uint32_t size);
+    void writePattern(const uint8_t* data, uint8_t size, uint32_t repeat);
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,42 @@
+/*
+  Checks TinyTextBlend against the original blend, a channel at a time, for
+  every tone and every pair of RGB444 colours: 16 x 4096 x 4096 blends.
+
+    g++ -std=c++11 -O2 -I../../Library BlendTest.cpp ../../Library/TinyTextBlend.cpp -o BlendTest
+    ./BlendTest
+
+  Prints the first few mismatches, if any, and exits 1 when there are some.
+  Takes a few seconds.
+*/
+
+#include <stdio.h>
+#include "TinyTextBlend.h"
+#include "ReferenceBlend.h"
+
+int main()
+{
+    uint64_t checked = 0;
+    uint64_t wrong = 0;
+    for (uint8_t tone = 0; tone < 16; tone++)
+    {
+        for (uint32_t fore = 0; fore < 4096; fore++)
+        {
+            for (uint32_t back = 0; back < 4096; back++)
+            {
+                uint16_t expected = referenceBlend(tone, fore, back);
+                uint16_t blended = TinyTextBlend(tone, fore, back);
+                checked++;
+                if (blended != expected)
+                {
+                    if (wrong < 10)
+                    {
+                        printf("tone %2u fore %03X back %03X: %04X, expected %04X\n", tone, (unsigned)fore, (unsigned)back, blended, expected);
+                    }
+                    wrong++;
+                }
+            }
+        }
+    }
+    printf("%llu blends, %llu wrong\n", (unsigned long long)checked, (unsigned long long)wrong);
+    return (wrong == 0) ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+/*
+  Blends a second on a PC, before and after the palette cache: the colours of
+  the glyph pixels of a screen of cells (48 x 32) worked out as DrawChar did
+  before the cache, blending whenever the tone changed from the pixel before,
+  and with TinyTextPalettes, a lookup per pixel in the palette of the cell's
+  colour pair. Also the blend itself, the reference (the original
+  blendPixelColor) against TinyTextBlend.
+
+    g++ -std=c++11 -O2 -I../../Library PaletteBench.cpp ../../Library/TinyTextBlend.cpp -o PaletteBench
+    ./PaletteBench [colour pairs]
+
+  The screen uses 4 colour pairs unless given, more than TINYTEXT_PALETTE_CACHE
+  (8) is the worst case for the cache: every word blends a new palette. The
+  glyphs are made up, 8 rows of 4 tones each (as in the font) with about half
+  the pixels background, a fifth foreground and runs of the same tone.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "TinyTextBlend.h"
+#include "ReferenceBlend.h"
+
+#define GLYPHS  95
+#define CELLS   (48 * 32)
+#define SECONDS 0.5
+
+static uint16_t glyphs[GLYPHS][8];
+static uint8_t  cellGlyph[CELLS];
+static uint16_t cellFore[CELLS];
+static uint16_t cellBack[CELLS];
+
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void makeScreen(int pairs)
+{
+    uint8_t tone = 15;
+    for (int g = 0; g < GLYPHS; g++)
+    {
+        for (int y = 0; y < 8; y++)
+        {
+            uint16_t tones = 0;
+            for (int x = 0; x < 4; x++)
+            {
+                int r = rand() % 100;
+                if (r >= 40) // else the same tone again
+                {
+                    r = rand() % 100;
+                    tone = (r < 50) ? 15 : ((r < 70) ? 0 : 1 + rand() % 14);
+                }
+                tones = (tones << 4) | tone;
+            }
+            glyphs[g][y] = tones;
+        }
+    }
+    for (int i = 0; i < CELLS; i++)
+    {
+        int pair = (i / 6) % pairs; // a few cells (a word) in each colour
+        cellGlyph[i] = rand() % GLYPHS;
+        cellFore[i] = (0x9C3 * (pair + 1)) & 0xFFF;
+        cellBack[i] = (0x217 * pair) & 0xFFF;
+    }
+}
+
+static uint32_t screenBefore(uint32_t& blends)
+{
+    // as the DrawChar loop before the cache: a blend unless the tone is the same
+    // as the pixel before
+    uint32_t sum = 0;
+    for (int i = 0; i < CELLS; i++)
+    {
+        const uint16_t* rows = glyphs[cellGlyph[i]];
+        uint16_t fore = cellFore[i];
+        uint16_t back = cellBack[i];
+        uint8_t tonel = 16; // not possible
+        uint16_t pixell = 0;
+        for (int y = 0; y < 8; y++)
+        {
+            uint16_t tones = rows[y];
+            for (int x = 0; x < 4; x++)
+            {
+                uint8_t tone = (tones >> (12 - 4 * x)) & 0x0F;
+                if (tone != tonel)
+                {
+                    pixell = referenceBlend(tone, fore, back);
+                    tonel = tone;
+                    blends++;
+                }
+                sum += pixell;
+            }
+        }
+    }
+    return sum;
+}
+
+static uint32_t screenAfter(TinyTextPalettes& palettes)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < CELLS; i++)
+    {
+        const uint16_t* rows = glyphs[cellGlyph[i]];
+        const uint16_t* palette = palettes.Get(cellFore[i], cellBack[i]);
+        for (int y = 0; y < 8; y++)
+        {
+            uint16_t tones = rows[y];
+            sum += palette[tones >> 12] + palette[(tones >> 8) & 0x0F] + palette[(tones >> 4) & 0x0F] + palette[tones & 0x0F];
+        }
+    }
+    return sum;
+}
+
+static double kernel(uint16_t (*blend)(uint8_t, uint16_t, uint16_t), uint32_t& sum)
+{
+    // blends a second
+    uint64_t count = 0;
+    double start = now();
+    double elapsed;
+    uint16_t fore = 0;
+    do
+    {
+        for (int i = 0; i < 65536; i++)
+        {
+            sum += blend(i & 0x0F, fore, (uint16_t)(i >> 4));
+            fore = (fore + 0x1F3) & 0xFFF;
+        }
+        count += 65536;
+        elapsed = now() - start;
+    }
+    while (elapsed < SECONDS);
+    return count / elapsed;
+}
+
+int main(int argc, char** argv)
+{
+    int pairs = (argc > 1) ? atoi(argv[1]) : 4;
+    if (pairs < 1)
+    {
+        printf("usage: PaletteBench [colour pairs]\n");
+        return 1;
+    }
+    srand(1);
+    makeScreen(pairs);
+    uint32_t sum = 0;
+
+    double reference = kernel(referenceBlend, sum);
+    double swar = kernel(TinyTextBlend, sum);
+    printf("blend              reference %7.1f M/s   TinyTextBlend %7.1f M/s\n", reference / 1e6, swar / 1e6);
+
+    uint32_t blends = 0;
+    uint32_t screens = 0;
+    double start = now();
+    double before;
+    do
+    {
+        sum += screenBefore(blends);
+        screens++;
+        before = now() - start;
+    }
+    while (before < SECONDS);
+    double pixels = (double)screens * CELLS * 32;
+    double beforeRate = pixels / before;
+    printf("before the cache   %7.1f M pixels/s, %.2f blends a pixel\n", beforeRate / 1e6, blends / pixels);
+
+    TinyTextPalettes palettes;
+    screens = 0;
+    start = now();
+    double after;
+    do
+    {
+        sum += screenAfter(palettes);
+        screens++;
+        after = now() - start;
+    }
+    while (after < SECONDS);
+    pixels = (double)screens * CELLS * 32;
+    double afterRate = pixels / after;
+    printf("with the cache     %7.1f M pixels/s, %.2f blends a pixel (%d pairs, %d cached), %.1f times as many\n",
+           afterRate / 1e6, palettes.Builds() * 16.0 / pixels, pairs, TINYTEXT_PALETTE_CACHE, afterRate / beforeRate);
+    printf("(checksum %08x)\n", (unsigned)sum);
+    return 0;
+}
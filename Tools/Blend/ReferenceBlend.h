@@ -0,0 +1,45 @@
+#ifndef ReferenceBlend_h
+#define ReferenceBlend_h
+
+#include <stdint.h>
+
+// blendPixelColor as it was originally, a channel at a time: what TinyTextBlend
+// has to match bit for bit. The low bit tests were written "rBlended & 0x01 != 0",
+// which C reads as "rBlended & (0x01 != 0)", the same test.
+
+static const uint8_t referenceShade[] = { 0, 37, 60, 81, 99, 116, 133, 148, 163, 177, 191, 204, 217, 230, 243, 255 };
+
+static inline uint16_t referenceBlend(uint8_t tone, uint16_t foreColor, uint16_t backColor)
+{
+    uint8_t shade = referenceShade[tone];
+    uint8_t shade255 = 255 - shade;
+
+    uint8_t rForeground = (foreColor >> 8);
+    uint8_t gForeground = ((foreColor >> 4) & (0x0F));
+    uint8_t bForeground = (foreColor & 0x0F);
+
+    uint8_t rBackground = (backColor >> 8);
+    uint8_t gBackground = ((backColor >> 4) & (0x0F));
+    uint8_t bBackground = (backColor & 0x0F);
+
+    uint16_t rBlended = ((shade255 * rForeground) + (shade * rBackground)) >> 8;
+    uint16_t gBlended = ((shade255 * gForeground) + (shade * gBackground)) >> 8;
+    uint16_t bBlended = ((shade255 * bForeground) + (shade * bBackground)) >> 8;
+
+    uint16_t c565 = (uint16_t)((rBlended << 12) + (gBlended << 7) + (bBlended << 1));
+    if (rBlended & 0x01)
+    {
+        c565 |= 0x0800;
+    }
+    if (gBlended & 0x01)
+    {
+        c565 |= 0x0060;
+    }
+    if (bBlended & 0x01)
+    {
+        c565 |= 0x0001;
+    }
+    return c565;
+}
+
+#endif
@@ -0,0 +1,278 @@
+/*
+  TinyTextTFTBus on a bus policy of its own: RecordingBus below keeps every
+  byte the driver sends, marked command or data, and hands it to a canvas in
+  place of a panel. The same scene is drawn through it and through TinyTextTFT
+  (the pin bus) on the mock SPI bus of Tools/Bench, and through
+  TinyTextFixedPinBus on the mock as well.
+
+    g++ -std=c++11 -O2 -I../Bench -I../../Library BusTest.cpp ../Bench/ArduinoMock.cpp ../../Library/TinyTextTFT.cpp \
+        ../../Library/TinyTextBus.cpp ../../Library/TinyTextBlend.cpp ../../Library/TinyTextCanvas.cpp \
+        ../../Library/TinyTextClock.cpp ../../Library/TinyTextPipeline.cpp ../../Library/TinyTextField.cpp \
+        ../../Library/TinyTextScrollback.cpp ../../Library/TinyTextWindow.cpp -o BusTest
+    ./BusTest
+
+  In every rotation it checks:
+    - the three send the same bytes, each a command or data the same way
+    - in the same number of transactions, and nothing is sent outside one
+    - the three pictures are the same, pixel for pixel
+  The scene covers FillScreen, DrawString, DrawRun, the glyph cache, the shadow
+  grid with Flush and FlushAsync, the console scrolling and the pipeline, and
+  a TinyTextWindow and a TinyTextField, which take any bus as a TinyTextDisplay.
+  Exits 1 if anything fails.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "ArduinoMock.h"
+#include "TinyTextTFT.h"
+#include "TinyTextTFTImpl.h" // TinyTextTFTBus<RecordingBus> is built here
+#include "TinyTextField.h"
+#include "TinyTextWindow.h"
+
+#define PIN_CS 10
+#define PIN_DC 9
+
+struct Recording
+{
+    std::vector<uint16_t> bytes; // 0x100 set for a command
+    uint32_t transactions;
+    uint32_t strays;             // sent outside a transaction
+    bool     open;
+    TinyTextCanvas* canvas;
+};
+
+// A bus policy (see TinyTextBus.h) that keeps what is sent. The driver keeps a
+// copy of its bus, so it records into a Recording of the test's.
+class RecordingBus
+{
+private:
+    Recording* _rec;
+
+    void send(uint8_t b, bool command)
+    {
+        if (!_rec->open)
+        {
+            _rec->strays++;
+            return;
+        }
+        _rec->bytes.push_back(command ? 0x100 | b : b);
+        if (command)
+        {
+            _rec->canvas->Command(b);
+        }
+        else
+        {
+            _rec->canvas->Data(b);
+        }
+    }
+
+public:
+    RecordingBus(Recording* rec) { _rec = rec; }
+
+    void Begin(uint32_t freq) { (void)freq; }
+    void SetFrequency(uint32_t freq) { (void)freq; }
+    void BeginTransaction()
+    {
+        _rec->transactions++;
+        _rec->open = true;
+    }
+    void EndTransaction() { _rec->open = false; }
+
+    void Command(uint8_t cmd) { send(cmd, true); }
+    void Write(uint8_t b) { send(b, false); }
+    void Write16(uint16_t w)
+    {
+        send(w >> 8, false);
+        send(w, false);
+    }
+    void WriteColor16(uint16_t color)
+    {
+        send(color, false);
+        send(color >> 8, false);
+    }
+    void WriteColor32(uint32_t color)
+    {
+        WriteColor16(color);
+        WriteColor16(color >> 16);
+    }
+    void WriteBytes(const uint8_t* data, uint32_t len)
+    {
+        while (len--)
+        {
+            send(*data++, false);
+        }
+    }
+#ifdef TINYTEXT_SPI_PATTERN
+    void WritePattern(const uint8_t* data, uint8_t size, uint32_t repeat)
+    {
+        while (repeat--)
+        {
+            WriteBytes(data, size);
+        }
+    }
+#endif
+    uint8_t Read() { return 0; }
+
+    uint16_t StartBytes(const uint8_t* data, uint16_t len)
+    {
+        // as a board without a FIFO: all of it, at once
+        WriteBytes(data, len);
+        return len;
+    }
+    bool Busy() { return false; }
+};
+
+static std::vector<uint16_t> watched;
+
+static void watch(uint8_t b, bool command)
+{
+    watched.push_back(command ? 0x100 | b : b);
+}
+
+typedef TinyTextFixedPinBus<PIN_CS, PIN_DC> FixedBus;
+
+template <class Bus>
+static void scene(TinyTextTFTBus<Bus>& tft, uint8_t rotation)
+{
+    static const uint16_t fores[] = { 0xFFF, 0xFF0, 0x0F0, 0xF00, 0x0FF, 0x888 };
+    static const uint16_t backs[] = { 0x000, 0x00F, 0x07D, 0x333, 0x700, 0x070 };
+
+    tft.Begin();
+    tft.SetRotation(rotation);
+    tft.FillScreen(0x07D);
+    tft.DrawString(1, 1, "TinyTextTFTBus \xC2\xB0 \xE2\x94\x80\xE2\x94\xBC", 20, 0xFFF, 0x000);
+
+    char text[24];
+    uint16_t fore[24];
+    uint16_t back[24];
+    for (uint8_t i = 0; i < 24; i++)
+    {
+        text[i] = 'A' + i;
+        fore[i] = fores[i % 6];
+        back[i] = backs[(i / 2) % 6];
+    }
+    tft.DrawRun(2, 3, text, fore, back, 24);
+
+    tft.EnableGlyphCache(2000);
+    for (uint8_t i = 0; i < 40; i++)
+    {
+        tft.DrawChar(i % 16, 5 + i / 16, 'a' + i % 8, fores[i % 3], backs[i % 2]);
+    }
+    tft.DisableGlyphCache();
+    tft.FillCells(20, 5, 8, 3, 0xF00);
+
+    tft.EnableGrid();
+    tft.Print(0, 9, "on the grid", 0xFF0, 0x00F);
+    tft.Flush();
+    for (uint8_t i = 0; i < 60; i++)
+    {
+        tft.Put((i * 7) % tft.Columns(), 10 + i % 4, '0' + i % 10, fores[i % 6], backs[(i + 1) % 6]);
+    }
+    tft.FlushAsync();
+    while (tft.Poll())
+    {
+    }
+
+    tft.EnablePipeline(4, false);
+    tft.DrawRun(4, 14, text, fore, back, 20);
+    tft.DisablePipeline();
+
+    TinyTextWindow window;
+    window.Attach(&tft, 30, 16, 20, 3, 0xFF0, 0x00F);
+    window.Write("a window on any bus, wrapping and then scrolling up a row\n");
+    TinyTextField field(&tft, 30, 20, 8);
+    field.SetInt(-1234);
+    field.SetInt(-1250);
+
+    tft.SetConsoleColors(0x0F0, 0x000);
+    tft.SetCursor(0, tft.Rows() - 2);
+    tft.Write("the console\nscrolls\nup a row or two\n");
+    tft.Flush();
+}
+
+static uint32_t compare(TinyTextCanvas& a, TinyTextCanvas& b)
+{
+    uint32_t differ = 0;
+    for (uint16_t y = 0; y < a.Height(); y++)
+    {
+        for (uint16_t x = 0; x < a.Width(); x++)
+        {
+            differ += (a.GetPixel(x, y) != b.GetPixel(x, y));
+        }
+    }
+    return differ;
+}
+
+int main()
+{
+    uint32_t failures = 0;
+    for (uint8_t rotation = 0; rotation < 4; rotation++)
+    {
+        TinyTextCanvas pinCanvas;
+        TinyTextCanvas fixedCanvas;
+        TinyTextCanvas recCanvas;
+        if (!pinCanvas.Begin() || !fixedCanvas.Begin() || !recCanvas.Begin())
+        {
+            printf("can't allocate the canvases\n");
+            return 1;
+        }
+
+        MockReset(PIN_CS, PIN_DC);
+        MockAttach(&fixedCanvas);
+        watched.clear();
+        MockWatch(watch);
+        TinyTextTFTBus<FixedBus> fixed(FixedBus(), -1);
+        scene(fixed, rotation);
+        std::vector<uint16_t> fixedBytes = watched;
+        MockBusCounts fixedCounts = MockCounts();
+
+        MockReset(PIN_CS, PIN_DC);
+        MockAttach(&pinCanvas);
+        watched.clear();
+        MockWatch(watch);
+        TinyTextTFT pins(PIN_CS, PIN_DC, -1);
+        scene(pins, rotation);
+
+        Recording rec;
+        rec.transactions = 0;
+        rec.strays = 0;
+        rec.open = false;
+        rec.canvas = &recCanvas;
+        RecordingBus bus(&rec);
+        TinyTextTFTBus<RecordingBus> recorded(bus);
+        scene(recorded, rotation);
+
+        uint32_t differ = compare(pinCanvas, recCanvas);
+        bool same = (rec.bytes == watched);
+        printf("rotation %u: %7zu bytes, %4u transactions   %s, %u pixels differ\n", rotation, rec.bytes.size(),
+               rec.transactions, same ? "same bytes" : "BYTES DIFFER", differ);
+        if (!same || (differ != 0) || (rec.transactions != MockCounts().transactions) ||
+            (rec.strays != 0) || (MockCounts().strayBytes != 0) || rec.open)
+        {
+            if (rec.transactions != MockCounts().transactions)
+            {
+                printf("  %u transactions on the pin bus\n", MockCounts().transactions);
+            }
+            if ((rec.strays != 0) || (MockCounts().strayBytes != 0))
+            {
+                printf("  bytes outside a transaction: %u recorded, %llu on the pin bus\n", rec.strays,
+                       (unsigned long long)MockCounts().strayBytes);
+            }
+            failures++;
+        }
+
+        differ = compare(pinCanvas, fixedCanvas);
+        same = (fixedBytes == watched);
+        printf("  fixed pins: %s, %u pixels differ\n", same ? "same bytes" : "BYTES DIFFER", differ);
+        if (!same || (differ != 0) || (fixedCounts.transactions != MockCounts().transactions) ||
+            (fixedCounts.strayBytes != 0))
+        {
+            printf("  %u transactions, %llu bytes outside one\n", fixedCounts.transactions,
+                   (unsigned long long)fixedCounts.strayBytes);
+            failures++;
+        }
+    }
+    printf(failures ? "FAILED\n" : "passed\n");
+    return failures ? 1 : 0;
+}
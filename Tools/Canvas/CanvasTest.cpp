@@ -0,0 +1,217 @@
+/*
+  Golden images: renders a scene in each rotation through SetCanvas and
+  compares the picture with the PPM checked in under Golden/, pixel for pixel.
+
+    g++ -std=c++11 -O2 -I../Bench -I../../Library CanvasTest.cpp ../Bench/ArduinoMock.cpp ../../Library/TinyTextTFT.cpp \
+        ../../Library/TinyTextBus.cpp ../../Library/TinyTextBlend.cpp ../../Library/TinyTextCanvas.cpp ../../Library/TinyTextClock.cpp \
+        ../../Library/TinyTextPipeline.cpp -o CanvasTest
+    ./CanvasTest            (compare, run it from this folder)
+    ./CanvasTest --update   (write the golden images again, after a change that is meant to show)
+
+  A picture that differs is written next to its golden image as
+  rotationN.new.ppm, to look at side by side. The scene covers DrawChar,
+  DrawString, DrawRun, DrawCode (box drawing, blocks and arrows), FillCells,
+  the shadow grid with Put, Print and Flush, and console text scrolled a few
+  times (the hardware scroll in rotations 0 and 2, the grid shifted up in 1
+  and 3). Each picture is also sent
+  to a panel with PushCanvas, here the mock bus of Tools/Bench with a canvas
+  of its own, which must end up the same.
+
+  Also prints the screens a second the scene renders at.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include "ArduinoMock.h"
+#include "TinyTextTFT.h"
+
+#define PIN_CS 10
+#define PIN_DC 9
+
+class StringPrint : public Print
+{
+public:
+    std::string text;
+
+    virtual size_t write(uint8_t c) { text += (char)c; return 1; }
+    virtual size_t write(const uint8_t* buffer, size_t size) { text.append((const char*)buffer, size); return size; }
+    using Print::write;
+};
+
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void scene(TinyTextTFT& tft, uint8_t rotation)
+{
+    tft.EnableGrid(); // the Draw.. calls keep it in step
+    tft.SetRotation(rotation);
+    tft.FillScreen(0x07D);
+
+    // colour pairs across the range, a cell at a time
+    const char* text = "Hello, World! {}~ 0123456789 The quick brown fox";
+    for (uint8_t row = 0; row < 6; row++)
+    {
+        for (uint8_t col = 0; col < tft.Columns(); col++)
+        {
+            tft.DrawChar(col, row, text[(col + row) % strlen(text)], (row * 0x2A5 + col * 0x111) & 0xFFF, (row * 0x037) & 0xFFF);
+        }
+    }
+    tft.DrawString(0, 6, "DrawString: one window for the whole run, clipped at the right edge of the screen", 80, 0xFF0, 0x000);
+
+    uint16_t fore[16];
+    uint16_t back[16];
+    for (uint8_t i = 0; i < 16; i++)
+    {
+        fore[i] = 0xFFF - i * 0x111;
+        back[i] = i * 0x111;
+    }
+    tft.DrawRun(0, 7, "DrawRun colours!", fore, back, 16);
+
+    static const uint16_t codes[] = { 0x2500, 0x2502, 0x250C, 0x2510, 0x2514, 0x2518, 0x253C, 0x2580, 0x2584, 0x2588, 0x2591, 0x2592, 0x2593,
+                                      0x2190, 0x2191, 0x2192, 0x2193, 0x00B0, 0x00B1, 0x00B5 };
+    for (uint8_t i = 0; i < sizeof(codes) / sizeof(codes[0]); i++)
+    {
+        tft.DrawCode(i, 8, codes[i], 0x0F0, 0x000);
+    }
+
+    tft.FillCells(20, 9, 10, 3, 0xF00);
+    tft.FillCells(tft.Columns() - 4, tft.Rows() - 4, 10, 10, 0x00F); // clipped
+
+    // cells that only go to the grid until the Flush
+    for (uint8_t i = 0; i < 40; i++)
+    {
+        tft.Put((i * 7) % tft.Columns(), 12 + i % 4, 'a' + i % 26, 0xFFF, (i * 0x123) & 0xFFF);
+    }
+    tft.Print(0, 16, "Print on the grid, sent by Flush", 0x0FF, 0x000);
+    tft.Flush();
+
+    // console text scrolled a few times
+    tft.SetConsoleColors(0xFFF, 0x000);
+    tft.SetCursor(0, tft.Rows() - 3);
+    tft.Write("console line one\nconsole line two, long enough to wrap round the right edge of the screen\n"
+              "three\nfour \xE2\x86\x92 UTF-8 arrow\nfive");
+}
+
+int main(int argc, char** argv)
+{
+    bool update = (argc > 1) && (strcmp(argv[1], "--update") == 0);
+    bool passed = true;
+    for (uint8_t rotation = 0; rotation < 4; rotation++)
+    {
+        TinyTextCanvas canvas;
+        TinyTextCanvas panel;
+        if (!canvas.Begin() || !panel.Begin())
+        {
+            printf("can't allocate the canvases\n");
+            return 1;
+        }
+        MockReset(PIN_CS, PIN_DC);
+        MockAttach(&panel);
+        TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+        tft.SetCanvas(&canvas);
+        tft.Begin();
+        scene(tft, rotation);
+
+        StringPrint picture;
+        canvas.WritePPM(picture);
+        char path[32];
+        snprintf(path, sizeof(path), "Golden/rotation%u.ppm", rotation);
+        if (update)
+        {
+            FILE* file = fopen(path, "wb");
+            if ((file == NULL) || (fwrite(picture.text.data(), 1, picture.text.size(), file) != picture.text.size()))
+            {
+                printf("can't write %s\n", path);
+                return 1;
+            }
+            fclose(file);
+            printf("wrote %s\n", path);
+            continue;
+        }
+
+        std::string golden;
+        FILE* file = fopen(path, "rb");
+        if (file != NULL)
+        {
+            char buffer[4096];
+            size_t len;
+            while ((len = fread(buffer, 1, sizeof(buffer), file)) > 0)
+            {
+                golden.append(buffer, len);
+            }
+            fclose(file);
+        }
+        uint32_t different = 0;
+        if (golden.size() != picture.text.size())
+        {
+            printf("rotation %u: %s is missing or not the same size\n", rotation, path);
+            different = 1;
+        }
+        else
+        {
+            size_t header = picture.text.size() - (size_t)canvas.Width() * canvas.Height() * 3;
+            for (size_t i = header; i < golden.size(); i += 3)
+            {
+                different += (memcmp(&golden[i], &picture.text[i], 3) != 0);
+            }
+        }
+        if (different != 0)
+        {
+            snprintf(path, sizeof(path), "rotation%u.new.ppm", rotation);
+            FILE* out = fopen(path, "wb");
+            if (out != NULL)
+            {
+                fwrite(picture.text.data(), 1, picture.text.size(), out);
+                fclose(out);
+            }
+            passed = false;
+        }
+
+        // the same picture on a panel, in one transfer
+        tft.SetCanvas(NULL);
+        tft.SetRotation(rotation); // the panel hasn't had the MADCTL yet
+        tft.PushCanvas(&canvas);
+        uint32_t pushed = 0;
+        for (uint16_t y = 0; y < canvas.Height(); y++)
+        {
+            for (uint16_t x = 0; x < canvas.Width(); x++)
+            {
+                pushed += (canvas.GetPixel(x, y) != panel.GetPixel(x, y));
+            }
+        }
+        passed &= (pushed == 0);
+        printf("rotation %u: %6u pixels differ from the golden image, %6u on the panel after PushCanvas\n", rotation, different, pushed);
+    }
+    if (update)
+    {
+        return 0;
+    }
+
+    // throughput
+    TinyTextCanvas canvas;
+    canvas.Begin();
+    uint32_t screens = 0;
+    double start = now();
+    double elapsed;
+    do
+    {
+        TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+        tft.SetCanvas(&canvas);
+        tft.Begin();
+        scene(tft, screens % 4);
+        tft.DisableGrid();
+        tft.SetCanvas(NULL); // frees what the canvas path took
+        screens++;
+        elapsed = now() - start;
+    }
+    while (elapsed < 1);
+    printf("%.0f screens a second\n", screens / elapsed);
+
+    printf(passed ? "passed\n" : "FAILED\n");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+/*
+  TinyTextTuneClock against a mock ILI9341 whose bus corrupts bytes above a
+  given clock, to check the search settles below the limit on a PC.
+
+    g++ -std=c++11 -O2 -I../../Library ClockMock.cpp ../../Library/TinyTextClock.cpp -o ClockMock
+    ./ClockMock                      (a table of limits)
+    ./ClockMock writeMHz readMHz     (one panel)
+
+  The mock keeps a frame memory for CASET, PASET, RAMWR and RAMRD. Above the write
+  limit a byte written picks up a flipped bit now and then, above the read limit
+  so does a byte read, more often the further over the limit the clock is. A
+  read limit of 0 stands for MISO not being connected (reads are all 0xFF).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "TinyTextClock.h"
+
+#define MOCK_WIDTH  240
+#define MOCK_HEIGHT 320
+
+class MockPanel : public TinyTextClockBus
+{
+private:
+    uint16_t _frame[MOCK_WIDTH * MOCK_HEIGHT];
+    uint32_t _freq;
+    uint32_t _writeLimit;
+    uint32_t _readLimit;
+    uint32_t _random;
+    uint16_t _columns[2];
+    uint16_t _pages[2];
+
+    uint8_t corrupt(uint8_t b, uint32_t limit)
+    {
+        // past the limit: a flipped bit in 1 byte of 200, up to every byte at twice the limit
+        if (_freq <= limit)
+        {
+            return b;
+        }
+        _random = _random * 1103515245 + 12345;
+        uint32_t over = (uint32_t)(200.0 * (_freq - limit) / limit) + 1;
+        if ((_random >> 8) % 200 < over)
+        {
+            b ^= 1 << ((_random >> 20) & 7);
+        }
+        return b;
+    }
+
+public:
+    uint32_t bytes; // bus traffic, as a measure of the time taken
+
+    MockPanel(uint32_t writeLimit, uint32_t readLimit)
+    {
+        for (uint32_t i = 0; i < MOCK_WIDTH * MOCK_HEIGHT; i++)
+        {
+            _frame[i] = 0;
+        }
+        _freq = 0;
+        _writeLimit = writeLimit;
+        _readLimit = readLimit;
+        _random = 1;
+        _columns[0] = 0;
+        _columns[1] = MOCK_WIDTH - 1;
+        _pages[0] = 0;
+        _pages[1] = MOCK_HEIGHT - 1;
+        bytes = 0;
+    }
+
+    virtual void SetFrequency(uint32_t freq)
+    {
+        _freq = freq;
+    }
+
+    virtual void Write(uint8_t command, const uint8_t* data, uint16_t len)
+    {
+        uint8_t in[640];
+        bytes += 1 + len;
+        for (uint16_t i = 0; (i < len) && (i < sizeof(in)); i++)
+        {
+            in[i] = corrupt(data[i], _writeLimit);
+        }
+        switch (command)
+        {
+        case 0x2A: // CASET
+        case 0x2B: // PASET
+        {
+            uint16_t* range = (command == 0x2A) ? _columns : _pages;
+            range[0] = (in[0] << 8) | in[1];
+            range[1] = (in[2] << 8) | in[3];
+            break;
+        }
+        case 0x2C: // RAMWR
+        {
+            uint16_t x = _columns[0];
+            uint16_t y = _pages[0];
+            for (uint16_t i = 0; i + 1 < len; i += 2)
+            {
+                if ((x < MOCK_WIDTH) && (y < MOCK_HEIGHT))
+                {
+                    _frame[y * MOCK_WIDTH + x] = (in[i] << 8) | in[i + 1];
+                }
+                if (++x > _columns[1])
+                {
+                    x = _columns[0];
+                    y++;
+                }
+            }
+            break;
+        }
+        }
+    }
+
+    virtual void Read(uint8_t command, uint8_t* data, uint16_t len)
+    {
+        bytes += 1 + len;
+        uint16_t x = _columns[0];
+        uint16_t y = _pages[0];
+        for (uint16_t i = 0; i < len; i++)
+        {
+            uint8_t b = 0;
+            if ((command == 0x2E) && (i != 0)) // RAMRD, after the dummy byte
+            {
+                uint16_t pixel = ((x < MOCK_WIDTH) && (y < MOCK_HEIGHT)) ? _frame[y * MOCK_WIDTH + x] : 0;
+                uint8_t component = (i - 1) % 3;
+                // 6 bits each, the top bit repeated below a 5 bit component
+                b = (component == 0) ? (((pixel >> 11) << 3) | ((pixel >> 13) & 4))
+                  : (component == 1) ? (((pixel >> 5) & 0x3F) << 2)
+                                     : (((pixel & 0x1F) << 3) | ((pixel >> 2) & 4));
+                if (component == 2)
+                {
+                    if (++x > _columns[1])
+                    {
+                        x = _columns[0];
+                        y++;
+                    }
+                }
+            }
+            data[i] = (_readLimit == 0) ? 0xFF : corrupt(b, _readLimit);
+        }
+    }
+};
+
+static uint32_t tune(uint32_t writeLimit, uint32_t readLimit, uint32_t& bytes)
+{
+    MockPanel panel(writeLimit, readLimit);
+    uint32_t freq = TinyTextTuneClock(panel, 4000000, 80000000, 6000000, 20); // TINYTEXT_READ_FREQ
+    bytes = panel.bytes;
+    return freq;
+}
+
+int main(int argc, char** argv)
+{
+    static const uint32_t limits[][2] =
+    {
+        { 100000000, 100000000 }, // faster than anything tried
+        { 62500000, 10000000 },
+        { 42000000, 20000000 },
+        { 30000000, 30000000 },
+        { 24000000, 24000000 },   // long cable
+        { 12000000, 8000000 },
+        { 60000000, 6600000 },    // the ILI9341's read limit
+        { 8000000, 5000000 },     // reads fail at TINYTEXT_READ_FREQ: gives up
+        { 3000000, 3000000 },     // nothing works
+        { 40000000, 0 },          // MISO not connected
+    };
+    uint8_t count = sizeof(limits) / sizeof(limits[0]);
+    uint32_t one[1][2];
+    const uint32_t (*panels)[2] = limits;
+    if (argc > 2)
+    {
+        one[0][0] = (uint32_t)(atof(argv[1]) * 1e6);
+        one[0][1] = (uint32_t)(atof(argv[2]) * 1e6);
+        panels = one;
+        count = 1;
+    }
+
+    uint8_t bad = 0;
+    printf("write limit   read limit   chosen      bus bytes\n");
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint32_t bytes;
+        uint32_t freq = tune(panels[i][0], panels[i][1], bytes);
+        // under the write limit, and 0 only when the reads fail at TINYTEXT_READ_FREQ
+        // or nothing works
+        bool ok = (freq < panels[i][0]) || (panels[i][0] >= 80000000);
+        ok &= (freq == 0) == ((panels[i][1] < 6000000) || (panels[i][0] < 4000000));
+        bad += !ok;
+        printf("%8.2f MHz %9.2f MHz %8.2f MHz %8u  %s\n", panels[i][0] / 1e6, panels[i][1] / 1e6, freq / 1e6,
+               (unsigned)bytes, ok ? "" : "over the limit");
+    }
+    return bad;
+}
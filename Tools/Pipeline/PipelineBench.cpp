@@ -0,0 +1,161 @@
+/*
+  Throughput of TinyTextTFT with and without its render/send pipeline on a PC:
+  the library itself, built against the mock Arduino.h and SPI.h of
+  Tools/Bench, with std::thread for the consumer task. The mock bus is paced
+  (MockPace) so each byte takes as long on the PC's clock as it would at the
+  given SPI clock, and the consumer stage is as slow as a panel.
+
+    g++ -std=c++11 -O2 -DTINYTEXT_PIPELINE_STD_THREAD -pthread -I../Bench -I../../Library PipelineBench.cpp \
+        ../Bench/ArduinoMock.cpp ../../Library/TinyTextTFT.cpp ../../Library/TinyTextBus.cpp ../../Library/TinyTextBlend.cpp \
+        ../../Library/TinyTextCanvas.cpp ../../Library/TinyTextClock.cpp ../../Library/TinyTextPipeline.cpp -o PipelineBench
+    ./PipelineBench [SPI MHz] [lines]
+
+  Each frame is a screen of text in rotation 1 (64 x 24 cells) drawn a row at
+  a time with DrawRun, a colour pair per cell. It is drawn three ways: without
+  the pipeline, with it inline (one thread) and threaded. Reports cells per
+  second overall and, with the pipeline, for each stage on its own (the time
+  it spent working, not waiting). The three must send the same bytes and leave
+  the same picture; exits 1 if they don't.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "ArduinoMock.h"
+#include "TinyTextTFT.h"
+
+#define PIN_CS 10
+#define PIN_DC 9
+
+#define FRAMES 20
+
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void frame(TinyTextTFT& tft, uint32_t seed)
+{
+    // every row as one run, a colour pair per cell
+    static const uint16_t fores[] = { 0xFFF, 0xFF0, 0x0F0, 0xF00, 0x0FF, 0xF0F, 0x888, 0x000 };
+    static const uint16_t backs[] = { 0x000, 0x00F, 0x07D, 0x333, 0x700, 0x070, 0x007, 0xFFF };
+    for (uint8_t row = 0; row < tft.Rows(); row++)
+    {
+        char text[64];
+        uint16_t fore[64];
+        uint16_t back[64];
+        for (uint8_t col = 0; col < tft.Columns(); col++)
+        {
+            uint32_t cell = (seed + row * tft.Columns() + col) * 2654435761u;
+            text[col] = ' ' + (cell >> 8) % 95;
+            fore[col] = fores[(cell >> 20) & 7];
+            back[col] = backs[(cell >> 24) & 7];
+        }
+        tft.DrawRun(0, row, text, fore, back, tft.Columns());
+    }
+}
+
+struct Run
+{
+    uint64_t bytes;
+    uint32_t picture; // FNV-1a of the canvas
+};
+
+static uint32_t pictureHash(TinyTextCanvas& canvas)
+{
+    uint32_t hash = 2166136261UL;
+    for (uint16_t y = 0; y < canvas.Height(); y++)
+    {
+        for (uint16_t x = 0; x < canvas.Width(); x++)
+        {
+            uint16_t pixel = canvas.GetPixel(x, y);
+            hash = (hash ^ (pixel & 0xFF)) * 16777619UL;
+            hash = (hash ^ (pixel >> 8)) * 16777619UL;
+        }
+    }
+    return hash;
+}
+
+static bool run(const char* name, uint32_t freq, uint8_t lines, uint8_t mode, Run& result)
+{
+    // mode 0 without the pipeline, 1 inline, 2 threaded
+    TinyTextCanvas canvas;
+    if (!canvas.Begin())
+    {
+        printf("can't allocate the canvas\n");
+        return false;
+    }
+    MockReset(PIN_CS, PIN_DC);
+    MockAttach(&canvas);
+    TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+    tft.SetFrequency(freq);
+    tft.Begin();
+    tft.SetRotation(1);
+    if ((mode != 0) && !tft.EnablePipeline(lines, mode == 2))
+    {
+        printf("%-10s can't enable the pipeline\n", name);
+        return false;
+    }
+    if ((mode == 2) && !tft.PipelineThreaded())
+    {
+        printf("%-10s no consumer thread\n", name);
+        return false;
+    }
+
+    MockResetCounts();
+    MockPace(true);
+    tft.ResetPipelineStats();
+    double start = now();
+    for (uint32_t f = 0; f < FRAMES; f++)
+    {
+        frame(tft, f);
+    }
+    double seconds = now() - start;
+    MockPace(false);
+
+    double cells = (double)FRAMES * tft.Columns() * tft.Rows();
+    printf("%-10s overall %9.0f cells/s", name, cells / seconds);
+    if (mode != 0)
+    {
+        const TinyTextPipelineStats& stats = tft.GetPipelineStats();
+        printf("   render %9.0f cells/s   send %9.0f cells/s   stalled %5.1f%%", cells / (stats.renderMicros / 1e6),
+               cells / (stats.sendMicros / 1e6), 100.0 * stats.stallMicros / 1e6 / seconds);
+    }
+    printf("\n");
+    tft.DisablePipeline();
+    result.bytes = MockCounts().bytes;
+    result.picture = pictureHash(canvas);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    double mhz = (argc > 1) ? atof(argv[1]) : 40;
+    int lines = (argc > 2) ? atoi(argv[2]) : 4;
+    if ((mhz <= 0) || (lines < 2))
+    {
+        printf("usage: PipelineBench [SPI MHz] [lines]\n");
+        return 1;
+    }
+    uint32_t freq = (uint32_t)(mhz * 1e6);
+
+    printf("%d frames of 64 x 24 cells, SPI at %.0f MHz, %d lines in the ring\n\n", FRAMES, mhz, lines);
+    Run direct;
+    Run inlined;
+    Run threaded;
+    if (!run("direct", freq, lines, 0, direct) || !run("inline", freq, lines, 1, inlined) ||
+        !run("threaded", freq, lines, 2, threaded))
+    {
+        return 1;
+    }
+    if ((inlined.bytes != direct.bytes) || (threaded.bytes != direct.bytes) ||
+        (inlined.picture != direct.picture) || (threaded.picture != direct.picture))
+    {
+        printf("\nthe pipeline changed what was sent: %llu, %llu and %llu bytes, pictures %08x, %08x and %08x\n",
+               (unsigned long long)direct.bytes, (unsigned long long)inlined.bytes, (unsigned long long)threaded.bytes,
+               direct.picture, inlined.picture, threaded.picture);
+        return 1;
+    }
+    printf("\nthe same %llu bytes and picture each way\n", (unsigned long long)direct.bytes);
+    return 0;
+}
@@ -0,0 +1,307 @@
+/*
+  TinyTextQueue under load on a PC: several std::thread producers, each with
+  a queue of its own (a queue has one producer), and one consumer servicing
+  all of them onto one TinyTextTFT on the mock SPI bus of Tools/Bench.
+
+    g++ -std=c++11 -O2 -pthread -I../Bench -I../../Library QueueTest.cpp ../Bench/ArduinoMock.cpp \
+        ../../Library/TinyTextQueue.cpp ../../Library/TinyTextTFT.cpp ../../Library/TinyTextBus.cpp ../../Library/TinyTextBlend.cpp \
+        ../../Library/TinyTextCanvas.cpp ../../Library/TinyTextClock.cpp ../../Library/TinyTextPipeline.cpp -o QueueTest
+    ./QueueTest [producers] [messages each]
+
+  A message is a one cell FillCells that carries its producer and sequence
+  number: the producer in the column, the rest in the row and the colour. The
+  consumer reads them back off the bus as they are drawn, the colour from the
+  first pixel (a fill is blended like the background of a cell, which loses
+  the lowest level of each channel, so only levels 1 to 15 are used). The
+  producers post in bursts so the queues fill up now and then. For each
+  overflow mode it checks, for every producer:
+    - messages taken plus dropped is messages posted
+    - the messages drawn are in the order they were posted, none twice
+    - DROP_NEWEST and MERGE_DIRTY draw exactly the messages that were accepted
+    - MERGE_DIRTY reports a region covering every message it dropped
+  Exits 1 if anything fails.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "ArduinoMock.h"
+#include "TinyTextTFT.h"
+#include "TinyTextQueue.h"
+
+#define PIN_CS 10
+#define PIN_DC 9
+
+#define MAX_PRODUCERS 8
+#define ROWS          24 // rotation 1
+#define LEVELS        15 // of each channel, 1 to 15
+#define COLORS        (LEVELS * LEVELS * LEVELS)
+
+struct Region
+{
+    uint8_t col;
+    uint8_t row;
+    uint8_t w;
+    uint8_t h;
+};
+
+static std::vector<uint32_t> drawn[MAX_PRODUCERS];   // sequence numbers, as they reach the bus
+static std::vector<Region>   regions[MAX_PRODUCERS]; // given to the region callback
+static uint32_t decodeErrors = 0;
+static uint16_t colorIndex[65536]; // first pixel of a fill to its colour's index, COLORS if none
+static int32_t  lastPixel;         // while colorIndex is worked out
+
+// the bus decoded far enough to see each cell fill: window, then its first pixel
+static uint8_t  command;
+static uint8_t  argCount;
+static uint8_t  args[4];
+static uint16_t windowX;
+static uint16_t windowY;
+static uint8_t  pixelBytes;
+static uint8_t  pixelHigh;
+
+static void watch(uint8_t b, bool isCommand)
+{
+    if (isCommand)
+    {
+        command = b;
+        argCount = 0;
+        pixelBytes = 0;
+        return;
+    }
+    if ((command == 0x2A) || (command == 0x2B)) // CASET, PASET
+    {
+        if (argCount < 4)
+        {
+            args[argCount++] = b;
+        }
+        if (argCount == 2)
+        {
+            *((command == 0x2A) ? &windowX : &windowY) = (args[0] << 8) | args[1];
+        }
+        return;
+    }
+    if ((command != 0x2C) || (pixelBytes >= 2)) // RAMWR
+    {
+        return;
+    }
+    if (pixelBytes++ == 0)
+    {
+        pixelHigh = b;
+        return;
+    }
+    uint16_t pixel = (pixelHigh << 8) | b;
+    if (lastPixel >= 0)
+    {
+        lastPixel = pixel;
+        return;
+    }
+    uint8_t producer = windowX / 5;
+    uint8_t row = windowY / 10;
+    if ((producer >= MAX_PRODUCERS) || (row >= ROWS) || (colorIndex[pixel] == COLORS))
+    {
+        decodeErrors++;
+        return;
+    }
+    drawn[producer].push_back((uint32_t)row * COLORS + colorIndex[pixel]);
+}
+
+static uint16_t sequenceColor(uint32_t seq)
+{
+    uint16_t i = seq % COLORS;
+    return ((i / (LEVELS * LEVELS) + 1) << 8) | (((i / LEVELS) % LEVELS + 1) << 4) | (i % LEVELS + 1);
+}
+
+static bool learnColors(TinyTextTFT& tft)
+{
+    // fills a cell in every colour used and notes the pixel each gives
+    for (uint32_t i = 0; i < 65536; i++)
+    {
+        colorIndex[i] = COLORS;
+    }
+    for (uint16_t i = 0; i < COLORS; i++)
+    {
+        lastPixel = 0;
+        tft.FillCells(0, 0, 1, 1, sequenceColor(i));
+        if (colorIndex[lastPixel] != COLORS)
+        {
+            return false; // two colours look the same
+        }
+        colorIndex[lastPixel] = i;
+    }
+    lastPixel = -1;
+    return true;
+}
+
+template <int P> static void region(uint8_t col, uint8_t row, uint8_t w, uint8_t h)
+{
+    Region r = { col, row, w, h };
+    regions[P].push_back(r);
+}
+
+static const TinyTextRegionCallback regionCallbacks[MAX_PRODUCERS] =
+{
+    region<0>, region<1>, region<2>, region<3>, region<4>, region<5>, region<6>, region<7>
+};
+
+static bool covered(const std::vector<Region>& list, uint8_t col, uint8_t row)
+{
+    for (size_t i = 0; i < list.size(); i++)
+    {
+        const Region& r = list[i];
+        if ((col >= r.col) && (col < r.col + r.w) && (row >= r.row) && (row < r.row + r.h))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char** argv)
+{
+    int producers = (argc > 1) ? atoi(argv[1]) : 4;
+    uint32_t messages = (argc > 2) ? atoi(argv[2]) : 50000;
+    if ((producers < 1) || (producers > MAX_PRODUCERS) || (messages < 1) || (messages > ROWS * COLORS))
+    {
+        printf("usage: QueueTest [producers 1..%d] [messages each, up to %d]\n", MAX_PRODUCERS, ROWS * COLORS);
+        return 1;
+    }
+
+    static const char* modeNames[] = { "DROP_NEWEST", "DROP_OLDEST", "MERGE_DIRTY" };
+    uint32_t failures = 0;
+    for (uint8_t mode = TINYTEXT_DROP_NEWEST; mode <= TINYTEXT_MERGE_DIRTY; mode++)
+    {
+        MockReset(PIN_CS, PIN_DC);
+        TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+        tft.Begin();
+        tft.SetRotation(1);
+        MockWatch(watch);
+        if (!learnColors(tft))
+        {
+            printf("the fill colours can't be told apart\n");
+            return 1;
+        }
+        // from here on only the producers' fills are drawn
+
+        TinyTextQueue* queues[MAX_PRODUCERS];
+        std::vector<bool> accepted[MAX_PRODUCERS];
+        uint32_t taken[MAX_PRODUCERS];
+        for (int p = 0; p < producers; p++)
+        {
+            queues[p] = new TinyTextQueue(&tft);
+            queues[p]->SetOverflow((TinyTextOverflow)mode);
+            queues[p]->SetRegionCallback(regionCallbacks[p]);
+            accepted[p].assign(messages, false);
+            taken[p] = 0;
+            drawn[p].clear();
+            regions[p].clear();
+        }
+        decodeErrors = 0;
+
+        std::atomic<int> running(producers);
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; p++)
+        {
+            threads.push_back(std::thread([&, p]()
+            {
+                for (uint32_t seq = 0; seq < messages; seq++)
+                {
+                    accepted[p][seq] = queues[p]->FillCells(p, seq / COLORS, 1, 1, sequenceColor(seq));
+                    if ((seq % 48) == 0)
+                    {
+                        // in bursts, so the queues overflow at times and not always
+                        std::this_thread::sleep_for(std::chrono::microseconds(20 + 10 * p));
+                    }
+                }
+                running--;
+            }));
+        }
+
+        // the consumer
+        bool more = true;
+        while (more)
+        {
+            bool producing = (running.load() != 0);
+            more = producing;
+            for (int p = 0; p < producers; p++)
+            {
+                taken[p] += queues[p]->Service();
+                more |= (queues[p]->Count() != 0);
+            }
+        }
+        for (size_t i = 0; i < threads.size(); i++)
+        {
+            threads[i].join();
+        }
+        for (int p = 0; p < producers; p++)
+        {
+            taken[p] += queues[p]->Service();
+        }
+
+        for (int p = 0; p < producers; p++)
+        {
+            const char* problem = NULL;
+            uint32_t dropped = queues[p]->Dropped();
+            uint32_t acceptedCount = 0;
+            for (uint32_t seq = 0; seq < messages; seq++)
+            {
+                acceptedCount += accepted[p][seq];
+            }
+            if (taken[p] + dropped != messages)
+            {
+                problem = "taken + dropped isn't posted";
+            }
+            if (drawn[p].size() != taken[p])
+            {
+                problem = "not every message taken was drawn";
+            }
+            for (size_t i = 1; i < drawn[p].size(); i++)
+            {
+                if (drawn[p][i] <= drawn[p][i - 1])
+                {
+                    problem = "out of order";
+                }
+            }
+            if (mode != TINYTEXT_DROP_OLDEST)
+            {
+                if (acceptedCount != taken[p])
+                {
+                    problem = "the messages drawn aren't the ones accepted";
+                }
+                for (size_t i = 0; i < drawn[p].size(); i++)
+                {
+                    if ((drawn[p][i] >= messages) || !accepted[p][drawn[p][i]])
+                    {
+                        problem = "a message that was dropped was drawn";
+                    }
+                }
+            }
+            if (mode == TINYTEXT_MERGE_DIRTY)
+            {
+                for (uint32_t seq = 0; seq < messages; seq++)
+                {
+                    if (!accepted[p][seq] && !covered(regions[p], p, seq / COLORS))
+                    {
+                        problem = "a dropped message isn't in any region";
+                        break;
+                    }
+                }
+            }
+            printf("%-11s producer %d: %6u posted, %6u taken, %6u dropped, high water %2u, %5u regions%s%s\n",
+                   modeNames[mode], p, messages, taken[p], dropped, queues[p]->HighWater(), (unsigned)regions[p].size(),
+                   problem ? ": " : "", problem ? problem : "");
+            failures += (problem != NULL);
+            delete queues[p];
+        }
+        if (decodeErrors != 0)
+        {
+            printf("%-11s %u fills drawn where no producer puts them\n", modeNames[mode], decodeErrors);
+            failures++;
+        }
+    }
+    printf(failures ? "FAILED\n" : "passed\n");
+    return failures ? 1 : 0;
+}
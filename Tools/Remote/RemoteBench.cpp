@@ -0,0 +1,162 @@
+/*
+  Link bytes the remote protocol takes for a few typical screens, compared with
+  sending every changed cell as a DrawChar call would take it (column, row,
+  character and two colours: 7 bytes), and the time each takes on the wire.
+
+    g++ -std=c++11 -O2 RemoteBench.cpp TinyTextEncoder.cpp -o RemoteBench
+    ./RemoteBench [baud]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "TinyTextEncoder.h"
+
+#define VERBOSE_CELL_BYTES 7
+
+static uint32_t baud = 921600;
+
+static void report(const char* name, size_t bytes, uint32_t cells)
+{
+    // 10 bits a byte on a UART
+    printf("%-28s %6u bytes %8.2f ms   verbose %6u bytes %8.2f ms   %5.1fx\n", name,
+           (unsigned)bytes, bytes * 10000.0 / baud,
+           (unsigned)(cells * VERBOSE_CELL_BYTES), cells * VERBOSE_CELL_BYTES * 10000.0 / baud,
+           bytes ? (double)cells * VERBOSE_CELL_BYTES / bytes : 0.0);
+}
+
+static uint32_t countChanged(TinyTextEncoder& before, TinyTextEncoder& after)
+{
+    uint32_t changed = 0;
+    for (uint8_t row = 0; row < after.Rows(); row++)
+    {
+        for (uint8_t col = 0; col < after.Columns(); col++)
+        {
+            const TinyTextEncoderCell& a = before.Cell(col, row);
+            const TinyTextEncoderCell& b = after.Cell(col, row);
+            if ((a.code != b.code) || (a.foreColor != b.foreColor) || (a.backColor != b.backColor))
+            {
+                changed++;
+            }
+        }
+    }
+    return changed;
+}
+
+static size_t measure(const char* name, TinyTextEncoder& encoder, void (*change)(TinyTextEncoder&, int), int frames)
+{
+    // average bytes of frames deltas after change
+    std::vector<uint8_t> out;
+    size_t total = 0;
+    uint32_t cells = 0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        TinyTextEncoder before = encoder;
+        change(encoder, frame);
+        cells += countChanged(before, encoder);
+        out.clear();
+        total += encoder.Encode(out);
+    }
+    report(name, total / frames, cells / frames);
+    return total / frames;
+}
+
+static void logLine(TinyTextEncoder& encoder, int frame)
+{
+    // a log scrolling up a line at a time
+    char line[80];
+    for (uint8_t row = 1; row < encoder.Rows(); row++)
+    {
+        for (uint8_t col = 0; col < encoder.Columns(); col++)
+        {
+            const TinyTextEncoderCell& c = encoder.Cell(col, row);
+            encoder.Put(col, row - 1, c.code, c.foreColor, c.backColor);
+        }
+    }
+    snprintf(line, sizeof(line), "%06d INFO sensor %2d read %4d mV, retry %d", 1000 + frame, frame % 17, (frame * 37) % 5000, frame % 3);
+    encoder.Fill(0, encoder.Rows() - 1, encoder.Columns(), 1, 0x000);
+    encoder.Print(0, encoder.Rows() - 1, line, (frame % 5) ? 0xCCC : 0xF80, 0x000);
+}
+
+static void clock(TinyTextEncoder& encoder, int frame)
+{
+    char text[16];
+    snprintf(text, sizeof(text), "12:%02d:%02d", (frame / 60) % 60, frame % 60);
+    encoder.Print(55, 0, text, 0xFFF, 0x008);
+}
+
+static void dashboard(TinyTextEncoder& encoder, int frame)
+{
+    // eight numeric fields, most of which change every frame
+    char text[16];
+    for (int field = 0; field < 8; field++)
+    {
+        snprintf(text, sizeof(text), "%7.2f", 20.0 + field + ((frame * (field + 3)) % 100) / 7.0);
+        encoder.Print(20, 3 + 2 * field, text, (field & 1) ? 0x0F0 : 0xFF0, 0x000);
+    }
+}
+
+static void bars(TinyTextEncoder& encoder, int frame)
+{
+    // bar graph of block characters
+    for (int bar = 0; bar < 8; bar++)
+    {
+        int len = (frame * (bar + 1) * 7) % 40;
+        for (int col = 0; col < 40; col++)
+        {
+            encoder.Put(20 + col, 3 + 2 * bar, (col < len) ? 0x2588 : 0x2591, 0x0AF, 0x000);
+        }
+    }
+}
+
+static void fillText(TinyTextEncoder& encoder)
+{
+    // a full screen of mixed text: heading, table and a framed status line
+    encoder.Fill(0, 0, encoder.Columns(), encoder.Rows(), 0x000);
+    encoder.Fill(0, 0, encoder.Columns(), 1, 0x008);
+    encoder.Print(1, 0, "TinyText remote  \xE2\x86\x91 921600 baud", 0xFFF, 0x008);
+    char line[80];
+    for (uint8_t row = 2; row < encoder.Rows() - 3; row++)
+    {
+        snprintf(line, sizeof(line), "%2d  channel-%02d  %6.1f\xC2\xB0""C  %5d rpm  %s", row, row * 3, 20.5 + row * 1.7, row * 113, (row % 4) ? "ok" : "FAULT");
+        encoder.Print(1, row, line, (row % 4) ? 0xCCC : 0xF44, 0x000);
+    }
+    encoder.Print(0, encoder.Rows() - 3, "\xE2\x94\x8C\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x90", 0x888, 0x000);
+    encoder.Print(0, encoder.Rows() - 2, "\xE2\x94\x82 status ok\xE2\x94\x82", 0x0F0, 0x000);
+    encoder.Print(0, encoder.Rows() - 1, "\xE2\x94\x94\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x80\xE2\x94\x98", 0x888, 0x000);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1)
+    {
+        baud = atoi(argv[1]);
+    }
+    printf("64 x 24 cells at %u baud, averages per update\n\n", baud);
+
+    TinyTextEncoder encoder;
+    std::vector<uint8_t> out;
+
+    fillText(encoder);
+    uint32_t cells = encoder.Columns() * encoder.Rows();
+    report("full screen", encoder.EncodeFull(out), cells);
+
+    // every cell different: worst case for a full screen
+    for (uint8_t row = 0; row < encoder.Rows(); row++)
+    {
+        for (uint8_t col = 0; col < encoder.Columns(); col++)
+        {
+            encoder.Put(col, row, '!' + (row * 7 + col * 3) % 90, 0x111 * (1 + (col + row) % 15), (row & 1) ? 0x000 : 0x004);
+        }
+    }
+    out.clear();
+    report("full screen, every cell", encoder.EncodeFull(out), cells);
+
+    fillText(encoder);
+    out.clear();
+    encoder.EncodeFull(out);
+    measure("delta: clock seconds", encoder, clock, 120);
+    measure("delta: dashboard fields", encoder, dashboard, 100);
+    measure("delta: bar graph", encoder, bars, 100);
+    measure("delta: log line (scroll)", encoder, logLine, 100);
+    return 0;
+}
@@ -0,0 +1,188 @@
+/*
+  The remote protocol end to end on a PC: frames drawn with TinyTextEncoder are
+  encoded, decoded by a TinyTextRemote driving a TinyTextTFT on the mock SPI bus
+  of Tools/Bench (a canvas attached), and after every frame the panel is compared
+  pixel for pixel with the encoder's cells drawn directly with DrawCode.
+
+    g++ -std=c++11 -O2 -I../Bench -I../../Library RemoteTest.cpp TinyTextEncoder.cpp ../Bench/ArduinoMock.cpp \
+        ../../Library/TinyTextTFT.cpp ../../Library/TinyTextBus.cpp ../../Library/TinyTextBlend.cpp \
+        ../../Library/TinyTextCanvas.cpp ../../Library/TinyTextClock.cpp ../../Library/TinyTextPipeline.cpp \
+        ../../Library/TinyTextRemote.cpp -o RemoteTest
+    ./RemoteTest
+
+  The frames are a log scrolling up a few rows at a time under a title and over
+  a status line, so the encoder sends SCROLL, with some scattered cells changing
+  too. Every rotation is run with and without the shadow grid, and with SCROLL
+  allowed and turned off in the encoder. Where the remote can't scroll (no grid
+  in rotations 1 and 3) it has to ask for a resync rather than drift, and
+  nowhere else. Exits 1 if any run fails.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "ArduinoMock.h"
+#include "TinyTextTFT.h"
+#include "TinyTextRemote.h"
+#include "TinyTextEncoder.h"
+
+#define PIN_CS 10
+#define PIN_DC 9
+
+#define FRAMES 40
+
+static TinyTextCanvas panel;    // drawn by the remote, through the bus
+static TinyTextCanvas expected; // the encoder's cells, drawn directly
+
+// The link back to the host: what the remote writes, nothing to read.
+class ReplyStream : public Stream
+{
+public:
+    std::vector<uint8_t> written;
+
+    virtual size_t write(uint8_t c) { written.push_back(c); return 1; }
+    using Print::write;
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+};
+
+static void frame(TinyTextEncoder& encoder, int n, uint32_t& random)
+{
+    // the log moves up 1..3 rows between the title (row 0) and the status (last row)
+    static const uint16_t colors[] = { 0xFFF, 0xFF0, 0x0F0, 0xF80, 0x8CF };
+    uint8_t rows = encoder.Rows();
+    uint8_t columns = encoder.Columns();
+    uint8_t moved = 1 + n % 3;
+    for (uint8_t row = 1; row + moved < rows - 1; row++)
+    {
+        for (uint8_t col = 0; col < columns; col++)
+        {
+            const TinyTextEncoderCell& from = encoder.Cell(col, row + moved);
+            encoder.Put(col, row, from.code, from.foreColor, from.backColor);
+        }
+    }
+    char line[80];
+    for (uint8_t i = 0; i < moved; i++)
+    {
+        uint8_t row = rows - 1 - moved + i;
+        encoder.Fill(0, row, columns, 1, 0x000);
+        snprintf(line, sizeof(line), "%05d log line, \xE2\x86\x92 some text \xC2\xB0" "C %u", n, (unsigned)(random % 1000));
+        encoder.Print(0, row, line, colors[(n + i) % 5], 0x000);
+        random = random * 1103515245 + 12345;
+    }
+    snprintf(line, sizeof(line), " frame %d  \xE2\x96\x88\xE2\x96\x92 ", n);
+    encoder.Fill(0, rows - 1, columns, 1, 0x00F);
+    encoder.Print(0, rows - 1, line, 0xFFF, 0x00F);
+    for (uint8_t i = 0; i < 6; i++)
+    {
+        random = random * 1103515245 + 12345;
+        encoder.Put((random >> 8) % columns, 1 + (random >> 16) % (rows - 2), 'A' + i, colors[i % 5], 0x222);
+    }
+}
+
+// Pixels of the panel that differ from the encoder's screen.
+static uint32_t compare(TinyTextEncoder& encoder, uint8_t rotation)
+{
+    TinyTextTFT ref(PIN_CS, PIN_DC, -1);
+    ref.SetCanvas(&expected);
+    ref.Begin();
+    ref.SetRotation(rotation);
+    for (uint8_t row = 0; row < encoder.Rows(); row++)
+    {
+        for (uint8_t col = 0; col < encoder.Columns(); col++)
+        {
+            const TinyTextEncoderCell& c = encoder.Cell(col, row);
+            ref.DrawCode(col, row, c.code, c.foreColor, c.backColor);
+        }
+    }
+    ref.SetCanvas(NULL);
+
+    uint32_t differ = 0;
+    for (uint16_t y = 0; y < panel.Height(); y++)
+    {
+        for (uint16_t x = 0; x < panel.Width(); x++)
+        {
+            differ += (panel.GetPixel(x, y) != expected.GetPixel(x, y));
+        }
+    }
+    return differ;
+}
+
+static bool run(uint8_t rotation, bool grid, bool scroll)
+{
+    MockReset(PIN_CS, PIN_DC);
+    MockAttach(&panel);
+    TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+    tft.Begin();
+    tft.SetRotation(rotation);
+    if (grid)
+    {
+        tft.EnableGrid();
+    }
+    tft.FillScreen(RGB444_BLACK);
+
+    TinyTextEncoder encoder(tft.Columns(), tft.Rows());
+    encoder.SetScroll(scroll);
+    encoder.Print(0, 0, "Remote round trip", 0x000, 0xFFF);
+    ReplyStream reply;
+    TinyTextRemote remote(&tft, &reply);
+
+    uint32_t random = 1;
+    uint32_t differ = 0;
+    uint32_t resyncs = 0;
+    uint32_t bytes = 0;
+    std::vector<uint8_t> out;
+    for (int n = 0; n < FRAMES; n++)
+    {
+        frame(encoder, n, random);
+        out.clear();
+        encoder.Encode(out);
+        for (size_t i = 0; i < out.size(); i++)
+        {
+            remote.Decode(out[i]);
+        }
+        if (!reply.written.empty())
+        {
+            // as a host would: the whole screen again
+            resyncs += (reply.written[0] == TINYTEXT_REMOTE_RESYNC);
+            reply.written.clear();
+            encoder.EncodeFull(out);
+            for (size_t i = 0; i < out.size(); i++)
+            {
+                remote.Decode(out[i]);
+            }
+        }
+        bytes += out.size();
+        differ += compare(encoder, rotation);
+    }
+    tft.DisableGrid(); // the driver has no destructor, it is usually a global
+
+    // the remote can only scroll from the grid or with the hardware scroll
+    bool canScroll = grid || ((rotation & 1) == 0);
+    bool ok = (differ == 0) && ((resyncs != 0) == (scroll && !canScroll)) && !MockInTransaction();
+    printf("rotation %u %-7s %-9s %7u bytes %3u resyncs %8u pixels differ  %s\n", rotation,
+           grid ? "grid" : "no grid", scroll ? "scroll" : "no scroll", (unsigned)bytes, (unsigned)resyncs,
+           (unsigned)differ, ok ? "" : "FAILED");
+    return ok;
+}
+
+int main()
+{
+    if (!panel.Begin() || !expected.Begin())
+    {
+        printf("can't allocate the canvases\n");
+        return 1;
+    }
+    uint8_t failures = 0;
+    for (uint8_t rotation = 0; rotation < 4; rotation++)
+    {
+        for (uint8_t grid = 0; grid < 2; grid++)
+        {
+            failures += !run(rotation, grid, true);
+            failures += !run(rotation, grid, false);
+        }
+    }
+    printf(failures ? "FAILED\n" : "passed\n");
+    return failures ? 1 : 0;
+}
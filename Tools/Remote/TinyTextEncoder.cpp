@@ -0,0 +1,349 @@
+#include <string.h>
+#include <map>
+#include "TinyTextEncoder.h"
+
+static uint8_t utf8Encode(uint16_t code, uint8_t* out)
+{
+    if (code < 0x80)
+    {
+        out[0] = code;
+        return 1;
+    }
+    if (code < 0x800)
+    {
+        out[0] = 0xC0 | (code >> 6);
+        out[1] = 0x80 | (code & 0x3F);
+        return 2;
+    }
+    out[0] = 0xE0 | (code >> 12);
+    out[1] = 0x80 | ((code >> 6) & 0x3F);
+    out[2] = 0x80 | (code & 0x3F);
+    return 3;
+}
+
+static uint16_t utf8Decode(const char*& str)
+{
+    // the code point at str, moving str past it. Malformed sequences and code
+    // points beyond U+FFFF come back as U+FFFD, as TinyTextTFT reads them
+    uint8_t lead = *str++;
+    if (lead < 0x80)
+    {
+        return lead;
+    }
+    uint8_t len = (lead < 0xC0) ? 1 : ((lead < 0xE0) ? 2 : ((lead < 0xF0) ? 3 : ((lead < 0xF8) ? 4 : 1)));
+    if (len == 1)
+    {
+        return 0xFFFD;
+    }
+    uint32_t code = lead & (0x7F >> len);
+    for (uint8_t i = 1; i < len; i++)
+    {
+        uint8_t next = *str;
+        if ((next & 0xC0) != 0x80)
+        {
+            return 0xFFFD;
+        }
+        code = (code << 6) | (next & 0x3F);
+        str++;
+    }
+    return (code > 0xFFFF) ? 0xFFFD : code;
+}
+
+TinyTextEncoder::TinyTextEncoder(uint8_t columns, uint8_t rows)
+{
+    _columns = columns;
+    _rows = rows;
+    TinyTextEncoderCell blank = { ' ', 0x000, 0x000 };
+    _screen.assign((size_t)columns * rows, blank);
+    _remote = _screen;
+    _remoteKnown = false;
+    _scroll = true;
+    _col = 0;
+    _row = 0xFF;
+    _foreColor = 0;
+    _backColor = 0;
+    _colorsKnown = false;
+    _out = NULL;
+    _textCells = 0;
+}
+
+bool TinyTextEncoder::sameCell(const TinyTextEncoderCell& a, const TinyTextEncoderCell& b)
+{
+    return (a.code == b.code) && (a.foreColor == b.foreColor) && (a.backColor == b.backColor);
+}
+
+void TinyTextEncoder::Put(uint8_t col, uint8_t row, uint16_t code, uint16_t foreColor, uint16_t backColor)
+{
+    if ((col >= _columns) || (row >= _rows))
+    {
+        return; // clipping
+    }
+    TinyTextEncoderCell& c = cell(_screen, col, row);
+    c.code = code;
+    c.foreColor = (code == ' ') ? backColor : foreColor; // fore colour of a blank cell doesn't matter
+    c.backColor = backColor;
+}
+
+void TinyTextEncoder::Print(uint8_t col, uint8_t row, const char* str, uint16_t foreColor, uint16_t backColor)
+{
+    while ((*str != 0) && (col < _columns))
+    {
+        Put(col++, row, utf8Decode(str), foreColor, backColor);
+    }
+}
+
+void TinyTextEncoder::Fill(uint8_t col, uint8_t row, uint8_t w, uint8_t h, uint16_t backColor)
+{
+    for (uint8_t y = row; (y < row + h) && (y < _rows); y++)
+    {
+        for (uint8_t x = col; (x < col + w) && (x < _columns); x++)
+        {
+            Put(x, y, ' ', backColor, backColor);
+        }
+    }
+}
+
+uint32_t TinyTextEncoder::changedCells(uint8_t scroll, uint16_t backColor)
+{
+    // cells to send if the remote first scrolled up by scroll rows, the new rows blank in backColor
+    TinyTextEncoderCell blank = { ' ', backColor, backColor };
+    uint32_t changed = 0;
+    for (uint8_t row = 0; row < _rows; row++)
+    {
+        for (uint8_t col = 0; col < _columns; col++)
+        {
+            const TinyTextEncoderCell& was = (row + scroll < _rows) ? cell(_remote, col, row + scroll) : blank;
+            if (!sameCell(cell(_screen, col, row), was))
+            {
+                changed++;
+            }
+        }
+    }
+    return changed;
+}
+
+void TinyTextEncoder::encodeScroll()
+{
+    // the remote clears the rows it scrolls in with the back colour, the bottom
+    // left cell's is as good a guess as any
+    uint16_t backColor = cell(_screen, 0, _rows - 1).backColor;
+    uint8_t best = 0;
+    uint32_t bestCost = changedCells(0, backColor);
+    for (uint8_t scroll = 1; (scroll < _rows) && (bestCost != 0); scroll++)
+    {
+        uint32_t cost = changedCells(scroll, backColor) + 6; // COLORS and SCROLL
+        if (cost < bestCost)
+        {
+            best = scroll;
+            bestCost = cost;
+        }
+    }
+    if (best == 0)
+    {
+        return;
+    }
+
+    if (!_colorsKnown || (_backColor != backColor))
+    {
+        TinyTextEncoderCell blank = { ' ', backColor, backColor };
+        setColors(blank);
+    }
+    sendByte(TINYTEXT_REMOTE_SCROLL);
+    sendByte(best);
+
+    TinyTextEncoderCell blank = { ' ', backColor, backColor };
+    _remote.erase(_remote.begin(), _remote.begin() + (size_t)best * _columns);
+    _remote.insert(_remote.end(), (size_t)best * _columns, blank);
+}
+
+void TinyTextEncoder::moveTo(uint8_t col, uint8_t row)
+{
+    if ((row == _row) && (col >= _col) && (col - _col <= 2 * TINYTEXT_REMOTE_MAX_TEXT))
+    {
+        // one or two SKIPs
+        while (col != _col)
+        {
+            uint8_t skip = ((col - _col) < TINYTEXT_REMOTE_MAX_TEXT) ? (col - _col) : TINYTEXT_REMOTE_MAX_TEXT;
+            sendByte(TINYTEXT_REMOTE_SKIP | (skip - 1));
+            _col += skip;
+        }
+        return;
+    }
+    sendByte(TINYTEXT_REMOTE_CURSOR);
+    sendByte(col);
+    sendByte(row);
+    _col = col;
+    _row = row;
+}
+
+void TinyTextEncoder::setColors(const TinyTextEncoderCell& c)
+{
+    bool blank = (c.code == ' ');
+    if (_colorsKnown && (c.backColor == _backColor) && (blank || (c.foreColor == _foreColor)))
+    {
+        return;
+    }
+    sendText();
+    uint16_t foreColor = (blank && _colorsKnown) ? _foreColor : c.foreColor;
+    sendByte(TINYTEXT_REMOTE_COLORS);
+    sendByte(foreColor >> 4);
+    sendByte(((foreColor & 0x0F) << 4) | (c.backColor >> 8));
+    sendByte(c.backColor & 0xFF);
+    _foreColor = foreColor;
+    _backColor = c.backColor;
+    _colorsKnown = true;
+}
+
+void TinyTextEncoder::sendText()
+{
+    if (_text.empty())
+    {
+        return;
+    }
+    sendByte(TINYTEXT_REMOTE_TEXT | (_text.size() - 1));
+    _out->insert(_out->end(), _text.begin(), _text.end());
+    _col += _textCells;
+    _text.clear();
+    _textCells = 0;
+}
+
+void TinyTextEncoder::encodeRow(uint8_t row)
+{
+    uint8_t col = 0;
+    while (col < _columns)
+    {
+        if (sameCell(cell(_screen, col, row), cell(_remote, col, row)))
+        {
+            col++;
+            continue;
+        }
+
+        // a run of changed cells, taking in single unchanged cells (in the same
+        // colours) as resending one costs less than a SKIP and a new TEXT
+        uint8_t end = col + 1;
+        for (;;)
+        {
+            while ((end < _columns) && !sameCell(cell(_screen, end, row), cell(_remote, end, row)))
+            {
+                end++;
+            }
+            if ((end + 1 < _columns) && !sameCell(cell(_screen, end + 1, row), cell(_remote, end + 1, row)) &&
+                (cell(_screen, end, row).foreColor == cell(_screen, end - 1, row).foreColor) &&
+                (cell(_screen, end, row).backColor == cell(_screen, end - 1, row).backColor))
+            {
+                end += 2;
+                continue;
+            }
+            break;
+        }
+
+        moveTo(col, row);
+        uint8_t x = col;
+        while (x < end)
+        {
+            const TinyTextEncoderCell& c = cell(_screen, x, row);
+            uint8_t repeat = 1;
+            while ((x + repeat < end) && sameCell(cell(_screen, x + repeat, row), c))
+            {
+                repeat++;
+            }
+            uint8_t utf8[3];
+            uint8_t size = utf8Encode(c.code, utf8);
+            setColors(c);
+            if (repeat * size >= 6)
+            {
+                // REPEAT is 4 bytes
+                sendText();
+                sendByte(TINYTEXT_REMOTE_REPEAT);
+                sendByte(repeat);
+                sendByte(c.code >> 8);
+                sendByte(c.code & 0xFF);
+                _col += repeat;
+                x += repeat;
+                continue;
+            }
+            if (_text.size() + size > TINYTEXT_REMOTE_MAX_TEXT)
+            {
+                sendText();
+            }
+            _text.insert(_text.end(), utf8, utf8 + size);
+            _textCells++;
+            x++;
+        }
+        sendText();
+
+        for (x = col; x < end; x++)
+        {
+            cell(_remote, x, row) = cell(_screen, x, row);
+        }
+        col = end;
+    }
+}
+
+size_t TinyTextEncoder::Encode(std::vector<uint8_t>& out)
+{
+    if (!_remoteKnown)
+    {
+        return EncodeFull(out);
+    }
+    if (changedCells(0, 0) == 0)
+    {
+        return 0; // nothing to send
+    }
+    size_t start = out.size();
+    _out = &out;
+    if (_scroll)
+    {
+        encodeScroll();
+    }
+    for (uint8_t row = 0; row < _rows; row++)
+    {
+        encodeRow(row);
+    }
+    sendByte(TINYTEXT_REMOTE_FLUSH);
+    _out = NULL;
+    return out.size() - start;
+}
+
+size_t TinyTextEncoder::EncodeFull(std::vector<uint8_t>& out)
+{
+    size_t start = out.size();
+    _out = &out;
+    for (uint8_t i = 0; i < TINYTEXT_REMOTE_SYNC; i++)
+    {
+        sendByte(TINYTEXT_REMOTE_NOP);
+    }
+    _row = 0xFF; // the remote cursor and colours are anyone's guess
+    _colorsKnown = false;
+
+    // clear to the most common background, then send what isn't blank
+    std::map<uint16_t, uint32_t> backColors;
+    uint16_t backColor = 0;
+    uint32_t most = 0;
+    for (size_t i = 0; i < _screen.size(); i++)
+    {
+        uint32_t count = ++backColors[_screen[i].backColor];
+        if (count > most)
+        {
+            most = count;
+            backColor = _screen[i].backColor;
+        }
+    }
+    TinyTextEncoderCell blank = { ' ', backColor, backColor };
+    setColors(blank);
+    sendByte(TINYTEXT_REMOTE_FILL);
+    sendByte(0);
+    sendByte(0);
+    sendByte(_columns);
+    sendByte(_rows);
+    _remote.assign(_screen.size(), blank);
+
+    for (uint8_t row = 0; row < _rows; row++)
+    {
+        encodeRow(row);
+    }
+    sendByte(TINYTEXT_REMOTE_FLUSH);
+    _out = NULL;
+    _remoteKnown = true;
+    return out.size() - start;
+}
@@ -0,0 +1,87 @@
+#ifndef TinyTextEncoder_h
+#define TinyTextEncoder_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "../../Library/TinyTextProtocol.h"
+
+/*
+  Host side (Linux, or anything with a C++11 compiler) of TinyTextRemote.
+
+  Draw the screen you want with Put, Print and Fill, then Encode: it compares the
+  screen with the one it last encoded and appends the commands that bring the
+  remote up to date, ending with a FLUSH. Unchanged cells cost nothing; changed
+  cells go out as runs of UTF-8 text, repeats and skips, colours are only sent
+  when they change, and when the screen has moved up a few rows (a log) the
+  remote is told to scroll instead of being sent every row again.
+
+  The first Encode (and EncodeFull, e.g. after the remote was reset or when it
+  sends back TINYTEXT_REMOTE_RESYNC) sends the whole screen: a fill of the most
+  common background and the non-blank cells.
+*/
+
+struct TinyTextEncoderCell
+{
+    uint16_t code;      // code point, ' ' for a blank cell
+    uint16_t foreColor; // RGB444, the same as backColor for a blank cell
+    uint16_t backColor;
+};
+
+class TinyTextEncoder
+{
+private:
+    uint8_t _columns;
+    uint8_t _rows;
+    std::vector<TinyTextEncoderCell> _screen; // wanted
+    std::vector<TinyTextEncoderCell> _remote; // what the remote shows
+    bool     _remoteKnown;
+    bool     _scroll;
+
+    // remote state, as the commands sent so far left it
+    uint8_t  _col;
+    uint8_t  _row;
+    uint16_t _foreColor;
+    uint16_t _backColor;
+    bool     _colorsKnown;
+
+    std::vector<uint8_t>* _out;
+    std::vector<uint8_t>  _text; // TEXT bytes not sent yet
+    uint8_t  _textCells;
+
+    TinyTextEncoderCell& cell(std::vector<TinyTextEncoderCell>& screen, uint8_t col, uint8_t row)
+    {
+        return screen[(size_t)row * _columns + col];
+    }
+    static bool sameCell(const TinyTextEncoderCell& a, const TinyTextEncoderCell& b);
+
+    uint32_t changedCells(uint8_t scroll, uint16_t backColor);
+    void encodeScroll();
+    void encodeRow(uint8_t row);
+    void moveTo(uint8_t col, uint8_t row);
+    void setColors(const TinyTextEncoderCell& cell);
+    void sendText();
+    void sendByte(uint8_t b) { _out->push_back(b); }
+
+public:
+    TinyTextEncoder(uint8_t columns = 64, uint8_t rows = 24);
+
+    uint8_t Columns() { return _columns; }
+    uint8_t Rows()    { return _rows; }
+
+    // false: never send SCROLL, rows that moved are sent again. For a remote that
+    // can only scroll from the shadow grid and doesn't have it enabled (in rotation
+    // 1 or 3, see TinyTextRemote), which would otherwise ask for a resync.
+    void SetScroll(bool scroll) { _scroll = scroll; }
+
+    void Put(uint8_t col, uint8_t row, uint16_t code, uint16_t foreColor, uint16_t backColor);
+    void Print(uint8_t col, uint8_t row, const char* str, uint16_t foreColor, uint16_t backColor); // UTF-8
+    void Fill(uint8_t col, uint8_t row, uint8_t w, uint8_t h, uint16_t backColor);
+    const TinyTextEncoderCell& Cell(uint8_t col, uint8_t row) { return cell(_screen, col, row); }
+
+    // Append the update to out, returns the number of bytes appended.
+    size_t Encode(std::vector<uint8_t>& out);
+    size_t EncodeFull(std::vector<uint8_t>& out);
+};
+
+#endif
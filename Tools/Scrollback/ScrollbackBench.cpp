@@ -0,0 +1,165 @@
+/*
+  Cost of TinyTextScrollback on a PC: bytes a row, rows kept in a budget, time
+  to append a row and to read back a page, and what paging through it with a
+  TinyTextWindow sends, measured on the mock SPI bus of Tools/Bench: every
+  PageUp from the live rows back to the oldest and every PageDown to the live
+  rows again, against drawing one page a cell at a time.
+
+    g++ -std=c++11 -O2 -I../Bench -I../../Library ScrollbackBench.cpp ../Bench/ArduinoMock.cpp \
+        ../../Library/TinyTextTFT.cpp ../../Library/TinyTextBus.cpp ../../Library/TinyTextBlend.cpp \
+        ../../Library/TinyTextCanvas.cpp ../../Library/TinyTextClock.cpp ../../Library/TinyTextPipeline.cpp \
+        ../../Library/TinyTextScrollback.cpp ../../Library/TinyTextWindow.cpp -o ScrollbackBench
+    ./ScrollbackBench [budget bytes] [columns] [rows]
+
+  The window is at the top left of the screen in rotation 1, so up to 64 x 24.
+  The rows are made up log lines: a timestamp, a level in its own colour and a
+  message of random length, trailing blanks out to the width of the window.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "ArduinoMock.h"
+#include "TinyTextTFT.h"
+#include "TinyTextScrollback.h"
+#include "TinyTextWindow.h"
+
+#define PIN_CS 10
+#define PIN_DC 9
+
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void logRow(uint32_t n, uint8_t columns, uint8_t* glyphs, uint16_t* fore, uint16_t* back)
+{
+    // "12345 W message..." as glyph indexes
+    static const uint16_t levels[3] = { 0xFFF, 0xFF0, 0xF00 };
+    char text[80];
+    int len = snprintf(text, sizeof(text), "%05u %c ", (unsigned)n, "IWE"[n % 3]);
+    int message = 8 + rand() % (columns - 8 - len + 1);
+    for (int i = 0; i < message; i++)
+    {
+        text[len++] = (rand() % 6 == 0) ? ' ' : 'a' + rand() % 26;
+    }
+    for (uint8_t i = 0; i < columns; i++)
+    {
+        glyphs[i] = (i < len) ? TinyTextTFT::GlyphIndex(text[i]) : 0;
+        fore[i] = (i == 6) ? levels[n % 3] : 0xCCC;
+        back[i] = 0x000;
+        if (glyphs[i] == 0)
+        {
+            fore[i] = back[i];
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t budget = (argc > 1) ? atoi(argv[1]) : 16384;
+    uint8_t columns = (argc > 2) ? atoi(argv[2]) : 64;
+    uint8_t rows = (argc > 3) ? atoi(argv[3]) : 20;
+    columns = (columns < 24) ? 24 : ((columns > 64) ? 64 : columns);
+    rows = (rows < 1) ? 1 : ((rows > 24) ? 24 : rows);
+
+    TinyTextScrollback scrollback;
+    if (!scrollback.Begin(budget))
+    {
+        printf("can't allocate %u bytes\n", (unsigned)budget);
+        return 1;
+    }
+    uint8_t glyphs[64];
+    uint16_t fore[64];
+    uint16_t back[64];
+
+    // append: well past the budget so the ring is evicting
+    srand(1);
+    const uint32_t appends = 200000;
+    double start = now();
+    for (uint32_t n = 0; n < appends; n++)
+    {
+        logRow(n, columns, glyphs, fore, back);
+        scrollback.Append(glyphs, fore, back, columns);
+    }
+    double appendSeconds = now() - start;
+    printf("%u byte budget, %u x %u window: %u rows kept, %u bytes used, %.1f bytes a row (%u raw)\n",
+           (unsigned)budget, columns, rows, scrollback.Lines(), (unsigned)scrollback.Used(),
+           (double)scrollback.Used() / scrollback.Lines(), columns * 5);
+    printf("append      %8.3f us a row\n", appendSeconds * 1e6 / appends);
+
+    // page up through everything, a page at a time, as TinyTextWindow::drawRegion reads it
+    uint32_t pages = 0;
+    start = now();
+    for (uint32_t pass = 0; pass < 100; pass++)
+    {
+        for (uint16_t view = rows; view <= scrollback.Lines(); view += rows)
+        {
+            for (uint8_t line = 0; line < rows; line++)
+            {
+                scrollback.Get(view - line - 1, glyphs, fore, back, columns);
+            }
+            pages += (pass == 0);
+        }
+    }
+    double pageSeconds = (now() - start) / 100;
+    printf("page read   %8.3f us a page of %u rows\n", pageSeconds * 1e6 / pages, rows);
+
+    // the same pages through a window on the bus
+    MockReset(PIN_CS, PIN_DC);
+    TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+    tft.Begin();
+    tft.SetRotation(1);
+    TinyTextWindow window;
+    if (!window.Attach(&tft, 0, 0, columns, rows))
+    {
+        printf("can't attach a %u x %u window\n", columns, rows);
+        return 1;
+    }
+    window.SetScrollback(&scrollback);
+    MockBusCounts up = { };
+    MockBusCounts down = { };
+    uint32_t upPages = 0;
+    uint32_t downPages = 0;
+    for (uint16_t view = 0; ; upPages++)
+    {
+        MockResetCounts();
+        window.PageUp();
+        if (window.ScrolledBack() == view)
+        {
+            break;
+        }
+        view = window.ScrolledBack();
+        up.bytes += MockCounts().bytes;
+        up.transactions += MockCounts().transactions;
+        up.busNanos += MockCounts().busNanos;
+    }
+    for (; window.ScrolledBack() != 0; downPages++)
+    {
+        MockResetCounts();
+        window.PageDown();
+        down.bytes += MockCounts().bytes;
+        down.transactions += MockCounts().transactions;
+        down.busNanos += MockCounts().busNanos;
+    }
+
+    // the oldest page again, a cell at a time as DrawChar would send it
+    MockResetCounts();
+    for (uint8_t line = 0; line < rows; line++)
+    {
+        scrollback.Get(scrollback.Lines() - line - 1, glyphs, fore, back, columns);
+        for (uint8_t col = 0; col < columns; col++)
+        {
+            tft.DrawGlyphs(col, rows - 1 - line, &glyphs[col], &fore[col], &back[col], 1);
+        }
+    }
+    MockBusCounts cells = MockCounts();
+
+    printf("PageUp      %8u bus bytes, %4u transactions, %8.1f us at the bus clock a page (%u pages)\n",
+           (unsigned)(up.bytes / upPages), (unsigned)(up.transactions / upPages), up.busNanos / 1000.0 / upPages, (unsigned)upPages);
+    printf("PageDown    %8u bus bytes, %4u transactions, %8.1f us at the bus clock a page (%u pages)\n",
+           (unsigned)(down.bytes / downPages), (unsigned)(down.transactions / downPages), down.busNanos / 1000.0 / downPages, (unsigned)downPages);
+    printf("cell by cell%8u bus bytes, %4u transactions, %8.1f us at the bus clock a page\n",
+           (unsigned)cells.bytes, (unsigned)cells.transactions, cells.busNanos / 1000.0);
+    return 0;
+}
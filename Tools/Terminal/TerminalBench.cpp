@@ -0,0 +1,346 @@
+/*
+  Throughput of the TinyTextAnsi terminal on a PC: replays sessions through the
+  parser into a model of a 48 x 32 screen (rotation 0) that counts what the
+  window would send, and reports the bytes a second the parser sustains and the
+  bytes a second of terminal output the SPI bus sustains at the given clock,
+  against drawing (and erasing) every cell on its own.
+
+    g++ -std=c++11 -O2 -I../../Library TerminalBench.cpp ../../Library/TinyTextAnsi.cpp -o TerminalBench
+    ./TerminalBench [SPI MHz] [captured sessions...]
+
+  A session can be captured with e.g. "script -q -c 'ls --color=always -l /usr/bin' ls.txt"
+  (strip the header line script adds). Without any, four made up sessions are
+  replayed: coloured ls output, a top-like screen redrawn in place, a scrolling
+  log and an editor scrolling a region above a status line.
+
+  The bus figures are an upper bound: the window only sends the cells that
+  changed, the model sends every cell written.
+*/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include "TinyTextAnsi.h"
+
+#define COLUMNS      48
+#define ROWS         32
+#define CELL_BYTES   100 // 5x10 pixels of RGB565
+#define WINDOW_BYTES 11  // CASET and PASET with 4 bytes each, RAMWR
+#define SCROLL_BYTES 3   // VSCRSADD
+#define REPLAYS      20
+
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class ModelScreen : public TinyTextAnsiScreen
+{
+private:
+    char     _cells[ROWS][COLUMNS];
+    uint8_t  _col;
+    uint8_t  _row;
+    uint8_t  _top;
+    uint8_t  _bottom;
+    bool     _wrap;
+
+    void send(uint32_t cells)
+    {
+        windows++;
+        busBytes += WINDOW_BYTES + cells * CELL_BYTES;
+    }
+
+    void newLine()
+    {
+        _col = 0;
+        if (_row == _bottom)
+        {
+            ScrollUp(true);
+        }
+        else if (_row + 1 < ROWS)
+        {
+            _row++;
+        }
+    }
+
+public:
+    uint32_t texts;     // calls
+    uint32_t windows;   // address windows sent
+    uint32_t cells;     // cells drawn
+    uint32_t erases;
+    uint32_t erased;    // cells filled
+    uint32_t scrolls;
+    uint64_t busBytes;
+    uint64_t cellBytes; // every cell drawn or erased with its own address window, scrolls the same
+
+    ModelScreen()
+    {
+        memset(_cells, ' ', sizeof(_cells));
+        _col = 0;
+        _row = 0;
+        _top = 0;
+        _bottom = ROWS - 1;
+        _wrap = true;
+        texts = windows = cells = erases = erased = scrolls = 0;
+        busBytes = cellBytes = 0;
+    }
+
+    virtual uint8_t Columns()      { return COLUMNS; }
+    virtual uint8_t Rows()         { return ROWS; }
+    virtual uint8_t CursorColumn() { return _col; }
+    virtual uint8_t CursorRow()    { return _row; }
+    virtual void SetCursor(uint8_t col, uint8_t row) { _col = col; _row = row; }
+    virtual void SetColors(uint16_t, uint16_t) {}
+    virtual void SetWrap(bool wrap) { _wrap = wrap; }
+    virtual void SetScrollRegion(uint8_t top, uint8_t bottom) { _top = top; _bottom = bottom; }
+
+    virtual void Text(const char* str, size_t len)
+    {
+        // as TinyTextWindow::Write: a window for each row the text is on
+        texts++;
+        uint32_t run = 0;
+        for (size_t i = 0; i < len; i++)
+        {
+            if (((uint8_t)str[i] & 0xC0) == 0x80)
+            {
+                continue; // one cell a character
+            }
+            if (_col >= COLUMNS)
+            {
+                if (!_wrap)
+                {
+                    continue;
+                }
+                if (run != 0)
+                {
+                    send(run);
+                }
+                run = 0;
+                newLine();
+            }
+            _cells[_row][_col++] = str[i];
+            run++;
+            cells++;
+            cellBytes += WINDOW_BYTES + CELL_BYTES;
+        }
+        if (run != 0)
+        {
+            send(run);
+        }
+    }
+
+    virtual void Erase(uint8_t col, uint8_t row, uint8_t w, uint8_t h)
+    {
+        erases++;
+        erased += w * h;
+        busBytes += WINDOW_BYTES + (uint32_t)w * h * CELL_BYTES;
+        cellBytes += (uint64_t)w * h * (WINDOW_BYTES + CELL_BYTES);
+        for (uint8_t r = row; r < row + h; r++)
+        {
+            memset(&_cells[r][col], ' ', w);
+        }
+    }
+
+    virtual void ScrollUp(bool history)
+    {
+        (void)history; // no scrollback
+        scrolls++;
+        memmove(_cells[_top], _cells[_top + 1], (_bottom - _top) * COLUMNS);
+        memset(_cells[_bottom], ' ', COLUMNS);
+        uint32_t rows = _bottom - _top + 1;
+        uint32_t bytes = rows * (WINDOW_BYTES + COLUMNS * CELL_BYTES); // every row of the region again
+        if (rows == ROWS)
+        {
+            bytes = SCROLL_BYTES + WINDOW_BYTES + COLUMNS * CELL_BYTES; // hardware scroll, a row cleared
+        }
+        busBytes += bytes;
+        cellBytes += bytes;
+    }
+
+    virtual void ScrollDown()
+    {
+        scrolls++;
+        memmove(_cells[_top + 1], _cells[_top], (_bottom - _top) * COLUMNS);
+        memset(_cells[_top], ' ', COLUMNS);
+        uint32_t bytes = (_bottom - _top + 1) * (WINDOW_BYTES + COLUMNS * CELL_BYTES);
+        busBytes += bytes;
+        cellBytes += bytes;
+    }
+};
+
+static void append(std::string& s, const char* format, ...) __attribute__((format(printf, 2, 3)));
+static void append(std::string& s, const char* format, ...)
+{
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    s += buffer;
+}
+
+static std::string word(int min, int max)
+{
+    std::string w;
+    for (int len = min + rand() % (max - min + 1); len > 0; len--)
+    {
+        w += (char)('a' + rand() % 26);
+    }
+    return w;
+}
+
+static std::string lsSession()
+{
+    // ls --color: names in 2 or 3 columns, directories bold blue, executables bold green
+    std::string s;
+    for (int line = 0; line < 4000; line++)
+    {
+        for (int col = 0; col < 3; col++)
+        {
+            std::string name = word(3, 10);
+            switch (rand() % 4)
+            {
+                case 0:  append(s, "\x1b[01;34m%s\x1b[0m", name.c_str()); break;
+                case 1:  append(s, "\x1b[01;32m%s\x1b[0m", name.c_str()); break;
+                default: append(s, "%s.%s", name.c_str(), word(1, 3).c_str()); break;
+            }
+            s += "   ";
+        }
+        s += "\r\n";
+    }
+    return s;
+}
+
+static std::string topSession()
+{
+    // a header in reverse video, then the same rows rewritten in place with
+    // new numbers, each row ending in an erase
+    std::string s = "\x1b[H\x1b[2J";
+    for (int frame = 0; frame < 300; frame++)
+    {
+        append(s, "\x1b[H\x1b[1mtop - up %d min, load %d.%02d\x1b[0m\x1b[K\r\n", frame, rand() % 4, rand() % 100);
+        append(s, "\x1b[7m  PID USER     %%CPU %%MEM COMMAND            \x1b[0m\x1b[K\r\n");
+        for (int row = 2; row < ROWS - 1; row++)
+        {
+            int cpu = rand() % 100;
+            append(s, "%5d %-8s %s%2d.%d\x1b[39m %2d.%d %s\x1b[K\r\n", 100 + row * 37, (row & 1) ? "root" : "pi",
+                   (cpu > 80) ? "\x1b[31m" : "", cpu, rand() % 10, rand() % 30, rand() % 10, word(4, 14).c_str());
+        }
+        s += "\x1b[J";
+    }
+    return s;
+}
+
+static std::string logSession()
+{
+    // plain lines scrolling the whole screen, errors in red
+    std::string s;
+    for (int line = 0; line < 6000; line++)
+    {
+        bool error = (rand() % 20 == 0);
+        append(s, "[%6d.%06d] %s%s: %s %s %s\x1b[0m\r\n", line / 10, rand() % 1000000, error ? "\x1b[31m" : "",
+               word(4, 8).c_str(), word(2, 9).c_str(), word(2, 9).c_str(), word(3, 12).c_str());
+    }
+    return s;
+}
+
+static std::string editorSession()
+{
+    // a scroll region above a status line, scrolled with LF and RI and lines
+    // inserted and deleted, 256 colour syntax highlighting
+    std::string s;
+    append(s, "\x1b[H\x1b[2J\x1b[1;%dr", ROWS - 1);
+    for (int step = 0; step < 3000; step++)
+    {
+        switch (rand() % 4)
+        {
+            case 0:  append(s, "\x1b[%d;1H\n", ROWS - 1); break; // scroll down the file
+            case 1:  s += "\x1b[1;1H\x1bM";                   break; // and up
+            case 2:  append(s, "\x1b[%d;1H\x1b[L", 1 + rand() % (ROWS - 1)); break;
+            default: append(s, "\x1b[%d;1H\x1b[M", 1 + rand() % (ROWS - 1)); break;
+        }
+        append(s, "\x1b[38;5;%dm%s\x1b[38;5;%dm(%s, %s);\x1b[0m\x1b[K", 16 + rand() % 216, word(2, 8).c_str(),
+               232 + rand() % 24, word(1, 6).c_str(), word(1, 6).c_str());
+        append(s, "\x1b[%d;1H\x1b[7m%-20s %5d,%-3d\x1b[0m\x1b[K", ROWS, word(5, 12).c_str(), step, rand() % 80);
+    }
+    s += "\x1b[r";
+    return s;
+}
+
+static void replay(const char* name, const std::string& session, double spiMHz)
+{
+    // once to count, then timed
+    ModelScreen screen;
+    TinyTextAnsi ansi;
+    ansi.Begin(&screen, 0xFFF, 0x000);
+    ansi.Write((const uint8_t*)session.data(), session.size());
+
+    double start = now();
+    for (int i = 0; i < REPLAYS; i++)
+    {
+        ModelScreen timed;
+        TinyTextAnsi parser;
+        parser.Begin(&timed, 0xFFF, 0x000);
+        parser.Write((const uint8_t*)session.data(), session.size());
+    }
+    double seconds = (now() - start) / REPLAYS;
+
+    double busSeconds = screen.busBytes * 8 / (spiMHz * 1e6);
+    double cellSeconds = screen.cellBytes * 8 / (spiMHz * 1e6);
+    printf("%-10s %8u bytes: %6u runs (%.1f cells each) in %6u windows, %5u erases (%.1f cells each), %5u scrolls\n",
+           name, (unsigned)session.size(), screen.texts, (double)screen.cells / (screen.texts ? screen.texts : 1),
+           screen.windows, screen.erases, (double)screen.erased / (screen.erases ? screen.erases : 1), screen.scrolls);
+    printf("%-10s parser %8.2f MB/s, at %.0f MHz the bus takes %8.0f bytes/s (%6.0f a cell at a time)\n",
+           "", session.size() / seconds / 1e6, spiMHz, session.size() / busSeconds, session.size() / cellSeconds);
+}
+
+static bool readFile(const char* path, std::string& s)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+    char buffer[4096];
+    size_t len;
+    while ((len = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        s.append(buffer, len);
+    }
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    double spiMHz = (argc > 1) ? atof(argv[1]) : 40;
+    if (spiMHz <= 0)
+    {
+        printf("usage: TerminalBench [SPI MHz] [captured sessions...]\n");
+        return 1;
+    }
+    if (argc > 2)
+    {
+        for (int i = 2; i < argc; i++)
+        {
+            std::string session;
+            if (!readFile(argv[i], session))
+            {
+                printf("can't read %s\n", argv[i]);
+                return 1;
+            }
+            const char* name = strrchr(argv[i], '/');
+            replay((name != NULL) ? name + 1 : argv[i], session, spiMHz);
+        }
+        return 0;
+    }
+    srand(1);
+    replay("ls", lsSession(), spiMHz);
+    replay("top", topSession(), spiMHz);
+    replay("log", logSession(), spiMHz);
+    replay("editor", editorSession(), spiMHz);
+    return 0;
+}
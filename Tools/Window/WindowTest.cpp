@@ -0,0 +1,241 @@
+/*
+  TinyTextWindow on a PC, against the mock SPI bus of Tools/Bench: each case
+  draws through a window onto a canvas attached to the bus, then draws the rows
+  the window should show with DrawString onto a second canvas, and compares
+  the two pixel for pixel (the whole screen, so nothing may land outside the
+  window either). Built with AddressSanitizer, so it also checks that the
+  window stays inside its buffers.
+
+    g++ -std=c++11 -O1 -g -fsanitize=address -I../Bench -I../../Library WindowTest.cpp ../Bench/ArduinoMock.cpp \
+        ../../Library/TinyTextTFT.cpp ../../Library/TinyTextBus.cpp ../../Library/TinyTextBlend.cpp \
+        ../../Library/TinyTextCanvas.cpp ../../Library/TinyTextClock.cpp ../../Library/TinyTextPipeline.cpp \
+        ../../Library/TinyTextScrollback.cpp ../../Library/TinyTextWindow.cpp -o WindowTest
+    ./WindowTest
+
+  The cases: a window of an odd number of cells, wrapping and scrolling in
+  software, scrolling with the controller's hardware scroll, ClearRect, paging
+  through a scrollback while text is still being written, and the driver's own
+  console scrolling the whole screen in rotations 1 and 3 without EnableGrid.
+  Exits 1 if any fails.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "ArduinoMock.h"
+#include "TinyTextTFT.h"
+#include "TinyTextScrollback.h"
+#include "TinyTextWindow.h"
+
+#define PIN_CS 10
+#define PIN_DC 9
+
+#define BACKGROUND 0x07D
+#define FORE       0xFF0
+#define BACK       0x00F
+
+static TinyTextCanvas panel;    // drawn by the window, through the bus
+static TinyTextCanvas expected; // the rows it should show, drawn directly
+static uint32_t failures;
+
+struct Rect
+{
+    uint8_t col;
+    uint8_t row;
+    uint8_t width;
+    uint8_t height;
+};
+
+// The driver on the bus, with the panel canvas attached, blanked.
+static void start(TinyTextTFT& tft, uint8_t rotation)
+{
+    MockReset(PIN_CS, PIN_DC);
+    MockAttach(&panel);
+    tft.Begin();
+    tft.SetRotation(rotation);
+    tft.FillScreen(BACKGROUND);
+}
+
+// Draws rows (NULL ends them early) in the window's rectangle on the expected
+// canvas and compares it with the panel.
+static void check(const char* name, uint8_t rotation, const Rect& window, const char* const* rows)
+{
+    TinyTextTFT ref(PIN_CS, PIN_DC, -1);
+    ref.SetCanvas(&expected);
+    ref.Begin();
+    ref.SetRotation(rotation);
+    ref.FillScreen(BACKGROUND);
+    ref.FillCells(window.col, window.row, window.width, window.height, BACK);
+    for (uint8_t row = 0; (row < window.height) && (rows[row] != NULL); row++)
+    {
+        ref.DrawString(window.col, window.row + row, rows[row], strlen(rows[row]), FORE, BACK);
+    }
+    ref.SetCanvas(NULL);
+
+    uint32_t differ = 0;
+    for (uint16_t y = 0; y < panel.Height(); y++)
+    {
+        for (uint16_t x = 0; x < panel.Width(); x++)
+        {
+            differ += (panel.GetPixel(x, y) != expected.GetPixel(x, y));
+        }
+    }
+    bool clean = (MockCounts().strayBytes == 0) && !MockInTransaction();
+    printf("%-34s %6u pixels differ%s\n", name, differ, clean ? "" : ", BUS LEFT OPEN");
+    if ((differ != 0) || !clean)
+    {
+        failures++;
+    }
+}
+
+static void oddCells()
+{
+    // 3 cells: the colours come after the glyphs padded to an even length
+    TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+    start(tft, 0);
+    TinyTextWindow window;
+    Rect rect = { 0, 0, 3, 1 };
+    if (!window.Attach(&tft, rect.col, rect.row, rect.width, rect.height, FORE, BACK))
+    {
+        printf("can't attach a 3 x 1 window\n");
+        failures++;
+        return;
+    }
+    window.Write("abcd");
+    const char* rows[] = { "d" };
+    check("odd number of cells", 0, rect, rows);
+}
+
+static void wrapAndScroll()
+{
+    TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+    start(tft, 1);
+    TinyTextWindow window;
+    Rect rect = { 5, 2, 12, 4 };
+    window.Attach(&tft, rect.col, rect.row, rect.width, rect.height, FORE, BACK);
+    window.Write("one\ntwo\nthree\nfour\nfive and more text");
+    const char* rows[] = { "three", "four", "five and mor", "e text" };
+    check("wrap and software scroll", 1, rect, rows);
+}
+
+static void hardwareScroll()
+{
+    // as wide as the screen in rotation 0: the controller scrolls rows 3..8
+    TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+    start(tft, 0);
+    TinyTextWindow window;
+    Rect rect = { 0, 3, (uint8_t)tft.Columns(), 6 };
+    window.Attach(&tft, rect.col, rect.row, rect.width, rect.height, FORE, BACK);
+    char line[16];
+    for (uint8_t i = 1; i <= 10; i++)
+    {
+        snprintf(line, sizeof(line), (i == 1) ? "line %u" : "\nline %u", i);
+        window.Write(line);
+    }
+    const char* rows[] = { "line 5", "line 6", "line 7", "line 8", "line 9", "line 10" };
+    check("hardware scroll", 0, rect, rows);
+}
+
+static void clearRect()
+{
+    TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+    start(tft, 3);
+    TinyTextWindow window;
+    Rect rect = { 20, 10, 10, 3 };
+    window.Attach(&tft, rect.col, rect.row, rect.width, rect.height, FORE, BACK);
+    window.Write("abcdefghijabcdefghijabcdefghij");
+    window.ClearRect(2, 1, 5, 2);
+    window.ClearRect(8, 2, 5, 5); // clipped to the window
+    const char* rows[] = { "abcdefghij", "ab     hij", "ab     h" };
+    check("ClearRect", 3, rect, rows);
+}
+
+static void scrollback()
+{
+    TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+    start(tft, 2);
+    TinyTextScrollback history;
+    history.Begin(2000);
+    TinyTextWindow window;
+    Rect rect = { 2, 2, 16, 4 };
+    window.Attach(&tft, rect.col, rect.row, rect.width, rect.height, FORE, BACK);
+    window.SetScrollback(&history);
+    char line[16];
+    for (uint8_t i = 1; i <= 12; i++)
+    {
+        snprintf(line, sizeof(line), (i == 1) ? "line %u" : "\nline %u", i);
+        window.Write(line);
+    }
+    const char* live[] = { "line 9", "line 10", "line 11", "line 12" };
+    check("scrollback: live rows", 2, rect, live);
+
+    window.PageUp();
+    const char* page1[] = { "line 5", "line 6", "line 7", "line 8" };
+    check("scrollback: PageUp", 2, rect, page1);
+
+    window.PageUp();
+    window.PageUp(); // no further back than the oldest row
+    const char* page2[] = { "line 1", "line 2", "line 3", "line 4" };
+    check("scrollback: PageUp to the oldest", 2, rect, page2);
+
+    window.PageDown();
+    window.Write("\nline 13"); // scrolls the live rows, the view stays put
+    check("scrollback: writing while back", 2, rect, page1);
+
+    window.PageDown(); // one row back now
+    const char* back1[] = { "line 9", "line 10", "line 11", "line 12" };
+    check("scrollback: PageDown", 2, rect, back1);
+
+    window.ScrollBack(0);
+    const char* after[] = { "line 10", "line 11", "line 12", "line 13" };
+    check("scrollback: back to the live rows", 2, rect, after);
+}
+
+static void console(uint8_t rotation)
+{
+    // no grid enabled: the console scrolls with one of its own
+    TinyTextTFT tft(PIN_CS, PIN_DC, -1);
+    start(tft, rotation);
+    tft.SetConsoleColors(FORE, BACK);
+    tft.DrawString(0, 0, "drawn before the console", 24, BACK, FORE); // scrolled off
+    uint8_t rows = tft.Rows();
+    char line[16];
+    for (uint8_t i = 1; i <= rows + 3; i++)
+    {
+        snprintf(line, sizeof(line), "line %u\n", i);
+        tft.Write(line);
+    }
+    tft.Write("last");
+    const char* expect[32];
+    char text[32][16];
+    for (uint8_t row = 0; row < rows; row++)
+    {
+        // lines 5 .. rows + 3, then "last"
+        snprintf(text[row], sizeof(text[row]), (row == rows - 1) ? "last" : "line %u", row + 5);
+        expect[row] = text[row];
+    }
+    bool grid = tft.GridEnabled();
+    char name[40];
+    snprintf(name, sizeof(name), "console scroll, rotation %u%s", rotation, grid ? " GRID SHOWS" : "");
+    Rect rect = { 0, 0, (uint8_t)tft.Columns(), rows };
+    check(name, rotation, rect, expect);
+    failures += grid;
+    tft.DisableGrid(); // the driver has no destructor, it is usually a global
+}
+
+int main()
+{
+    if (!panel.Begin() || !expected.Begin())
+    {
+        printf("can't allocate the canvases\n");
+        return 1;
+    }
+    oddCells();
+    wrapAndScroll();
+    hardwareScroll();
+    clearRect();
+    scrollback();
+    console(1);
+    console(3);
+    printf(failures ? "FAILED\n" : "passed\n");
+    return failures ? 1 : 0;
+}